@@ -359,6 +359,7 @@ static int acquire_time_data(sd_bus *bus, UnitTimes **out) {
                 return bus_log_parse_error(r);
 
         while ((r = bus_parse_unit_info(reply, &u)) > 0) {
+                _cleanup_(sd_bus_message_unrefp) sd_bus_message *m = NULL;
                 UnitTimes *t;
 
                 if (!GREEDY_REALLOC(unit_times, allocated, c + 2))
@@ -370,15 +371,20 @@ static int acquire_time_data(sd_bus *bus, UnitTimes **out) {
 
                 assert_cc(sizeof(usec_t) == sizeof(uint64_t));
 
-                r = bus_map_all_properties(
+                /* Only ask for the properties of the generic unit interface here, instead of those of all
+                 * interfaces as bus_map_all_properties() would do: this is called for every single unit,
+                 * and the type-specific interfaces are by far the larger part of the reply. */
+                r = sd_bus_call_method(
                                 bus,
                                 "org.freedesktop.systemd1",
                                 u.unit_path,
-                                property_map,
-                                BUS_MAP_STRDUP,
+                                "org.freedesktop.DBus.Properties",
+                                "GetAll",
                                 &error,
-                                NULL,
-                                t);
+                                &m,
+                                "s", "org.freedesktop.systemd1.Unit");
+                if (r >= 0)
+                        r = bus_message_map_all_properties(m, property_map, BUS_MAP_STRDUP, &error, t);
                 if (r < 0)
                         return log_error_errno(r, "Failed to get timestamp properties of unit %s: %s",
                                                u.id, bus_error_message(&error, r));
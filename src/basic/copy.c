@@ -36,11 +36,33 @@
 
 #define COPY_BUFFER_SIZE (16U*1024U)
 
+/* The granularity in which we look for runs of NUL bytes to turn into holes with COPY_HOLES */
+#define COPY_HOLE_BLOCK_SIZE (4U*1024U)
+
 /* A safety net for descending recursively into file system trees to copy. On Linux PATH_MAX is 4096, which means the
  * deepest valid path one can build is around 2048, which we hence use as a safety net here, to not spin endlessly in
  * case of bind mount cycles and suchlike. */
 #define COPY_DEPTH_MAX 2048U
 
+static int finish_holes(int fd) {
+        struct stat st;
+        off_t c;
+
+        /* If the data ended in a hole we only seeked past it so far, hence extend the file to cover it */
+
+        c = lseek(fd, 0, SEEK_CUR);
+        if (c == (off_t) -1)
+                return -errno;
+
+        if (fstat(fd, &st) < 0)
+                return -errno;
+
+        if (st.st_size < c && ftruncate(fd, c) < 0)
+                return -errno;
+
+        return 0;
+}
+
 static ssize_t try_copy_file_range(
                 int fd_in, loff_t *off_in,
                 int fd_out, loff_t *off_out,
@@ -113,8 +135,10 @@ int copy_bytes_full(
                 void *userdata) {
 
         bool try_cfr = true, try_sendfile = true, try_splice = true, copied_something = false;
+        bool hit_limit = false, seek_holes = false, nul_holes = false;
         int r, nonblock_pipe = -1;
         size_t m = SSIZE_MAX; /* that is the maximum that sendfile and c_f_r accept */
+        size_t m_saved = 0;
 
         assert(fdf >= 0);
         assert(fdt >= 0);
@@ -185,11 +209,86 @@ int copy_bytes_full(
                 }
         }
 
+        if (FLAGS_SET(copy_flags, COPY_HOLES)) {
+                struct stat st;
+
+                if (fstat(fdf, &st) < 0)
+                        return -errno;
+
+                /* If the source is a regular file it knows where its holes are, hence skip over them with
+                 * SEEK_DATA/SEEK_HOLE and copy just the data segments in between. Otherwise look for
+                 * blocks of NUL bytes by hand, which none of the kernel-side copy calls know how to do. */
+                if (S_ISREG(st.st_mode))
+                        seek_holes = true;
+                else {
+                        assert(!ret_remains);
+                        nul_holes = true;
+                        try_cfr = try_sendfile = try_splice = false;
+                }
+        }
+
         for (;;) {
                 ssize_t n;
 
-                if (max_bytes <= 0)
-                        return 1; /* return > 0 if we hit the max_bytes limit */
+                if (max_bytes <= 0) {
+                        hit_limit = true;
+                        break;
+                }
+
+                if (seek_holes) {
+                        off_t c, e;
+
+                        c = lseek(fdf, 0, SEEK_CUR);
+                        if (c < 0)
+                                return -errno;
+
+                        /* Find the next data segment. ENXIO means there's nothing but a hole until EOF. */
+                        e = lseek(fdf, c, SEEK_DATA);
+                        if (e < 0 && errno == ENXIO)
+                                e = lseek(fdf, 0, SEEK_END);
+                        if (e < 0)
+                                return -errno;
+
+                        if (e > c) {
+                                uint64_t h = MIN(max_bytes, (uint64_t) (e - c));
+
+                                /* We're in a hole, leave one of the same size in the target */
+                                if (lseek(fdt, h, SEEK_CUR) == (off_t) -1)
+                                        return -errno;
+
+                                if (max_bytes != UINT64_MAX) {
+                                        max_bytes -= h;
+                                        if (max_bytes <= 0) {
+                                                if (lseek(fdf, c + h, SEEK_SET) < 0)
+                                                        return -errno;
+
+                                                hit_limit = true;
+                                                break;
+                                        }
+                                }
+
+                                c += h;
+                        }
+
+                        /* And where it ends. ENXIO means we are at EOF. */
+                        e = lseek(fdf, c, SEEK_HOLE);
+                        if (e < 0) {
+                                if (errno == ENXIO) {
+                                        if (lseek(fdf, c, SEEK_SET) < 0)
+                                                return -errno;
+                                        break;
+                                }
+                                return -errno;
+                        }
+
+                        /* SEEK_HOLE moved the file offset, go back to the start of the data */
+                        if (lseek(fdf, c, SEEK_SET) < 0)
+                                return -errno;
+
+                        /* Copy no more than this data segment in this iteration */
+                        m_saved = m;
+                        m = MIN(m, (size_t) (e - c));
+                }
 
                 if (FLAGS_SET(copy_flags, COPY_SIGINT)) {
                         r = sigint_pending();
@@ -324,6 +423,14 @@ int copy_bytes_full(
                         if (n == 0) /* EOF */
                                 break;
 
+                        if (nul_holes) {
+                                z = sparse_write(fdt, buf, n, COPY_HOLE_BLOCK_SIZE);
+                                if (z < 0)
+                                        return (int) z;
+
+                                goto next;
+                        }
+
                         z = (size_t) n;
                         do {
                                 ssize_t k;
@@ -355,6 +462,9 @@ int copy_bytes_full(
                 }
 
         next:
+                if (seek_holes)
+                        m = m_saved;
+
                 if (progress) {
                         r = progress(n, userdata);
                         if (r < 0)
@@ -374,7 +484,13 @@ int copy_bytes_full(
                 copied_something = true;
         }
 
-        return 0; /* return 0 if we hit EOF earlier than the size limit */
+        if (FLAGS_SET(copy_flags, COPY_HOLES)) {
+                r = finish_holes(fdt);
+                if (r < 0)
+                        return r;
+        }
+
+        return hit_limit; /* return > 0 if we hit the max_bytes limit, 0 if we hit EOF earlier */
 }
 
 static int fd_copy_symlink(
@@ -642,10 +758,16 @@ static int fd_copy_regular(
         if (fdt < 0)
                 return -errno;
 
-        r = copy_bytes_full(fdf, fdt, UINT64_MAX, copy_flags, NULL, NULL, progress, userdata);
-        if (r < 0) {
-                (void) unlinkat(dt, to, 0);
-                return r;
+        /* Both files were just opened, hence we know we are at offset zero: try to reflink the whole file
+         * right away, without the file offset dance copy_bytes_full() has to do for arbitrary fds. */
+        if ((copy_flags & COPY_REFLINK) && btrfs_reflink(fdf, fdt) >= 0)
+                r = 0;
+        else {
+                r = copy_bytes_full(fdf, fdt, UINT64_MAX, copy_flags & ~COPY_REFLINK, NULL, NULL, progress, userdata);
+                if (r < 0) {
+                        (void) unlinkat(dt, to, 0);
+                        return r;
+                }
         }
 
         if (fchown(fdt,
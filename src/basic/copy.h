@@ -19,6 +19,7 @@ typedef enum CopyFlags {
         COPY_SIGINT      = 1 << 6, /* Check for SIGINT regularly and return EINTR if seen (caller needs to block SIGINT) */
         COPY_MAC_CREATE  = 1 << 7, /* Create files with the correct MAC label (currently SELinux only) */
         COPY_HARDLINKS   = 1 << 8, /* Try to reproduce hard links */
+        COPY_HOLES       = 1 << 9, /* Leave holes in the target where the source has holes or blocks of NUL bytes */
 } CopyFlags;
 
 typedef int (*copy_progress_bytes_t)(uint64_t n_bytes, void *userdata);
@@ -19,6 +19,7 @@
 #include "hexdecoct.h"
 #include "log.h"
 #include "macro.h"
+#include "memory-util.h"
 #include "mkdir.h"
 #include "parse-util.h"
 #include "path-util.h"
@@ -1062,6 +1063,46 @@ int fflush_sync_and_check(FILE *f) {
         return 0;
 }
 
+int write_data_file_atomic_if_changed(const char *fn, const void *data, size_t size, mode_t mode) {
+        _cleanup_(unlink_and_freep) char *t = NULL;
+        _cleanup_fclose_ FILE *f = NULL;
+        _cleanup_free_ char *old = NULL;
+        size_t old_size;
+        int r;
+
+        assert(fn);
+        assert(data || size == 0);
+
+        /* Atomically replaces the file with the specified data, unless it already contains exactly that. Inotify
+         * watchers of the directory are woken up not only by the rename, but also by the temporary file being
+         * created and cleaned up, hence don't even create one if nothing changed. Returns 0 if the file was left
+         * alone, 1 if it was written. */
+
+        if (read_full_file(fn, &old, &old_size) >= 0 &&
+            memcmp_nn(old, old_size, data, size) == 0)
+                return 0;
+
+        r = fopen_temporary(fn, &f, &t);
+        if (r < 0)
+                return r;
+
+        (void) fchmod(fileno(f), mode);
+
+        fwrite(data, 1, size, f);
+
+        r = fflush_and_check(f);
+        if (r < 0)
+                return r;
+
+        r = conservative_rename(t, fn);
+        if (r < 0)
+                return r;
+
+        t = mfree(t);
+
+        return 1;
+}
+
 int write_timestamp_file_atomic(const char *fn, usec_t n) {
         char ln[DECIMAL_STR_MAX(n)+2];
 
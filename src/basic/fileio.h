@@ -93,6 +93,8 @@ int chase_symlinks_and_fopen_unlocked(
 int fflush_and_check(FILE *f);
 int fflush_sync_and_check(FILE *f);
 
+int write_data_file_atomic_if_changed(const char *fn, const void *data, size_t size, mode_t mode);
+
 int write_timestamp_file_atomic(const char *fn, usec_t n);
 int read_timestamp_file(const char *fn, usec_t *ret);
 
@@ -755,6 +755,74 @@ static int log_autofs_mount_point(int fd, const char *path, unsigned flags) {
                                  strna(n1), path);
 }
 
+static bool openat2_blocked(void) {
+        static int cached = -1;
+        struct open_how how = {
+                .flags = O_PATH|O_CLOEXEC,
+        };
+        int fd;
+
+        /* Opening "/" can't fail with EPERM, unless a seccomp filter refuses the system call itself. Only
+         * probe once, a filter is not going to go away. */
+
+        if (cached >= 0)
+                return cached;
+
+        fd = openat2(AT_FDCWD, "/", &how, sizeof(how));
+        if (fd >= 0) {
+                safe_close(fd);
+                return (cached = false);
+        }
+
+        return (cached = ERRNO_IS_PRIVILEGE(errno) || ERRNO_IS_NOT_SUPPORTED(errno));
+}
+
+static int chase_symlinks_openat2(int root_fd, const char *path, unsigned flags) {
+        static bool openat2_unsupported = false;
+        struct open_how how = {
+                .flags = O_PATH|O_CLOEXEC|((flags & CHASE_NOFOLLOW) ? O_NOFOLLOW : 0),
+                .resolve = RESOLVE_IN_ROOT|RESOLVE_NO_MAGICLINKS,
+        };
+        int r;
+
+        assert(root_fd >= 0);
+        assert(path);
+
+        /* Resolves the path within the root directory in a single system call, if the kernel supports
+         * that. Returns -EOPNOTSUPP if the caller shall walk the path component by component instead. */
+
+        if (openat2_unsupported)
+                return -EOPNOTSUPP;
+
+        r = openat2(root_fd, path, &how, sizeof(how));
+        if (r >= 0)
+                return r;
+
+        if (ERRNO_IS_NOT_SUPPORTED(errno)) {
+                /* Kernel too old, or blocked by seccomp */
+                openat2_unsupported = true;
+                return -EOPNOTSUPP;
+        }
+
+        if (ERRNO_IS_PRIVILEGE(errno)) {
+                /* Some seccomp profiles (e.g. Docker before 20.10) return EPERM for syscalls they don't
+                 * know. Tell that apart from a genuine permission problem by opening "/", which can't fail
+                 * with EPERM otherwise. Either way, let the component walk handle this call, it will run
+                 * into a real EACCES/EPERM again. */
+                if (errno == EPERM && openat2_blocked())
+                        openat2_unsupported = true;
+
+                return -EOPNOTSUPP;
+        }
+
+        /* ELOOP might be due to a magic link, which we follow by its textual contents, and EAGAIN/EXDEV
+         * indicate a rename race the kernel refused to deal with. Let the slow path sort these out. */
+        if (IN_SET(errno, ELOOP, EAGAIN, EXDEV))
+                return -EOPNOTSUPP;
+
+        return -errno;
+}
+
 int chase_symlinks(const char *path, const char *original_root, unsigned flags, char **ret_path, int *ret_fd) {
         _cleanup_free_ char *buffer = NULL, *done = NULL, *root = NULL;
         _cleanup_close_ int fd = -1;
@@ -897,6 +965,18 @@ int chase_symlinks(const char *path, const char *original_root, unsigned flags,
                         return -ENOMEM;
 
                 free_and_replace(buffer, absolute);
+
+                if (!ret_path && !(flags & (CHASE_NONEXISTENT|CHASE_NO_AUTOFS|CHASE_SAFE|CHASE_STEP)) && ret_fd) {
+                        /* Similar to the shortcut above, but for the case where a root directory is set:
+                         * let the kernel do the whole resolution within it, if it can. */
+                        r = chase_symlinks_openat2(fd, buffer, flags);
+                        if (r >= 0) {
+                                *ret_fd = r;
+                                return 1; /* exists */
+                        }
+                        if (r != -EOPNOTSUPP)
+                                return r;
+                }
         }
 
         todo = buffer;
@@ -18,6 +18,7 @@
 #include "siphash24.h"
 #include "string-util.h"
 #include "strv.h"
+#include "unaligned.h"
 
 #if ENABLE_DEBUG_HASHMAP
 #include "list.h"
@@ -298,6 +299,14 @@ _destructor_ static void cleanup_pools(void) {
 }
 #endif
 
+size_t hashmap_trim_pools(void) {
+        /* The pools are only allocated from by the main thread, hence only trim them there */
+        if (!mempool_enabled())
+                return 0;
+
+        return mempool_trim(&hashmap_pool) + mempool_trim(&ordered_hashmap_pool);
+}
+
 static unsigned n_buckets(HashmapBase *h) {
         return h->has_indirect ? h->indirect.n_buckets
                                : hashmap_type_info[h->type].n_direct_buckets;
@@ -443,10 +452,23 @@ static void bucket_set_dib(HashmapBase *h, unsigned idx, unsigned dib) {
 
 static unsigned skip_free_buckets(HashmapBase *h, unsigned idx) {
         dib_raw_t *dibs;
+        unsigned n;
 
         dibs = dib_raw_ptr(h);
+        n = n_buckets(h);
+
+        /* Free buckets have all bits set in their DIB byte, hence we can skip over runs of them eight at a
+         * time. This matters when iterating over sparsely populated tables. */
+        assert_cc(sizeof(dib_raw_t) == 1);
 
-        for ( ; idx < n_buckets(h); idx++)
+        if (idx < n && dibs[idx] != DIB_RAW_FREE)
+                return idx;
+
+        for ( ; idx + sizeof(uint64_t) <= n; idx += sizeof(uint64_t))
+                if (unaligned_read_ne64(dibs + idx) != UINT64_MAX)
+                        break;
+
+        for ( ; idx < n; idx++)
                 if (dibs[idx] != DIB_RAW_FREE)
                         return idx;
 
@@ -1865,6 +1887,18 @@ int _set_put_strdupv_full(Set **s, const struct hash_ops *hash_ops, char **l  HA
 
         assert(s);
 
+        if (strv_isempty(l))
+                return 0;
+
+        /* Size the set once for the whole list, rather than growing it entry by entry */
+        r = _set_ensure_allocated(s, hash_ops  HASHMAP_DEBUG_PASS_ARGS);
+        if (r < 0)
+                return r;
+
+        r = set_reserve(*s, strv_length(l));
+        if (r < 0)
+                return r;
+
         STRV_FOREACH(i, l) {
                 r = _set_put_strdup_full(s, hash_ops, *i  HASHMAP_DEBUG_PASS_ARGS);
                 if (r < 0)
@@ -131,6 +131,17 @@ int unhexmem_full(const char *p, size_t l, bool secure, void **ret, size_t *ret_
         for (x = p, z = buf;;) {
                 int a, b;
 
+                /* Fast path for the common case of a pair of hex digits without whitespace in between */
+                if (l >= 2) {
+                        a = unhexchar(x[0]);
+                        b = unhexchar(x[1]);
+                        if (a >= 0 && b >= 0) {
+                                *(z++) = (uint8_t) a << 4 | (uint8_t) b;
+                                x += 2, l -= 2;
+                                continue;
+                        }
+                }
+
                 a = unhex_next(&x, &l);
                 if (a == -EPIPE) /* End of string */
                         break;
@@ -722,6 +733,22 @@ int unbase64mem_full(const char *p, size_t l, bool secure, void **ret, size_t *r
         for (x = p, z = buf;;) {
                 int a, b, c, d; /* a == 00XXXXXX; b == 00YYYYYY; c == 00ZZZZZZ; d == 00WWWWWW */
 
+                /* Fast path for the common case of a full 4ch block without whitespace or padding. Anything
+                 * else is left to the slow path below, starting from the same position. */
+                if (l >= 4) {
+                        a = unbase64char(x[0]);
+                        b = unbase64char(x[1]);
+                        c = unbase64char(x[2]);
+                        d = unbase64char(x[3]);
+                        if (a >= 0 && b >= 0 && c >= 0 && d >= 0) {
+                                *(z++) = (uint8_t) a << 2 | (uint8_t) b >> 4; /* XXXXXXYY */
+                                *(z++) = (uint8_t) b << 4 | (uint8_t) c >> 2; /* YYYYZZZZ */
+                                *(z++) = (uint8_t) c << 6 | (uint8_t) d;      /* ZZWWWWWW */
+                                x += 4, l -= 4;
+                                continue;
+                        }
+                }
+
                 a = unbase64_next(&x, &l);
                 if (a == -EPIPE) /* End of string */
                         break;
@@ -8,6 +8,7 @@
 #include "io-util.h"
 #include "string-util.h"
 #include "time-util.h"
+#include "unaligned.h"
 
 int flush_fd(int fd) {
         int count = 0;
@@ -201,6 +202,13 @@ int fd_wait_for_event(int fd, int event, usec_t timeout) {
 static size_t nul_length(const uint8_t *p, size_t sz) {
         size_t n = 0;
 
+        /* Skip over NUL bytes a word at a time first, this is called for every byte of large images */
+        while (sz >= sizeof(uint64_t) && unaligned_read_ne64(p) == 0) {
+                n += sizeof(uint64_t);
+                p += sizeof(uint64_t);
+                sz -= sizeof(uint64_t);
+        }
+
         while (sz > 0) {
                 if (*p != 0)
                         break;
@@ -245,8 +253,12 @@ ssize_t sparse_write(int fd, const void *p, size_t sz, size_t run_length) {
                         w = q;
                 } else if (n > 0)
                         q += n;
-                else
-                        q++;
+                else {
+                        /* Not a NUL byte, jump right to the next one */
+                        q = memchr(q, 0, e - q);
+                        if (!q)
+                                q = e;
+                }
         }
 
         if (q > w) {
@@ -364,6 +364,12 @@ void log_set_facility(int facility) {
         log_facility = facility;
 }
 
+static pid_t log_get_tid(void) {
+        /* The TID of the main thread is its PID, which we cache, unlike the TID. Hence avoid the gettid()
+         * system call for each message in the common case. */
+        return is_main_thread() ? getpid_cached() : gettid();
+}
+
 static int write_to_console(
                 int level,
                 int error,
@@ -395,7 +401,7 @@ static int write_to_console(
         }
 
         if (show_tid) {
-                xsprintf(tid_string, "(" PID_FMT ") ", gettid());
+                xsprintf(tid_string, "(" PID_FMT ") ", log_get_tid());
                 iovec[n++] = IOVEC_MAKE_STRING(tid_string);
         }
 
@@ -568,7 +574,7 @@ static int log_do_header(
                      "SYSLOG_IDENTIFIER=%.256s\n",
                      LOG_PRI(level),
                      LOG_FAC(level),
-                     gettid(),
+                     log_get_tid(),
                      isempty(file) ? "" : "CODE_FILE=",
                      isempty(file) ? "" : file,
                      isempty(file) ? "" : "\n",
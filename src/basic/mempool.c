@@ -73,6 +73,53 @@ void mempool_free_tile(struct mempool *mp, void *p) {
         mp->freelist = p;
 }
 
+static bool pool_contains(struct mempool *mp, struct pool *p, void *ptr) {
+        uintptr_t a, b;
+
+        a = (uintptr_t) p + ALIGN(sizeof(struct pool));
+        b = (uintptr_t) ptr;
+
+        return b >= a && b < a + p->n_tiles * mp->tile_size;
+}
+
+size_t mempool_trim(struct mempool *mp) {
+        size_t trimmed = 0;
+        struct pool **pp;
+
+        assert(mp);
+
+        /* Releases all pools of which every handed out tile has been returned to the freelist again. This
+         * walks the freelist once per pool, but since pools grow exponentially there are only few of them. */
+
+        for (pp = &mp->first_pool; *pp; ) {
+                struct pool *p = *pp;
+                size_t n_free = 0;
+                void **i;
+
+                for (void *t = mp->freelist; t; t = * (void**) t)
+                        if (pool_contains(mp, p, t))
+                                n_free++;
+
+                if (n_free < p->n_used) {
+                        pp = &p->next;
+                        continue;
+                }
+
+                /* All tiles are unused, drop them from the freelist, and the pool itself */
+                for (i = &mp->freelist; *i; )
+                        if (pool_contains(mp, p, *i))
+                                *i = * (void**) *i;
+                        else
+                                i = (void**) *i;
+
+                *pp = p->next;
+                trimmed += p->n_tiles * mp->tile_size;
+                free(p);
+        }
+
+        return trimmed;
+}
+
 bool mempool_enabled(void) {
         static int b = -1;
 
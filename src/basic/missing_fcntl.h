@@ -2,6 +2,24 @@
 #pragma once
 
 #include <fcntl.h>
+#include <stdint.h>
+
+#if HAVE_LINUX_OPENAT2_H
+#include <linux/openat2.h>
+#else
+/* fddb5d430ad9fa91b49b1d34d0202ffe2fa0e179 (5.6) */
+struct open_how {
+        uint64_t flags;
+        uint64_t mode;
+        uint64_t resolve;
+};
+
+#define RESOLVE_NO_XDEV       0x01
+#define RESOLVE_NO_MAGICLINKS 0x02
+#define RESOLVE_NO_SYMLINKS   0x04
+#define RESOLVE_BENEATH       0x08
+#define RESOLVE_IN_ROOT       0x10
+#endif
 
 #ifndef F_LINUX_SPECIFIC_BASE
 #define F_LINUX_SPECIFIC_BASE 1024
@@ -20,6 +20,7 @@
 #include <asm/sgidefs.h>
 #endif
 
+#include "missing_fcntl.h"
 #include "missing_keyctl.h"
 #include "missing_stat.h"
 #include "missing_syscall_def.h"
@@ -390,6 +391,21 @@ static inline int missing_close_range(int first_fd, int end_fd, unsigned flags)
 
 /* ======================================================================= */
 
+#if !HAVE_OPENAT2
+static inline int missing_openat2(int dirfd, const char *pathname, struct open_how *how, size_t size) {
+#  ifdef __NR_openat2
+        return syscall(__NR_openat2, dirfd, pathname, how, size);
+#  else
+        errno = ENOSYS;
+        return -1;
+#  endif
+}
+
+#  define openat2 missing_openat2
+#endif
+
+/* ======================================================================= */
+
 #if !HAVE_EPOLL_PWAIT2
 
 /* Defined to be equivalent to the kernel's _NSIG_WORDS, i.e. the size of the array of longs that is
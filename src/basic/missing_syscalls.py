@@ -12,6 +12,7 @@ SYSCALLS = [
     'getrandom',
     'memfd_create',
     'name_to_handle_at',
+    'openat2',
     'pidfd_open',
     'pidfd_send_signal',
     'pkey_mprotect',
@@ -7,7 +7,7 @@
  * priority. Insertion and removal are Θ(log n). Optionally, the caller can
  * provide a pointer to an index which will be kept up-to-date by the prioq.
  *
- * The underlying algorithm used in this implementation is a Heap.
+ * The underlying algorithm used in this implementation is a 4-ary Heap.
  */
 
 #include <errno.h>
@@ -64,80 +64,83 @@ int prioq_ensure_allocated(Prioq **q, compare_func_t compare_func) {
         return 0;
 }
 
-static void swap(Prioq *q, unsigned j, unsigned k) {
+/* Every node has up to PRIOQ_ARITY children. A 4-ary heap is half as deep as a binary one, and the children
+ * of one node are adjacent in memory, so that sifting through it touches fewer cache lines. */
+#define PRIOQ_ARITY 4U
+
+static void set_item(Prioq *q, unsigned k, const struct prioq_item *i) {
         assert(q);
-        assert(j < q->n_items);
         assert(k < q->n_items);
+        assert(i);
 
-        assert(!q->items[j].idx || *(q->items[j].idx) == j);
-        assert(!q->items[k].idx || *(q->items[k].idx) == k);
-
-        SWAP_TWO(q->items[j].data, q->items[k].data);
-        SWAP_TWO(q->items[j].idx, q->items[k].idx);
-
-        if (q->items[j].idx)
-                *q->items[j].idx = j;
+        q->items[k] = *i;
 
         if (q->items[k].idx)
                 *q->items[k].idx = k;
 }
 
 static unsigned shuffle_up(Prioq *q, unsigned idx) {
+        struct prioq_item i;
+
         assert(q);
         assert(idx < q->n_items);
 
+        /* Rather than swapping the item with its parent on every level, only move the parents down, and put
+         * the item itself into the hole left over in the end. */
+        i = q->items[idx];
+
         while (idx > 0) {
                 unsigned k;
 
-                k = (idx-1)/2;
+                k = (idx-1)/PRIOQ_ARITY;
 
-                if (q->compare_func(q->items[k].data, q->items[idx].data) <= 0)
+                if (q->compare_func(q->items[k].data, i.data) <= 0)
                         break;
 
-                swap(q, idx, k);
+                set_item(q, idx, q->items + k);
                 idx = k;
         }
 
+        set_item(q, idx, &i);
         return idx;
 }
 
 static unsigned shuffle_down(Prioq *q, unsigned idx) {
+        struct prioq_item i;
+
         assert(q);
+        assert(idx < q->n_items);
+
+        i = q->items[idx];
 
         for (;;) {
                 unsigned j, k, s;
+                const void *smallest;
 
-                k = (idx+1)*2; /* right child */
-                j = k-1;       /* left child */
-
+                j = idx*PRIOQ_ARITY + 1; /* first child */
                 if (j >= q->n_items)
                         break;
 
-                if (q->compare_func(q->items[j].data, q->items[idx].data) < 0)
-
-                        /* So our left child is smaller than we are, let's
-                         * remember this fact */
-                        s = j;
-                else
-                        s = idx;
-
-                if (k < q->n_items &&
-                    q->compare_func(q->items[k].data, q->items[s].data) < 0)
-
-                        /* So our right child is smaller than we are, let's
-                         * remember this fact */
-                        s = k;
+                k = MIN(j + PRIOQ_ARITY, q->n_items); /* one past the last child */
 
-                /* s now points to the smallest of the three items */
+                /* Find the smallest of our item and all children */
+                s = idx;
+                smallest = i.data;
+                for (; j < k; j++)
+                        if (q->compare_func(q->items[j].data, smallest) < 0) {
+                                s = j;
+                                smallest = q->items[j].data;
+                        }
 
                 if (s == idx)
-                        /* No swap necessary, we're done */
+                        /* No move necessary, we're done */
                         break;
 
-                swap(q, idx, s);
+                set_item(q, idx, q->items + s);
                 idx = s;
         }
 
+        set_item(q, idx, &i);
         return idx;
 }
 
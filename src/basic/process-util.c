@@ -438,8 +438,9 @@ int get_process_exe(pid_t pid, char **name) {
 }
 
 static int get_process_id(pid_t pid, const char *field, uid_t *uid) {
-        _cleanup_fclose_ FILE *f = NULL;
+        _cleanup_free_ char *status = NULL;
         const char *p;
+        char *l;
         int r;
 
         assert(field);
@@ -448,24 +449,23 @@ static int get_process_id(pid_t pid, const char *field, uid_t *uid) {
         if (pid < 0)
                 return -EINVAL;
 
+        /* Read the whole file in one go and look for the field in place, instead of allocating each line
+         * separately. The file is small, and the fields we look for are near its beginning anyway. */
         p = procfs_file_alloca(pid, "status");
-        r = fopen_unlocked(p, "re", &f);
+        r = read_full_virtual_file(p, &status, NULL);
         if (r == -ENOENT)
                 return -ESRCH;
         if (r < 0)
                 return r;
 
-        for (;;) {
-                _cleanup_free_ char *line = NULL;
-                char *l;
+        for (l = status; l && *l; ) {
+                char *e;
 
-                r = read_line(f, LONG_LINE_MAX, &line);
-                if (r < 0)
-                        return r;
-                if (r == 0)
-                        break;
+                e = strchr(l, '\n');
+                if (e)
+                        *(e++) = 0;
 
-                l = strstrip(line);
+                l += strspn(l, WHITESPACE);
 
                 if (startswith(l, field)) {
                         l += strlen(field);
@@ -475,6 +475,8 @@ static int get_process_id(pid_t pid, const char *field, uid_t *uid) {
 
                         return parse_uid(l, uid);
                 }
+
+                l = e;
         }
 
         return -EIO;
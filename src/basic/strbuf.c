@@ -36,6 +36,7 @@ struct strbuf* strbuf_new(void) {
                 .buf = new0(char, 1),
                 .root = new0(struct strbuf_node, 1),
                 .len = 1,
+                .allocated = 1,
                 .nodes_count = 1,
         };
         if (!str->buf || !str->root) {
@@ -109,7 +110,6 @@ ssize_t strbuf_add_string(struct strbuf *str, const char *s, size_t len) {
         uint8_t c;
         struct strbuf_node *node;
         size_t depth;
-        char *buf_new;
         struct strbuf_child_entry *child;
         struct strbuf_node *node_child;
         ssize_t off;
@@ -149,10 +149,8 @@ ssize_t strbuf_add_string(struct strbuf *str, const char *s, size_t len) {
         }
 
         /* add new string */
-        buf_new = realloc(str->buf, str->len + len+1);
-        if (!buf_new)
+        if (!GREEDY_REALLOC(str->buf, str->allocated, str->len + len+1))
                 return -ENOMEM;
-        str->buf = buf_new;
         off = str->len;
         memcpy(str->buf + off, s, len);
         str->len += len;
@@ -271,6 +271,29 @@ int unit_file_build_name_map(
                 paths = set_new(&path_hash_ops_free);
                 if (!paths)
                         return log_oom();
+
+                if (set_reserve(paths, set_size(*path_cache)) < 0)
+                        return log_oom();
+        }
+
+        /* When rebuilding, the new maps usually end up about as large as the old ones. Size them
+         * accordingly right away, so that they don't have to be grown and rehashed step by step. */
+        if (!hashmap_isempty(*unit_ids_map)) {
+                ids = hashmap_new(&string_hash_ops_free_free);
+                if (!ids)
+                        return log_oom();
+
+                if (hashmap_reserve(ids, hashmap_size(*unit_ids_map)) < 0)
+                        return log_oom();
+        }
+
+        if (!hashmap_isempty(*unit_names_map)) {
+                names = hashmap_new(&string_strv_hash_ops);
+                if (!names)
+                        return log_oom();
+
+                if (hashmap_reserve(names, hashmap_size(*unit_names_map)) < 0)
+                        return log_oom();
         }
 
         STRV_FOREACH(dir, (char**) lp->search_path) {
@@ -132,6 +132,17 @@ bool utf8_is_printable_newline(const char* str, size_t length, bool allow_newlin
                 int encoded_len, r;
                 char32_t val;
 
+                /* Fast path for plain ASCII, which is what the vast majority of log data is */
+                if ((uint8_t) *p < 0x80) {
+                        if (unichar_is_control(*p) ||
+                            (!allow_newline && *p == '\n'))
+                                return false;
+
+                        length--;
+                        p++;
+                        continue;
+                }
+
                 encoded_len = utf8_encoded_valid_unichar(p, length);
                 if (encoded_len < 0)
                         return false;
@@ -595,7 +595,7 @@ static void display(Hashmap *a) {
         Group *g;
         Group **array;
         signed path_columns;
-        unsigned rows, n = 0, j, maxtcpu = 0, maxtpath = 3; /* 3 for ellipsize() to work properly */
+        unsigned rows, n = 0, n_shown, j, maxtcpu = 0, maxtpath = 3; /* 3 for ellipsize() to work properly */
         char buffer[MAX4(21U, FORMAT_BYTES_MAX, FORMAT_TIMESPAN_MAX, DECIMAL_STR_MAX(usec_t))];
 
         assert(a);
@@ -611,13 +611,24 @@ static void display(Hashmap *a) {
 
         typesafe_qsort(array, n, group_compare);
 
-        /* Find the longest names in one run */
+        rows = lines();
+        if (rows <= 10)
+                rows = 10;
+
+        /* On a terminal we only show what fits on the screen */
+        n_shown = on_tty() ? MIN(n, rows - 5) : n;
+
+        /* Find the longest names in one run. Do this over all groups, not only the shown ones, so that the
+         * column widths don't change as groups scroll in and out of view. */
         for (j = 0; j < n; j++) {
                 unsigned cputlen, pathtlen;
 
-                maybe_format_timespan(buffer, sizeof(buffer), (usec_t) (array[j]->cpu_usage / NSEC_PER_USEC), 0);
-                cputlen = strlen(buffer);
-                maxtcpu = MAX(maxtcpu, cputlen);
+                /* The CPU time is only shown, and hence only needs to be formatted, in CPU time mode */
+                if (arg_cpu_type == CPU_TIME) {
+                        maybe_format_timespan(buffer, sizeof(buffer), (usec_t) (array[j]->cpu_usage / NSEC_PER_USEC), 0);
+                        cputlen = strlen(buffer);
+                        maxtcpu = MAX(maxtcpu, cputlen);
+                }
 
                 pathtlen = strlen(array[j]->path);
                 maxtpath = MAX(maxtpath, pathtlen);
@@ -628,10 +639,6 @@ static void display(Hashmap *a) {
         else
                 xsprintf(buffer, "%*s", maxtcpu, "CPU Time");
 
-        rows = lines();
-        if (rows <= 10)
-                rows = 10;
-
         if (on_tty()) {
                 const char *on, *off;
 
@@ -660,13 +667,10 @@ static void display(Hashmap *a) {
         } else
                 path_columns = maxtpath;
 
-        for (j = 0; j < n; j++) {
+        for (j = 0; j < n_shown; j++) {
                 _cleanup_free_ char *ellipsized = NULL;
                 const char *path;
 
-                if (on_tty() && j + 6 > rows)
-                        break;
-
                 g = array[j];
 
                 path = empty_to_root(g->path);
@@ -1118,11 +1118,12 @@ static void set_io_weight(Unit *u, const char *controller, uint64_t weight) {
 static void cgroup_context_apply(
                 Unit *u,
                 CGroupMask apply_mask,
+                bool created,
                 ManagerState state) {
 
         const char *path;
         CGroupContext *c;
-        bool is_host_root, is_local_root;
+        bool is_host_root, is_local_root, fresh;
         int r;
 
         assert(u);
@@ -1131,6 +1132,11 @@ static void cgroup_context_apply(
         if (apply_mask == 0)
                 return;
 
+        /* On the unified hierarchy a cgroup we just created has all attributes at their kernel defaults, hence
+         * there's no need to write those again. On boot this saves a good number of cgroupfs writes, since most
+         * units don't configure most of the attributes of the controllers enabled for them. */
+        fresh = created && cg_all_unified() > 0;
+
         /* Some cgroup attributes are not supported on the host root cgroup, hence silently ignore them here. And other
          * attributes should only be managed for cgroups further down the tree. */
         is_local_root = unit_has_name(u, SPECIAL_ROOT_SLICE);
@@ -1168,7 +1174,8 @@ static void cgroup_context_apply(
                         } else
                                 weight = CGROUP_WEIGHT_DEFAULT;
 
-                        cgroup_apply_unified_cpu_weight(u, weight);
+                        if (!fresh || weight != CGROUP_WEIGHT_DEFAULT)
+                                cgroup_apply_unified_cpu_weight(u, weight);
                         cgroup_apply_unified_cpu_quota(u, c->cpu_quota_per_sec_usec, c->cpu_quota_period_usec);
 
                 } else {
@@ -1352,13 +1359,21 @@ static void cgroup_context_apply(
                                         log_cgroup_compat(u, "Applying MemoryLimit=%" PRIu64 " as MemoryMax=", max);
                         }
 
-                        cgroup_apply_unified_memory_limit(u, "memory.min", unit_get_ancestor_memory_min(u));
-                        cgroup_apply_unified_memory_limit(u, "memory.low", unit_get_ancestor_memory_low(u));
-                        cgroup_apply_unified_memory_limit(u, "memory.high", c->memory_high);
-                        cgroup_apply_unified_memory_limit(u, "memory.max", max);
-                        cgroup_apply_unified_memory_limit(u, "memory.swap.max", swap_max);
+                        uint64_t min = unit_get_ancestor_memory_min(u), low = unit_get_ancestor_memory_low(u);
+
+                        if (!fresh || min != 0)
+                                cgroup_apply_unified_memory_limit(u, "memory.min", min);
+                        if (!fresh || low != 0)
+                                cgroup_apply_unified_memory_limit(u, "memory.low", low);
+                        if (!fresh || c->memory_high != CGROUP_LIMIT_MAX)
+                                cgroup_apply_unified_memory_limit(u, "memory.high", c->memory_high);
+                        if (!fresh || max != CGROUP_LIMIT_MAX)
+                                cgroup_apply_unified_memory_limit(u, "memory.max", max);
+                        if (!fresh || swap_max != CGROUP_LIMIT_MAX)
+                                cgroup_apply_unified_memory_limit(u, "memory.swap.max", swap_max);
 
-                        (void) set_attribute_and_warn(u, "memory", "memory.oom.group", one_zero(c->memory_oom_group));
+                        if (!fresh || c->memory_oom_group)
+                                (void) set_attribute_and_warn(u, "memory", "memory.oom.group", one_zero(c->memory_oom_group));
 
                 } else {
                         char buf[DECIMAL_STR_MAX(uint64_t) + 1];
@@ -1421,7 +1436,7 @@ static void cgroup_context_apply(
 
                                 xsprintf(buf, "%" PRIu64 "\n", tasks_max_resolve(&c->tasks_max));
                                 (void) set_attribute_and_warn(u, "pids", "pids.max", buf);
-                        } else
+                        } else if (!fresh)
                                 (void) set_attribute_and_warn(u, "pids", "pids.max", "max\n");
                 }
         }
@@ -1950,7 +1965,7 @@ static int unit_update_cgroup(
         }
 
         /* Set attributes */
-        cgroup_context_apply(u, target_mask, state);
+        cgroup_context_apply(u, target_mask, created, state);
         cgroup_xattr_apply(u);
 
         return 0;
@@ -2698,6 +2713,23 @@ static int on_cgroup_empty_event(sd_event_source *s, void *userdata) {
         return 0;
 }
 
+static void unit_enqueue_cgroup_empty(Unit *u) {
+        int r;
+
+        assert(u);
+
+        if (u->in_cgroup_empty_queue)
+                return;
+
+        LIST_PREPEND(cgroup_empty_queue, u->manager->cgroup_empty_queue, u);
+        u->in_cgroup_empty_queue = true;
+
+        /* Trigger the defer event */
+        r = sd_event_source_set_enabled(u->manager->cgroup_empty_event_source, SD_EVENT_ONESHOT);
+        if (r < 0)
+                log_debug_errno(r, "Failed to enable cgroup empty event source: %m");
+}
+
 void unit_add_to_cgroup_empty_queue(Unit *u) {
         int r;
 
@@ -2735,13 +2767,7 @@ void unit_add_to_cgroup_empty_queue(Unit *u) {
         if (r == 0)
                 return;
 
-        LIST_PREPEND(cgroup_empty_queue, u->manager->cgroup_empty_queue, u);
-        u->in_cgroup_empty_queue = true;
-
-        /* Trigger the defer event */
-        r = sd_event_source_set_enabled(u->manager->cgroup_empty_event_source, SD_EVENT_ONESHOT);
-        if (r < 0)
-                log_debug_errno(r, "Failed to enable cgroup empty event source: %m");
+        unit_enqueue_cgroup_empty(u);
 }
 
 static void unit_remove_from_cgroup_empty_queue(Unit *u) {
@@ -2906,12 +2932,14 @@ static int unit_check_cgroup_events(Unit *u) {
 
         /* The cgroup.events notifications can be merged together so act as we saw the given state for the
          * first time. The functions we call to handle given state are idempotent, which makes them
-         * effectively remember the previous state. */
+         * effectively remember the previous state. We just read "populated" from cgroup.events ourselves,
+         * hence there's no need to verify it once more, as unit_add_to_cgroup_empty_queue() would: with many
+         * units exiting at the same time that would double the number of cgroupfs reads. */
         if (values[0]) {
                 if (streq(values[0], "1"))
                         unit_remove_from_cgroup_empty_queue(u);
                 else
-                        unit_add_to_cgroup_empty_queue(u);
+                        unit_enqueue_cgroup_empty(u);
         }
 
         /* Disregard freezer state changes due to operations not initiated by us */
@@ -3537,6 +3565,9 @@ int unit_get_io_accounting(
                         u->io_accounting_last[i] = 0;
         }
 
+        if (sd_event_now(u->manager->event, CLOCK_MONOTONIC, &u->io_accounting_last_usec) != 0)
+                u->io_accounting_last_usec = 0;
+
 done:
         if (ret)
                 *ret = u->io_accounting_last[metric];
@@ -1398,14 +1398,20 @@ static int property_get_io_counter(
         uint64_t value = UINT64_MAX;
         Unit *u = userdata;
         ssize_t metric;
+        bool cached;
+        usec_t t;
 
         assert(bus);
         assert(reply);
         assert(property);
         assert(u);
 
+        /* GetAll() asks for all four metrics in a row. Let's read io.stat only once for them, by accepting
+         * the cached values if they were read during the same event loop iteration. */
+        cached = sd_event_now(u->manager->event, CLOCK_MONOTONIC, &t) == 0 && u->io_accounting_last_usec == t;
+
         assert_se((metric = string_table_lookup(table, ELEMENTSOF(table), property)) >= 0);
-        (void) unit_get_io_accounting(u, metric, false, &value);
+        (void) unit_get_io_accounting(u, metric, cached, &value);
         return sd_bus_message_append(reply, "t", value);
 }
 
@@ -356,10 +356,48 @@ static int device_update_description(Unit *u, sd_device *dev, const char *path)
         return 0;
 }
 
+static bool device_udev_wants_in_place(Unit *u, char **wants) {
+        char **i;
+
+        assert(u);
+
+        STRV_FOREACH(i, wants) {
+                Unit *other;
+
+                other = manager_get_unit(u->manager, *i);
+                if (!other || !hashmap_contains(u->dependencies[UNIT_WANTS], other))
+                        return false;
+        }
+
+        return true;
+}
+
+static bool device_has_other_udev_deps(Unit *u) {
+        assert(u);
+
+        /* Checks whether there are udev generated dependencies other than the ones from SYSTEMD_WANTS=,
+         * e.g. the BindsTo= ones installed by device_upgrade_mount_deps(). */
+
+        for (UnitDependency d = 0; d < _UNIT_DEPENDENCY_MAX; d++) {
+                UnitDependencyInfo di;
+                Unit *other;
+
+                if (IN_SET(d, UNIT_WANTS, UNIT_REFERENCES))
+                        continue;
+
+                HASHMAP_FOREACH_KEY(di.data, other, u->dependencies[d])
+                        if ((di.origin_mask | di.destination_mask) & UNIT_DEPENDENCY_UDEV)
+                                return true;
+        }
+
+        return false;
+}
+
 static int device_add_udev_wants(Unit *u, sd_device *dev) {
         _cleanup_strv_free_ char **added = NULL;
         const char *wants, *property;
         Device *d = DEVICE(u);
+        char **i;
         int r;
 
         assert(d);
@@ -369,7 +407,7 @@ static int device_add_udev_wants(Unit *u, sd_device *dev) {
 
         r = sd_device_get_property_value(dev, property, &wants);
         if (r < 0)
-                return 0;
+                wants = NULL;
 
         for (;;) {
                 _cleanup_free_ char *word = NULL, *k = NULL;
@@ -403,20 +441,30 @@ static int device_add_udev_wants(Unit *u, sd_device *dev) {
                                 return log_unit_error_errno(u, r, "Failed to mangle unit name \"%s\": %m", word);
                 }
 
-                r = unit_add_dependency_by_name(u, UNIT_WANTS, k, true, UNIT_DEPENDENCY_UDEV);
-                if (r < 0)
-                        return log_unit_error_errno(u, r, "Failed to add Wants= dependency: %m");
-
-                r = strv_push(&added, k);
+                r = strv_consume(&added, TAKE_PTR(k));
                 if (r < 0)
                         return log_oom();
+        }
 
-                k = NULL;
+        /* Most udev events for a device don't change its SYSTEMD_WANTS property. In that case the
+         * dependencies are already in place, and there's no point in removing and re-adding them. If there
+         * are other udev generated dependencies, reset all of them as before. */
+        if (strv_equal(added, d->wants_property) &&
+            device_udev_wants_in_place(u, added) &&
+            !device_has_other_udev_deps(u))
+                return 0;
+
+        /* Let's remove all dependencies generated due to udev properties, and add in whatever is configured
+         * now. */
+        unit_remove_dependencies(u, UNIT_DEPENDENCY_UDEV);
+
+        STRV_FOREACH(i, added) {
+                r = unit_add_dependency_by_name(u, UNIT_WANTS, *i, true, UNIT_DEPENDENCY_UDEV);
+                if (r < 0)
+                        return log_unit_error_errno(u, r, "Failed to add Wants= dependency: %m");
         }
 
         if (d->state != DEVICE_DEAD) {
-                char **i;
-
                 /* So here's a special hack, to compensate for the fact that the udev database's reload cycles are not
                  * synchronized with our own reload cycles: when we detect that the SYSTEMD_WANTS property of a device
                  * changes while the device unit is already up, let's manually trigger any new units listed in it not
@@ -521,8 +569,10 @@ static int device_setup_unit(Manager *m, sd_device *dev, const char *path, bool
                 delete = false;
 
                 /* Let's remove all dependencies generated due to udev properties. We'll re-add whatever is configured
-                 * now below. */
-                unit_remove_dependencies(u, UNIT_DEPENDENCY_UDEV);
+                 * now below. For the main unit device_add_udev_wants() takes care of this, so that it can keep the
+                 * dependencies in place if nothing changed. */
+                if (!main || !sysfs)
+                        unit_remove_dependencies(u, UNIT_DEPENDENCY_UDEV);
         } else {
                 delete = true;
 
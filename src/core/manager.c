@@ -101,6 +101,9 @@
 /* How many units and jobs to process of the bus queue before returning to the event loop. */
 #define MANAGER_BUS_MESSAGE_BUDGET 100U
 
+/* How many notification messages to process before returning to the event loop. */
+#define NOTIFY_MESSAGE_BUDGET 16U
+
 static int manager_dispatch_notify_fd(sd_event_source *source, int fd, uint32_t revents, void *userdata);
 static int manager_dispatch_cgroups_agent_fd(sd_event_source *source, int fd, uint32_t revents, void *userdata);
 static int manager_dispatch_signal_fd(sd_event_source *source, int fd, uint32_t revents, void *userdata);
@@ -1195,9 +1198,14 @@ static void unit_gc_sweep(Unit *u, unsigned gc_marker) {
                 goto bad;
 
         /* We were unable to find anything out about this entry, so
-         * let's investigate it later */
+         * let's investigate it later. Note that we enqueue it directly here rather than via
+         * unit_add_to_gc_queue(), as we just checked unit_may_gc() above, and repeating that would mean
+         * another round of cgroupfs accesses for each such unit. */
         u->gc_marker = gc_marker + GC_OFFSET_UNSURE;
-        unit_add_to_gc_queue(u);
+        if (!u->in_gc_queue) {
+                LIST_PREPEND(gc_queue, u->manager->gc_unit_queue, u);
+                u->in_gc_queue = true;
+        }
         return;
 
 bad:
@@ -1447,13 +1455,21 @@ static void manager_enumerate(Manager *m) {
 
         /* Let's ask every type to load all units from disk/kernel that it might know */
         for (UnitType c = 0; c < _UNIT_TYPE_MAX; c++) {
+                char buf[FORMAT_TIMESPAN_MAX];
+                usec_t begin;
+
                 if (!unit_type_supported(c)) {
                         log_debug("Unit type .%s is not supported on this system.", unit_type_to_string(c));
                         continue;
                 }
 
-                if (unit_vtable[c]->enumerate)
-                        unit_vtable[c]->enumerate(m);
+                if (!unit_vtable[c]->enumerate)
+                        continue;
+
+                begin = now(CLOCK_MONOTONIC);
+                unit_vtable[c]->enumerate(m);
+                log_debug("Enumerated .%s units in %s.", unit_type_to_string(c),
+                          format_timespan(buf, sizeof(buf), usec_sub_unsigned(now(CLOCK_MONOTONIC), begin), USEC_PER_MSEC));
         }
 
         manager_dispatch_load_queue(m);
@@ -2100,6 +2116,42 @@ void manager_dump_units(Manager *s, FILE *f, const char *prefix) {
                         unit_dump(u, f, prefix);
 }
 
+static void manager_dump_summary(Manager *m, FILE *f, const char *prefix) {
+        unsigned n_units = 0, n_dependencies = 0;
+
+        assert(m);
+        assert(f);
+
+        /* A few object counts, to give an idea where our memory goes */
+
+        for (UnitType t = 0; t < _UNIT_TYPE_MAX; t++) {
+                unsigned n = 0;
+                Unit *u;
+
+                LIST_FOREACH(units_by_type, u, m->units_by_type[t]) {
+                        n++;
+
+                        for (UnitDependency d = 0; d < _UNIT_DEPENDENCY_MAX; d++)
+                                n_dependencies += hashmap_size(u->dependencies[d]);
+                }
+
+                if (n > 0)
+                        fprintf(f, "%sUnits of type %s: %u\n", strempty(prefix), unit_type_to_string(t), n);
+
+                n_units += n;
+        }
+
+        fprintf(f,
+                "%sUnits: %u\n"
+                "%sUnit names: %u\n"
+                "%sUnit dependencies: %u\n"
+                "%sJobs: %u\n",
+                strempty(prefix), n_units,
+                strempty(prefix), hashmap_size(m->units),
+                strempty(prefix), n_dependencies,
+                strempty(prefix), hashmap_size(m->jobs));
+}
+
 void manager_dump(Manager *m, FILE *f, const char *prefix) {
         assert(m);
         assert(f);
@@ -2116,6 +2168,7 @@ void manager_dump(Manager *m, FILE *f, const char *prefix) {
                                                                 format_timespan(buf, sizeof buf, t->monotonic, 1));
         }
 
+        manager_dump_summary(m, f, prefix);
         manager_dump_units(m, f, prefix);
         manager_dump_jobs(m, f, prefix);
 }
@@ -2337,10 +2390,8 @@ static void manager_invoke_notify_message(
         }
 }
 
-static int manager_dispatch_notify_fd(sd_event_source *source, int fd, uint32_t revents, void *userdata) {
-
+static int manager_receive_notify_message(Manager *m) {
         _cleanup_fdset_free_ FDSet *fds = NULL;
-        Manager *m = userdata;
         char buf[NOTIFY_BUFFER_MAX+1];
         struct iovec iovec = {
                 .iov_base = buf,
@@ -2366,19 +2417,16 @@ static int manager_dispatch_notify_fd(sd_event_source *source, int fd, uint32_t
         ssize_t n;
 
         assert(m);
-        assert(m->notify_fd == fd);
 
-        if (revents != EPOLLIN) {
-                log_warning("Got unexpected poll event for notify fd.");
-                return 0;
-        }
+        /* Returns > 0 if a message was read off the socket (regardless if it was valid), 0 if there was none
+         * and < 0 on errors that should stop processing of the socket. */
 
         n = recvmsg_safe(m->notify_fd, &msghdr, MSG_DONTWAIT|MSG_CMSG_CLOEXEC|MSG_TRUNC);
         if (IN_SET(n, -EAGAIN, -EINTR))
-                return 0; /* Spurious wakeup, try again */
+                return 0; /* Spurious wakeup, or nothing more to read */
         if (n == -EXFULL) {
                 log_warning("Got message with truncated control data (too many fds sent?), ignoring.");
-                return 0;
+                return 1;
         }
         if (n < 0)
                 /* If this is any other, real error, then let's stop processing this socket. This of course
@@ -2410,25 +2458,25 @@ static int manager_dispatch_notify_fd(sd_event_source *source, int fd, uint32_t
                 if (r < 0) {
                         close_many(fd_array, n_fds);
                         log_oom();
-                        return 0;
+                        return 1;
                 }
         }
 
         if (!ucred || !pid_is_valid(ucred->pid)) {
                 log_warning("Received notify message without valid credentials. Ignoring.");
-                return 0;
+                return 1;
         }
 
         if ((size_t) n >= sizeof(buf) || (msghdr.msg_flags & MSG_TRUNC)) {
                 log_warning("Received notify message exceeded maximum size. Ignoring.");
-                return 0;
+                return 1;
         }
 
         /* As extra safety check, let's make sure the string we get doesn't contain embedded NUL bytes. We permit one
          * trailing NUL byte in the message, but don't expect it. */
         if (n > 1 && memchr(buf, 0, n-1)) {
                 log_warning("Received notify message with embedded NUL bytes. Ignoring.");
-                return 0;
+                return 1;
         }
 
         /* Make sure it's NUL-terminated, then parse it to obtain the tags list */
@@ -2436,12 +2484,12 @@ static int manager_dispatch_notify_fd(sd_event_source *source, int fd, uint32_t
         tags = strv_split_newlines(buf);
         if (!tags) {
                 log_oom();
-                return 0;
+                return 1;
         }
 
         /* possibly a barrier fd, let's see */
         if (manager_process_barrier_fd(tags, fds))
-                return 0;
+                return 1;
 
         /* Increase the generation counter used for filtering out duplicate unit invocations. */
         m->notifygen++;
@@ -2482,6 +2530,30 @@ static int manager_dispatch_notify_fd(sd_event_source *source, int fd, uint32_t
         if (fdset_size(fds) > 0)
                 log_warning("Got extra auxiliary fds with notification message, closing them.");
 
+        return 1;
+}
+
+static int manager_dispatch_notify_fd(sd_event_source *source, int fd, uint32_t revents, void *userdata) {
+        Manager *m = userdata;
+        int r;
+
+        assert(m);
+        assert(m->notify_fd == fd);
+
+        if (revents != EPOLLIN) {
+                log_warning("Got unexpected poll event for notify fd.");
+                return 0;
+        }
+
+        /* Process a couple of messages per wakeup, so that services sending notifications at a high rate
+         * (e.g. WATCHDOG=1 from many units) don't cost us a full event loop iteration each. Don't process
+         * an unbounded number though, so that we don't starve other event sources. */
+        for (unsigned i = 0; i < NOTIFY_MESSAGE_BUDGET; i++) {
+                r = manager_receive_notify_message(m);
+                if (r <= 0)
+                        return r;
+        }
+
         return 0;
 }
 
@@ -3354,9 +3426,9 @@ static int manager_deserialize_units(Manager *m, FILE *f, FDSet *fds) {
         for (;;) {
                 _cleanup_free_ char *line = NULL;
                 /* Start marker */
-                r = read_line(f, LONG_LINE_MAX, &line);
+                r = deserialize_read_line(f, &line);
                 if (r < 0)
-                        return log_error_errno(r, "Failed to read serialization line: %m");
+                        return r;
                 if (r == 0)
                         break;
 
@@ -3537,9 +3609,9 @@ int manager_deserialize(Manager *m, FILE *f, FDSet *fds) {
                 _cleanup_free_ char *line = NULL;
                 const char *val, *l;
 
-                r = read_line(f, LONG_LINE_MAX, &line);
+                r = deserialize_read_line(f, &line);
                 if (r < 0)
-                        return log_error_errno(r, "Failed to read serialization line: %m");
+                        return r;
                 if (r == 0)
                         break;
 
@@ -3828,6 +3900,9 @@ int manager_reload(Manager *m) {
         /* Clean up deserialized tracked clients */
         m->deserialized_subscribed = strv_free(m->deserialized_subscribed);
 
+        /* All units were recreated, give back hashmap memory that is not needed anymore */
+        (void) hashmap_trim_pools();
+
         /* Consider the reload process complete now. */
         assert(m->n_reloading > 0);
         m->n_reloading--;
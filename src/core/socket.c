@@ -46,6 +46,9 @@
 #include "unit.h"
 #include "user-util.h"
 
+/* How many connections to accept on an Accept=yes socket before returning to the event loop. */
+#define SOCKET_ACCEPT_BUDGET 16U
+
 struct SocketPeer {
         unsigned n_ref;
 
@@ -2979,7 +2982,6 @@ shortcut:
 
 static int socket_dispatch_io(sd_event_source *source, int fd, uint32_t revents, void *userdata) {
         SocketPort *p = userdata;
-        int cfd = -1;
 
         assert(p);
         assert(fd >= 0);
@@ -3001,16 +3003,26 @@ static int socket_dispatch_io(sd_event_source *source, int fd, uint32_t revents,
             p->type == SOCKET_SOCKET &&
             socket_address_can_accept(&p->address)) {
 
-                cfd = socket_accept_in_cgroup(p->socket, p, fd);
-                if (cfd == -EAGAIN) /* Spurious accept() */
-                        return 0;
-                if (cfd < 0)
-                        goto fail;
+                /* Accept a couple of connections per wakeup, so that bursts are dealt with quickly. Note that
+                 * socket_enter_running() might have moved us out of the listening state (and closed our fds),
+                 * in which case we need to stop here. */
+                for (unsigned i = 0; i < SOCKET_ACCEPT_BUDGET && p->socket->state == SOCKET_LISTENING; i++) {
+                        int cfd;
+
+                        cfd = socket_accept_in_cgroup(p->socket, p, fd);
+                        if (cfd == -EAGAIN) /* Spurious accept(), or no more pending connections */
+                                return 0;
+                        if (cfd < 0)
+                                goto fail;
 
-                socket_apply_socket_options(p->socket, p, cfd);
+                        socket_apply_socket_options(p->socket, p, cfd);
+                        socket_enter_running(p->socket, cfd);
+                }
+
+                return 0;
         }
 
-        socket_enter_running(p->socket, cfd);
+        socket_enter_running(p->socket, -1);
         return 0;
 
 fail:
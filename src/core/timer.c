@@ -823,6 +823,18 @@ static void timer_reset_failed(Unit *u) {
         t->result = TIMER_SUCCESS;
 }
 
+static bool timer_has_calendar_values(Timer *t) {
+        TimerValue *v;
+
+        assert(t);
+
+        LIST_FOREACH(value, v, t->values)
+                if (v->base == TIMER_CALENDAR)
+                        return true;
+
+        return false;
+}
+
 static void timer_time_change(Unit *u) {
         Timer *t = TIMER(u);
         usec_t ts;
@@ -843,6 +855,11 @@ static void timer_time_change(Unit *u) {
         if (t->on_clock_change) {
                 log_unit_debug(u, "Time change, triggering activation.");
                 timer_enter_running(t);
+        } else if (!timer_has_calendar_values(t)) {
+                /* Purely monotonic timers are not affected by changes of the wallclock, hence don't bother
+                 * recalculating them. With many timers around that saves us a bunch of work and bus
+                 * traffic. */
+                log_unit_debug(u, "Time change, no calendar timers to recalculate.");
         } else {
                 log_unit_debug(u, "Time change, recalculating next elapse.");
                 timer_enter_waiting(t, true);
@@ -860,7 +877,9 @@ static void timer_timezone_change(Unit *u) {
         if (t->on_timezone_change) {
                 log_unit_debug(u, "Timezone change, triggering activation.");
                 timer_enter_running(t);
-        } else {
+        } else if (!timer_has_calendar_values(t))
+                log_unit_debug(u, "Timezone change, no calendar timers to recalculate.");
+        else {
                 log_unit_debug(u, "Timezone change, recalculating next elapse.");
                 timer_enter_waiting(t, false);
         }
@@ -4826,6 +4826,10 @@ static void unit_update_dependency_mask(Unit *u, UnitDependency d, Unit *other,
                 /* No bit set anymore, let's drop the whole entry */
                 assert_se(hashmap_remove(u->dependencies[d], other));
                 log_unit_debug(u, "lost dependency %s=%s", unit_dependency_to_string(d), other->id);
+
+                /* Most dependency types are empty for most units, don't keep emptied hashmaps around */
+                if (hashmap_isempty(u->dependencies[d]))
+                        u->dependencies[d] = hashmap_free(u->dependencies[d]);
         } else
                 /* Mask was reduced, let's update the entry */
                 assert_se(hashmap_update(u->dependencies[d], other, di.data) == 0);
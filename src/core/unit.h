@@ -274,6 +274,7 @@ typedef struct Unit {
         /* Where the io.stat data was at the time the unit was started */
         uint64_t io_accounting_base[_CGROUP_IO_ACCOUNTING_METRIC_MAX];
         uint64_t io_accounting_last[_CGROUP_IO_ACCOUNTING_METRIC_MAX]; /* the most recently read value */
+        usec_t io_accounting_last_usec; /* the event loop iteration io_accounting_last[] was read in */
 
         /* Counterparts in the cgroup filesystem */
         char *cgroup_path;
@@ -379,7 +379,8 @@ static int save_external_coredump(
         if (fd < 0)
                 return log_error_errno(fd, "Failed to create temporary file for coredump %s: %m", fn);
 
-        r = copy_bytes(input_fd, fd, max_size, 0);
+        /* Cores are usually full of zero pages, hence store them sparsely */
+        r = copy_bytes(input_fd, fd, max_size, COPY_HOLES);
         if (r < 0) {
                 log_error_errno(r, "Cannot store coredump of %s (%s): %m",
                                 context->meta[META_ARGV_PID], context->meta[META_COMM]);
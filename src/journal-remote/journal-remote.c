@@ -27,6 +27,9 @@
 
 #define REMOTE_JOURNAL_PATH "/var/log/journal/remote"
 
+/* Coalesce the inotify notifications for readers of the output files, like journald does */
+#define POST_CHANGE_TIMER_INTERVAL_USEC (250*USEC_PER_MSEC)
+
 #define filename_escape(s) xescape((s), "/ ")
 
 static int open_output(RemoteServer *s, Writer *w, const char* host) {
@@ -69,6 +72,10 @@ static int open_output(RemoteServer *s, Writer *w, const char* host) {
         if (r < 0)
                 return log_error_errno(r, "Failed to open output journal %s: %m", filename);
 
+        r = journal_file_enable_post_change_timer(w->journal, s->events, POST_CHANGE_TIMER_INTERVAL_USEC);
+        if (r < 0)
+                return log_error_errno(r, "Failed to enable post change timer for %s: %m", w->journal->path);
+
         log_debug("Opened output file %s", w->journal->path);
         return 0;
 }
@@ -58,8 +58,16 @@ static void close_fd_input(Uploader *u);
 
 #define SERVER_ANSWER_KEEP 2048
 
+/* How much data the read callback may produce per invocation. curl's default of 64K means a lot of trips
+ * through the callback and many small chunks on the wire when catching up with a busy journal. */
+#define UPLOAD_BUFFER_SIZE (1024L * 1024L)
+
 #define STATE_FILE "/var/lib/systemd/journal-upload/state"
 
+/* Write the state file at most this often. Another upload finishing in between only marks the state as
+ * dirty, and it is written out once the interval has passed, or when we exit. */
+#define STATE_SAVE_INTERVAL_USEC (1 * USEC_PER_SEC)
+
 #define easy_setopt(curl, opt, value, level, cmd)                       \
         do {                                                            \
                 code = curl_easy_setopt(curl, opt, value);              \
@@ -116,13 +124,16 @@ static int check_cursor_updating(Uploader *u) {
         return 0;
 }
 
-static int update_cursor_state(Uploader *u) {
+static int save_cursor_state(Uploader *u) {
         _cleanup_free_ char *temp_path = NULL;
         _cleanup_fclose_ FILE *f = NULL;
         int r;
 
-        if (!u->state_file || !u->last_cursor)
-                return 0;
+        assert(u);
+        assert(u->state_file);
+        assert(u->last_cursor);
+
+        u->state_dirty = false;
 
         r = fopen_temporary(u->state_file, &f, &temp_path);
         if (r < 0)
@@ -153,6 +164,67 @@ fail:
         return log_error_errno(r, "Failed to save state %s: %m", u->state_file);
 }
 
+static int dispatch_save_state(sd_event_source *s, uint64_t usec, void *userdata);
+
+static int arm_save_state_timer(Uploader *u) {
+        int r;
+
+        assert(u);
+
+        if (!u->save_state_event)
+                return sd_event_add_time_relative(u->events, &u->save_state_event, CLOCK_MONOTONIC,
+                                                  STATE_SAVE_INTERVAL_USEC, 0,
+                                                  dispatch_save_state, u);
+
+        r = sd_event_source_set_time_relative(u->save_state_event, STATE_SAVE_INTERVAL_USEC);
+        if (r < 0)
+                return r;
+
+        return sd_event_source_set_enabled(u->save_state_event, SD_EVENT_ONESHOT);
+}
+
+static int dispatch_save_state(sd_event_source *s, uint64_t usec, void *userdata) {
+        Uploader *u = userdata;
+        int r;
+
+        assert(u);
+
+        if (!u->state_dirty)
+                return 0;
+
+        r = save_cursor_state(u);
+
+        /* Keep rate limiting for as long as uploads keep coming in. */
+        if (arm_save_state_timer(u) < 0)
+                log_warning("Failed to arm state saving timer, ignoring.");
+
+        return r;
+}
+
+static int update_cursor_state(Uploader *u) {
+        int enabled = SD_EVENT_OFF, r;
+
+        assert(u);
+
+        if (!u->state_file || !u->last_cursor)
+                return 0;
+
+        if (u->save_state_event)
+                (void) sd_event_source_get_enabled(u->save_state_event, &enabled);
+        if (enabled != SD_EVENT_OFF) {
+                /* We saved the state only recently, defer this until the timer fires. */
+                u->state_dirty = true;
+                return 0;
+        }
+
+        r = save_cursor_state(u);
+
+        if (arm_save_state_timer(u) < 0)
+                log_warning("Failed to arm state saving timer, ignoring.");
+
+        return r;
+}
+
 static int load_cursor_state(Uploader *u) {
         int r;
 
@@ -232,6 +304,11 @@ int start_upload(Uploader *u,
                 easy_setopt(curl, CURLOPT_READDATA, data,
                             LOG_ERR, return -EXFULL);
 
+#if LIBCURL_VERSION_NUM >= 0x073e00
+                easy_setopt(curl, CURLOPT_UPLOAD_BUFFERSIZE, UPLOAD_BUFFER_SIZE,
+                            LOG_WARNING, );
+#endif
+
                 /* use our special own mime type and chunked transfer */
                 easy_setopt(curl, CURLOPT_HTTPHEADER, u->header,
                             LOG_ERR, return -EXFULL);
@@ -463,6 +540,10 @@ static void destroy_uploader(Uploader *u) {
         curl_slist_free_all(u->header);
         free(u->answer);
 
+        if (u->state_dirty)
+                (void) save_cursor_state(u);
+        u->save_state_event = sd_event_source_unref(u->save_state_event);
+
         free(u->last_cursor);
         free(u->current_cursor);
 
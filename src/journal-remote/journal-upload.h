@@ -52,6 +52,8 @@ typedef struct Uploader {
 
         size_t entries_sent;
         char *last_cursor, *current_cursor;
+        sd_event_source *save_state_event;
+        bool state_dirty;
         usec_t watchdog_timestamp;
         usec_t watchdog_usec;
 } Uploader;
@@ -2363,7 +2363,7 @@ int main(int argc, char *argv[]) {
                 HASHMAP_FOREACH(d, j->directories_by_path) {
                         int q;
 
-                        q = journal_directory_vacuum(d->path, arg_vacuum_size, arg_vacuum_n_files, arg_vacuum_time, NULL, !arg_quiet);
+                        q = journal_directory_vacuum(d->path, arg_vacuum_size, arg_vacuum_n_files, arg_vacuum_time, NULL, NULL, !arg_quiet);
                         if (q < 0)
                                 r = log_error_errno(q, "Failed to vacuum %s: %m", d->path);
                 }
@@ -19,6 +19,7 @@
 #include "process-util.h"
 #include "procfs-util.h"
 #include "string-util.h"
+#include "stdio-util.h"
 #include "syslog-util.h"
 #include "unaligned.h"
 #include "user-util.h"
@@ -179,6 +180,9 @@ static void client_context_reset(Server *s, ClientContext *c) {
 
         c->log_ratelimit_interval = s->ratelimit_interval;
         c->log_ratelimit_burst = s->ratelimit_burst;
+
+        iovw_free_contents(&c->meta_fields, true);
+        iovw_free_contents(&c->object_fields, true);
 }
 
 static ClientContext* client_context_free(Server *s, ClientContext *c) {
@@ -500,6 +504,114 @@ static int client_context_read_log_ratelimit_burst(ClientContext *c) {
         return safe_atou(value, &c->log_ratelimit_burst);
 }
 
+static int client_context_put_fields(const ClientContext *c, const char *prefix, struct iovec_wrapper *w) {
+        char buf[DECIMAL_STR_MAX(uint64_t)];
+        int r;
+
+        assert(c);
+        assert(prefix);
+        assert(w);
+
+#define PUT_STRING(field, value)                                        \
+        do {                                                            \
+                if (!isempty(value)) {                                  \
+                        _cleanup_free_ char *_x = strjoin(prefix, field "=", value); \
+                        if (!_x)                                        \
+                                return -ENOMEM;                         \
+                        r = iovw_put(w, _x, strlen(_x));                \
+                        if (r < 0)                                      \
+                                return r;                               \
+                        TAKE_PTR(_x);                                   \
+                }                                                       \
+        } while (false)
+
+#define PUT_NUMERIC(field, value, isset, format)                        \
+        do {                                                            \
+                if (isset(value)) {                                     \
+                        xsprintf(buf, format, value);                   \
+                        PUT_STRING(field, buf);                         \
+                }                                                       \
+        } while (false)
+
+        PUT_NUMERIC("PID", c->pid, pid_is_valid, PID_FMT);
+        PUT_NUMERIC("UID", c->uid, uid_is_valid, UID_FMT);
+        PUT_NUMERIC("GID", c->gid, gid_is_valid, GID_FMT);
+
+        PUT_STRING("COMM", c->comm);
+        PUT_STRING("EXE", c->exe);
+        PUT_STRING("CMDLINE", c->cmdline);
+        PUT_STRING("CAP_EFFECTIVE", c->capeff);
+
+        if (c->label_size > 0) {
+                /* The label is not necessarily NUL-free, hence copy it by size, the way we got it */
+                _cleanup_free_ char *x = NULL;
+                size_t l = strlen(prefix) + STRLEN("SELINUX_CONTEXT=");
+
+                x = malloc(l + c->label_size + 1);
+                if (!x)
+                        return -ENOMEM;
+
+                *((char*) mempcpy(stpcpy(stpcpy(x, prefix), "SELINUX_CONTEXT="), c->label, c->label_size)) = 0;
+
+                r = iovw_put(w, x, l + c->label_size);
+                if (r < 0)
+                        return r;
+                TAKE_PTR(x);
+        }
+
+        PUT_NUMERIC("AUDIT_SESSION", c->auditid, audit_session_is_valid, "%" PRIu32);
+        PUT_NUMERIC("AUDIT_LOGINUID", c->loginuid, uid_is_valid, UID_FMT);
+
+        PUT_STRING("SYSTEMD_CGROUP", c->cgroup);
+        PUT_STRING("SYSTEMD_SESSION", c->session);
+        PUT_NUMERIC("SYSTEMD_OWNER_UID", c->owner_uid, uid_is_valid, UID_FMT);
+        PUT_STRING("SYSTEMD_UNIT", c->unit);
+        PUT_STRING("SYSTEMD_USER_UNIT", c->user_unit);
+        PUT_STRING("SYSTEMD_SLICE", c->slice);
+        PUT_STRING("SYSTEMD_USER_SLICE", c->user_slice);
+
+        if (!sd_id128_is_null(c->invocation_id)) {
+                char ids[SD_ID128_STRING_MAX];
+
+                PUT_STRING("SYSTEMD_INVOCATION_ID", sd_id128_to_string(c->invocation_id, ids));
+        }
+
+#undef PUT_NUMERIC
+#undef PUT_STRING
+
+        assert(w->count <= N_IOVEC_OBJECT_FIELDS);
+        return 0;
+}
+
+static int client_context_build_fields(const ClientContext *c, const char *prefix, struct iovec_wrapper *w) {
+        int r;
+
+        assert(w);
+
+        /* Formats the metadata of this context as a ready-to-use set of journal fields. This is done once
+         * per refresh rather than for every message logged by the client. */
+
+        iovw_free_contents(w, true);
+
+        r = client_context_put_fields(c, prefix, w);
+        if (r < 0) {
+                iovw_free_contents(w, true);
+                return log_debug_errno(r, "Failed to format metadata fields of client " PID_FMT ": %m", c->pid);
+        }
+
+        return 0;
+}
+
+const struct iovec_wrapper* client_context_object_fields(ClientContext *c) {
+        assert(c);
+
+        /* Only few clients log about other processes, hence the OBJECT_ variant is built on first use. */
+        if (c->object_fields.count == 0)
+                (void) client_context_build_fields(c, "OBJECT_", &c->object_fields);
+
+        return &c->object_fields;
+}
+
 static void client_context_really_refresh(
                 Server *s,
                 ClientContext *c,
@@ -529,6 +641,9 @@ static void client_context_really_refresh(
         (void) client_context_read_log_ratelimit_interval(c);
         (void) client_context_read_log_ratelimit_burst(c);
 
+        (void) client_context_build_fields(c, "_", &c->meta_fields);
+        iovw_free_contents(&c->object_fields, true);
+
         c->timestamp = timestamp;
 
         if (c->in_lru) {
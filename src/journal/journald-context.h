@@ -7,6 +7,7 @@
 
 #include "sd-id128.h"
 
+#include "io-util.h"
 #include "time-util.h"
 
 typedef struct ClientContext ClientContext;
@@ -55,6 +56,10 @@ struct ClientContext {
 
         usec_t log_ratelimit_interval;
         unsigned log_ratelimit_burst;
+
+        /* The fields above, formatted as _PID=, _UID=, … (and OBJECT_PID=, …) journal fields */
+        struct iovec_wrapper meta_fields;
+        struct iovec_wrapper object_fields;
 };
 
 int client_context_get(
@@ -83,6 +88,8 @@ void client_context_maybe_refresh(
                 const char *unit_id,
                 usec_t tstamp);
 
+const struct iovec_wrapper* client_context_object_fields(ClientContext *c);
+
 void client_context_acquire_default(Server *s);
 void client_context_flush_all(Server *s);
 
@@ -24,6 +24,9 @@
 #include "stdio-util.h"
 #include "string-util.h"
 
+/* How many records to read from /dev/kmsg at most per event loop iteration */
+#define DEV_KMSG_READ_MAX 64U
+
 void server_forward_kmsg(
                 Server *s,
                 int priority,
@@ -350,6 +353,7 @@ int server_flush_dev_kmsg(Server *s) {
 
 static int dispatch_dev_kmsg(sd_event_source *es, int fd, uint32_t revents, void *userdata) {
         Server *s = userdata;
+        int r;
 
         assert(es);
         assert(fd == s->dev_kmsg_fd);
@@ -361,7 +365,15 @@ static int dispatch_dev_kmsg(sd_event_source *es, int fd, uint32_t revents, void
         if (!(revents & EPOLLIN))
                 log_error("Got invalid event from epoll for /dev/kmsg: %"PRIx32, revents);
 
-        return server_read_dev_kmsg(s);
+        /* The kernel hands out one record per read(), hence process a bunch of them per wakeup, so that
+         * we keep up during bursts. But don't process too many, so that other sources get their turn. */
+        for (unsigned i = 0; i < DEV_KMSG_READ_MAX; i++) {
+                r = server_read_dev_kmsg(s);
+                if (r <= 0)
+                        return r;
+        }
+
+        return 0;
 }
 
 int server_open_dev_kmsg(Server *s) {
@@ -19,6 +19,7 @@
 #include "cgroup-util.h"
 #include "conf-parser.h"
 #include "dirent-util.h"
+#include "event-util.h"
 #include "extract-word.h"
 #include "fd-util.h"
 #include "fileio.h"
@@ -130,16 +131,33 @@ static void cache_space_invalidate(JournalStorageSpace *space) {
         zero(*space);
 }
 
-static int cache_space_refresh(Server *s, JournalStorage *storage) {
+static void cache_space_update(JournalStorage *storage, uint64_t vfs_used, uint64_t vfs_avail) {
         JournalStorageSpace *space;
         JournalMetrics *metrics;
-        uint64_t vfs_used, vfs_avail, avail;
+        uint64_t avail;
+
+        assert(storage);
+
+        metrics = &storage->metrics;
+        space = &storage->space;
+
+        space->vfs_used = vfs_used;
+        space->vfs_available = vfs_avail;
+
+        avail = LESS_BY(vfs_avail, metrics->keep_free);
+
+        space->limit = MIN(MAX(vfs_used + avail, metrics->min_use), metrics->max_use);
+        space->available = LESS_BY(space->limit, vfs_used);
+}
+
+static int cache_space_refresh(Server *s, JournalStorage *storage) {
+        JournalStorageSpace *space;
+        uint64_t vfs_used, vfs_avail;
         usec_t ts;
         int r;
 
         assert(s);
 
-        metrics = &storage->metrics;
         space = &storage->space;
 
         ts = now(CLOCK_MONOTONIC);
@@ -151,13 +169,7 @@ static int cache_space_refresh(Server *s, JournalStorage *storage) {
         if (r < 0)
                 return r;
 
-        space->vfs_used = vfs_used;
-        space->vfs_available = vfs_avail;
-
-        avail = LESS_BY(vfs_avail, metrics->keep_free);
-
-        space->limit = MIN(MAX(vfs_used + avail, metrics->min_use), metrics->max_use);
-        space->available = LESS_BY(space->limit, vfs_used);
+        cache_space_update(storage, vfs_used, vfs_avail);
         space->timestamp = ts;
         return 1;
 }
@@ -663,6 +675,7 @@ void server_sync(Server *s) {
 
 static void do_vacuum(Server *s, JournalStorage *storage, bool verbose) {
 
+        uint64_t freed = 0;
         int r;
 
         assert(s);
@@ -675,11 +688,20 @@ static void do_vacuum(Server *s, JournalStorage *storage, bool verbose) {
 
         r = journal_directory_vacuum(storage->path, storage->space.limit,
                                      storage->metrics.n_max_files, s->max_retention_usec,
-                                     &s->oldest_file_usec, verbose);
-        if (r < 0 && r != -ENOENT)
+                                     &s->oldest_file_usec, &freed, verbose);
+        if (r < 0 && r != -ENOENT) {
                 log_warning_errno(r, "Failed to vacuum %s, ignoring: %m", storage->path);
+                cache_space_invalidate(&storage->space);
+                return;
+        }
 
-        cache_space_invalidate(&storage->space);
+        /* Rather than rescanning the whole directory on the next space check, account for what we just
+         * deleted. Vacuuming only removes archived files, and we know their sizes. The cached data still
+         * expires after RECHECK_SPACE_USEC as usual. */
+        if (storage->space.timestamp != 0)
+                cache_space_update(storage,
+                                   LESS_BY(storage->space.vfs_used, freed),
+                                   storage->space.vfs_available + freed);
 }
 
 int server_vacuum(Server *s, bool verbose) {
@@ -863,37 +885,6 @@ static void write_to_journal(Server *s, uid_t uid, struct iovec *iovec, size_t n
                 server_schedule_sync(s, priority);
 }
 
-#define IOVEC_ADD_NUMERIC_FIELD(iovec, n, value, type, isset, format, field)  \
-        if (isset(value)) {                                             \
-                char *k;                                                \
-                k = newa(char, STRLEN(field "=") + DECIMAL_STR_MAX(type) + 1); \
-                sprintf(k, field "=" format, value);                    \
-                iovec[n++] = IOVEC_MAKE_STRING(k);                      \
-        }
-
-#define IOVEC_ADD_STRING_FIELD(iovec, n, value, field)                  \
-        if (!isempty(value)) {                                          \
-                char *k;                                                \
-                k = strjoina(field "=", value);                         \
-                iovec[n++] = IOVEC_MAKE_STRING(k);                      \
-        }
-
-#define IOVEC_ADD_ID128_FIELD(iovec, n, value, field)                   \
-        if (!sd_id128_is_null(value)) {                                 \
-                char *k;                                                \
-                k = newa(char, STRLEN(field "=") + SD_ID128_STRING_MAX); \
-                sd_id128_to_string(value, stpcpy(k, field "="));        \
-                iovec[n++] = IOVEC_MAKE_STRING(k);                      \
-        }
-
-#define IOVEC_ADD_SIZED_FIELD(iovec, n, value, value_size, field)       \
-        if (value_size > 0) {                                           \
-                char *k;                                                \
-                k = newa(char, STRLEN(field "=") + value_size + 1);     \
-                *((char*) mempcpy(stpcpy(k, field "="), value, value_size)) = 0; \
-                iovec[n++] = IOVEC_MAKE_STRING(k);                      \
-        }                                                               \
-
 static void dispatch_message_real(
                 Server *s,
                 struct iovec *iovec, size_t n, size_t m,
@@ -903,9 +894,8 @@ static void dispatch_message_real(
                 pid_t object_pid) {
 
         char source_time[sizeof("_SOURCE_REALTIME_TIMESTAMP=") + DECIMAL_STR_MAX(usec_t)];
-        _cleanup_free_ char *cmdline1 = NULL, *cmdline2 = NULL;
+        ClientContext *o = NULL, *pinned = NULL;
         uid_t journal_uid;
-        ClientContext *o;
 
         assert(s);
         assert(iovec);
@@ -915,33 +905,20 @@ static void dispatch_message_real(
                (pid_is_valid(object_pid) ? N_IOVEC_OBJECT_FIELDS : 0) +
                client_context_extra_fields_n_iovec(c) <= m);
 
-        if (c) {
-                IOVEC_ADD_NUMERIC_FIELD(iovec, n, c->pid, pid_t, pid_is_valid, PID_FMT, "_PID");
-                IOVEC_ADD_NUMERIC_FIELD(iovec, n, c->uid, uid_t, uid_is_valid, UID_FMT, "_UID");
-                IOVEC_ADD_NUMERIC_FIELD(iovec, n, c->gid, gid_t, gid_is_valid, GID_FMT, "_GID");
+        /* The iovecs copied below point into the cached fields of the contexts. Looking up the object
+         * context may refresh or evict cached contexts, including the client's own one, hence do that first
+         * and pin both until the entry is written. */
+        if (pid_is_valid(object_pid)) {
+                if (c)
+                        (void) client_context_acquire(s, c->pid, NULL, NULL, 0, NULL, &pinned);
 
-                IOVEC_ADD_STRING_FIELD(iovec, n, c->comm, "_COMM"); /* At most TASK_COMM_LENGTH (16 bytes) */
-                IOVEC_ADD_STRING_FIELD(iovec, n, c->exe, "_EXE"); /* A path, so at most PATH_MAX (4096 bytes) */
-
-                if (c->cmdline)
-                        /* At most _SC_ARG_MAX (2MB usually), which is too much to put on stack.
-                         * Let's use a heap allocation for this one. */
-                        cmdline1 = set_iovec_string_field(iovec, &n, "_CMDLINE=", c->cmdline);
-
-                IOVEC_ADD_STRING_FIELD(iovec, n, c->capeff, "_CAP_EFFECTIVE"); /* Read from /proc/.../status */
-                IOVEC_ADD_SIZED_FIELD(iovec, n, c->label, c->label_size, "_SELINUX_CONTEXT");
-                IOVEC_ADD_NUMERIC_FIELD(iovec, n, c->auditid, uint32_t, audit_session_is_valid, "%" PRIu32, "_AUDIT_SESSION");
-                IOVEC_ADD_NUMERIC_FIELD(iovec, n, c->loginuid, uid_t, uid_is_valid, UID_FMT, "_AUDIT_LOGINUID");
-
-                IOVEC_ADD_STRING_FIELD(iovec, n, c->cgroup, "_SYSTEMD_CGROUP"); /* A path */
-                IOVEC_ADD_STRING_FIELD(iovec, n, c->session, "_SYSTEMD_SESSION");
-                IOVEC_ADD_NUMERIC_FIELD(iovec, n, c->owner_uid, uid_t, uid_is_valid, UID_FMT, "_SYSTEMD_OWNER_UID");
-                IOVEC_ADD_STRING_FIELD(iovec, n, c->unit, "_SYSTEMD_UNIT"); /* Unit names are bounded by UNIT_NAME_MAX */
-                IOVEC_ADD_STRING_FIELD(iovec, n, c->user_unit, "_SYSTEMD_USER_UNIT");
-                IOVEC_ADD_STRING_FIELD(iovec, n, c->slice, "_SYSTEMD_SLICE");
-                IOVEC_ADD_STRING_FIELD(iovec, n, c->user_slice, "_SYSTEMD_USER_SLICE");
+                if (client_context_acquire(s, object_pid, NULL, NULL, 0, NULL, &o) < 0)
+                        o = NULL;
+        }
 
-                IOVEC_ADD_ID128_FIELD(iovec, n, c->invocation_id, "_SYSTEMD_INVOCATION_ID");
+        if (c) {
+                memcpy_safe(iovec + n, c->meta_fields.iovec, c->meta_fields.count * sizeof(struct iovec));
+                n += c->meta_fields.count;
 
                 if (c->extra_fields_n_iovec > 0) {
                         memcpy(iovec + n, c->extra_fields_iovec, c->extra_fields_n_iovec * sizeof(struct iovec));
@@ -951,32 +928,12 @@ static void dispatch_message_real(
 
         assert(n <= m);
 
-        if (pid_is_valid(object_pid) && client_context_get(s, object_pid, NULL, NULL, 0, NULL, &o) >= 0) {
-
-                IOVEC_ADD_NUMERIC_FIELD(iovec, n, o->pid, pid_t, pid_is_valid, PID_FMT, "OBJECT_PID");
-                IOVEC_ADD_NUMERIC_FIELD(iovec, n, o->uid, uid_t, uid_is_valid, UID_FMT, "OBJECT_UID");
-                IOVEC_ADD_NUMERIC_FIELD(iovec, n, o->gid, gid_t, gid_is_valid, GID_FMT, "OBJECT_GID");
+        if (o) {
+                const struct iovec_wrapper *w;
 
-                /* See above for size limits, only ->cmdline may be large, so use a heap allocation for it. */
-                IOVEC_ADD_STRING_FIELD(iovec, n, o->comm, "OBJECT_COMM");
-                IOVEC_ADD_STRING_FIELD(iovec, n, o->exe, "OBJECT_EXE");
-                if (o->cmdline)
-                        cmdline2 = set_iovec_string_field(iovec, &n, "OBJECT_CMDLINE=", o->cmdline);
-
-                IOVEC_ADD_STRING_FIELD(iovec, n, o->capeff, "OBJECT_CAP_EFFECTIVE");
-                IOVEC_ADD_SIZED_FIELD(iovec, n, o->label, o->label_size, "OBJECT_SELINUX_CONTEXT");
-                IOVEC_ADD_NUMERIC_FIELD(iovec, n, o->auditid, uint32_t, audit_session_is_valid, "%" PRIu32, "OBJECT_AUDIT_SESSION");
-                IOVEC_ADD_NUMERIC_FIELD(iovec, n, o->loginuid, uid_t, uid_is_valid, UID_FMT, "OBJECT_AUDIT_LOGINUID");
-
-                IOVEC_ADD_STRING_FIELD(iovec, n, o->cgroup, "OBJECT_SYSTEMD_CGROUP");
-                IOVEC_ADD_STRING_FIELD(iovec, n, o->session, "OBJECT_SYSTEMD_SESSION");
-                IOVEC_ADD_NUMERIC_FIELD(iovec, n, o->owner_uid, uid_t, uid_is_valid, UID_FMT, "OBJECT_SYSTEMD_OWNER_UID");
-                IOVEC_ADD_STRING_FIELD(iovec, n, o->unit, "OBJECT_SYSTEMD_UNIT");
-                IOVEC_ADD_STRING_FIELD(iovec, n, o->user_unit, "OBJECT_SYSTEMD_USER_UNIT");
-                IOVEC_ADD_STRING_FIELD(iovec, n, o->slice, "OBJECT_SYSTEMD_SLICE");
-                IOVEC_ADD_STRING_FIELD(iovec, n, o->user_slice, "OBJECT_SYSTEMD_USER_SLICE");
-
-                IOVEC_ADD_ID128_FIELD(iovec, n, o->invocation_id, "OBJECT_SYSTEMD_INVOCATION_ID=");
+                w = client_context_object_fields(o);
+                memcpy_safe(iovec + n, w->iovec, w->count * sizeof(struct iovec));
+                n += w->count;
         }
 
         assert(n <= m);
@@ -1017,6 +974,9 @@ static void dispatch_message_real(
                 journal_uid = 0;
 
         write_to_journal(s, journal_uid, iovec, n, priority);
+
+        client_context_release(s, o);
+        client_context_release(s, pinned);
 }
 
 void server_driver_message(Server *s, pid_t object_pid, const char *message_id, const char *format, ...) {
@@ -2270,6 +2230,10 @@ int server_init(Server *s, const char *namespace) {
         if (r < 0)
                 return log_error_errno(r, "Failed to create event loop: %m");
 
+        /* The native, syslog and stdout sources share one priority. When many clients log at once, dispatch
+         * all of them that are ready in one go, instead of going through epoll_wait() again for each. */
+        (void) event_set_dispatch_batch(s->event, true);
+
         n = sd_listen_fds(true);
         if (n < 0)
                 return log_error_errno(n, "Failed to read listening file descriptors from environment: %m");
@@ -256,7 +256,7 @@ static int stdout_stream_log(
         int priority;
         char syslog_priority[] = "PRIORITY=\0";
         char syslog_facility[STRLEN("SYSLOG_FACILITY=") + DECIMAL_STR_MAX(int) + 1];
-        _cleanup_free_ char *message = NULL, *syslog_identifier = NULL;
+        _cleanup_free_ char *message = NULL;
         size_t n = 0, m;
         int r;
 
@@ -311,10 +311,13 @@ static int stdout_stream_log(
                 iovec[n++] = IOVEC_MAKE_STRING(syslog_facility);
         }
 
+        /* The identifier was bounded by the setup protocol's line length, no need to go through the heap
+         * for every single line */
         if (s->identifier) {
-                syslog_identifier = strjoin("SYSLOG_IDENTIFIER=", s->identifier);
-                if (syslog_identifier)
-                        iovec[n++] = IOVEC_MAKE_STRING(syslog_identifier);
+                const char *a;
+
+                a = strjoina("SYSLOG_IDENTIFIER=", s->identifier);
+                iovec[n++] = IOVEC_MAKE_STRING(a);
         }
 
         static const char * const line_break_field_table[_LINE_BREAK_MAX] = {
@@ -553,9 +556,10 @@ static int stdout_stream_scan(
 static int stdout_stream_process(sd_event_source *es, int fd, uint32_t revents, void *userdata) {
         CMSG_BUFFER_TYPE(CMSG_SPACE(sizeof(struct ucred))) control;
         StdoutStream *s = userdata;
-        size_t limit, consumed;
+        size_t limit, line_max, consumed;
         struct ucred *ucred;
         struct iovec iovec;
+        bool filled;
         ssize_t l;
         char *p;
         int r;
@@ -584,7 +588,8 @@ static int stdout_stream_process(sd_event_source *es, int fd, uint32_t revents,
 
         /* Try to make use of the allocated buffer in full, but never read more than the configured line size. Also,
          * always leave room for a terminating NUL we might need to add. */
-        limit = MIN(s->allocated - 1, MAX(s->server->line_max, STDOUT_STREAM_SETUP_PROTOCOL_LINE_MAX));
+        line_max = MAX(s->server->line_max, STDOUT_STREAM_SETUP_PROTOCOL_LINE_MAX);
+        limit = MIN(s->allocated - 1, line_max);
         assert(s->length <= limit);
         iovec = IOVEC_MAKE(s->buffer + s->length, limit - s->length);
 
@@ -598,6 +603,8 @@ static int stdout_stream_process(sd_event_source *es, int fd, uint32_t revents,
         }
         cmsg_close_all(&msghdr);
 
+        filled = (size_t) l == iovec.iov_len;
+
         if (l == 0) {
                 (void) stdout_stream_scan(s, s->buffer, s->length, /* force_flush = */ LINE_BREAK_EOF, NULL);
                 goto terminate;
@@ -635,6 +642,12 @@ static int stdout_stream_process(sd_event_source *es, int fd, uint32_t revents,
         s->length = l - consumed;
         memmove(s->buffer, p + consumed, s->length);
 
+        /* If this read filled up the buffer the writer is likely faster than us. In that case grow the buffer
+         * (but never beyond what we'd read at once anyway), so that it takes fewer wakeups and reads to
+         * catch up. Streams that log the occasional line stay small. */
+        if (filled && s->allocated - 1 < line_max)
+                (void) GREEDY_REALLOC(s->buffer, s->allocated, MIN(s->allocated * 2, line_max + 1));
+
         return 1;
 
 terminate:
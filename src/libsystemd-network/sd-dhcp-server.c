@@ -23,6 +23,9 @@
 #define DHCP_DEFAULT_LEASE_TIME_USEC USEC_PER_HOUR
 #define DHCP_MAX_LEASE_TIME_USEC (USEC_PER_HOUR*12)
 
+/* How many datagrams to read from the socket at most per event loop iteration */
+#define DHCP_SERVER_RECV_BATCH_MAX 16U
+
 static DHCPLease *dhcp_lease_free(DHCPLease *lease) {
         if (!lease)
                 return NULL;
@@ -921,11 +924,9 @@ int dhcp_server_handle_message(sd_dhcp_server *server, DHCPMessage *message,
         return 0;
 }
 
-static int server_receive_message(sd_event_source *s, int fd,
-                                  uint32_t revents, void *userdata) {
+static int server_receive_message_one(sd_dhcp_server *server, int fd) {
         _cleanup_free_ DHCPMessage *message = NULL;
         CMSG_BUFFER_TYPE(CMSG_SPACE(sizeof(struct in_pktinfo))) control;
-        sd_dhcp_server *server = userdata;
         struct iovec iov = {};
         struct msghdr msg = {
                 .msg_iov = &iov,
@@ -940,6 +941,8 @@ static int server_receive_message(sd_event_source *s, int fd,
         assert(server);
 
         buflen = next_datagram_size_fd(fd);
+        if (IN_SET(buflen, -EAGAIN, -EINTR))
+                return 0;
         if (buflen < 0)
                 return buflen;
 
@@ -955,7 +958,7 @@ static int server_receive_message(sd_event_source *s, int fd,
         if (len < 0)
                 return len;
         if ((size_t) len < sizeof(DHCPMessage))
-                return 0;
+                return 1;
 
         CMSG_FOREACH(cmsg, &msg) {
                 if (cmsg->cmsg_level == IPPROTO_IP &&
@@ -966,7 +969,7 @@ static int server_receive_message(sd_event_source *s, int fd,
                         /* TODO figure out if this can be done as a filter on
                          * the socket, like for IPv6 */
                         if (server->ifindex != info->ipi_ifindex)
-                                return 0;
+                                return 1;
 
                         break;
                 }
@@ -976,6 +979,29 @@ static int server_receive_message(sd_event_source *s, int fd,
         if (r < 0)
                 log_dhcp_server_errno(server, r, "Couldn't process incoming message: %m");
 
+        return 1;
+}
+
+static int server_receive_message(sd_event_source *s, int fd,
+                                  uint32_t revents, void *userdata) {
+        _cleanup_(sd_dhcp_server_unrefp) sd_dhcp_server *server = sd_dhcp_server_ref(userdata);
+        int r;
+
+        assert(server);
+
+        /* When many clients boot at the same time, handle a few of the queued requests per wakeup rather
+         * than going through the event loop for each of them. */
+
+        for (unsigned n = 0; n < DHCP_SERVER_RECV_BATCH_MAX; n++) {
+                r = server_receive_message_one(server, fd);
+                if (r <= 0)
+                        return r;
+
+                /* The callback might have stopped the server. */
+                if (server->fd != fd)
+                        break;
+        }
+
         return 0;
 }
 
@@ -3,10 +3,12 @@
 #include <unistd.h>
 #include <sys/types.h>
 
+#include "bus-creds.h"
 #include "bus-internal.h"
 #include "bus-message.h"
 #include "bus-signature.h"
 #include "bus-type.h"
+#include "hashmap.h"
 #include "string-util.h"
 
 _public_ int sd_bus_message_send(sd_bus_message *reply) {
@@ -610,6 +612,97 @@ _public_ int sd_bus_set_property(
         return r;
 }
 
+/* The credentials the broker reports for a peer are recorded when it connects and never change, and unique
+ * names are never reused. Hence remember them per sender, so that privileged method calls don't need a
+ * synchronous round trip to the broker each. Data augmented from /proc is never cached, it might change. */
+#define SENDER_CREDS_CACHE_MAX 64U
+
+typedef struct SenderCreds {
+        char *sender;
+        uint64_t mask; /* What was asked for, which might be more than what we got */
+        sd_bus_creds *creds;
+} SenderCreds;
+
+static SenderCreds* sender_creds_free(SenderCreds *s) {
+        if (!s)
+                return NULL;
+
+        free(s->sender);
+        sd_bus_creds_unref(s->creds);
+
+        return mfree(s);
+}
+
+DEFINE_TRIVIAL_CLEANUP_FUNC(SenderCreds*, sender_creds_free);
+
+DEFINE_PRIVATE_HASH_OPS_WITH_VALUE_DESTRUCTOR(sender_creds_hash_ops, char, string_hash_func, string_compare_func,
+                                              SenderCreds, sender_creds_free);
+
+static void sender_creds_remember(sd_bus *bus, const char *sender, uint64_t mask, sd_bus_creds *c) {
+        _cleanup_(sender_creds_freep) SenderCreds *s = NULL;
+
+        assert(bus);
+        assert(sender);
+        assert(c);
+
+        if (c->augmented != 0)
+                return;
+
+        if (hashmap_size(bus->sender_creds) >= SENDER_CREDS_CACHE_MAX)
+                hashmap_clear(bus->sender_creds);
+        else
+                sender_creds_free(hashmap_remove(bus->sender_creds, sender));
+
+        s = new(SenderCreds, 1);
+        if (!s)
+                return;
+
+        *s = (SenderCreds) {
+                .sender = strdup(sender),
+                .mask = mask,
+                .creds = sd_bus_creds_ref(c),
+        };
+        if (!s->sender)
+                return;
+
+        /* This is just a cache, ignore failures */
+        if (hashmap_ensure_put(&bus->sender_creds, &sender_creds_hash_ops, s->sender, s) >= 0)
+                TAKE_PTR(s);
+}
+
+static int sender_get_creds(sd_bus *bus, const char *sender, uint64_t mask, sd_bus_creds **ret) {
+        _cleanup_(sd_bus_creds_unrefp) sd_bus_creds *c = NULL;
+        SenderCreds *s;
+        int r;
+
+        assert(bus);
+        assert(sender);
+        assert(ret);
+
+        if (!bus->bus_client || sender[0] != ':' || (mask & SD_BUS_CREDS_AUGMENT))
+                return sd_bus_get_name_creds(bus, sender, mask, ret);
+
+        s = hashmap_get(bus->sender_creds, sender);
+        if (s) {
+                if ((mask & ~s->mask) == 0) {
+                        *ret = sd_bus_creds_ref(s->creds);
+                        return 0;
+                }
+
+                /* Callers often ask for different fields one after the other, get everything at once */
+                mask |= s->mask;
+        }
+
+        r = sd_bus_get_name_creds(bus, sender, mask, &c);
+        if (r < 0)
+                return r;
+
+        sender_creds_remember(bus, sender, mask, c);
+
+        *ret = TAKE_PTR(c);
+        return 0;
+}
+
 _public_ int sd_bus_query_sender_creds(sd_bus_message *call, uint64_t mask, sd_bus_creds **ret) {
         sd_bus_creds *c;
         int r;
@@ -638,7 +731,7 @@ _public_ int sd_bus_query_sender_creds(sd_bus_message *call, uint64_t mask, sd_b
 
                 if (call->sender)
                         /* There's a sender, but the creds are missing. */
-                        return sd_bus_get_name_creds(call->bus, call->sender, mask, ret);
+                        return sender_get_creds(call->bus, call->sender, mask, ret);
                 else
                         /* There's no sender. For direct connections
                          * the credentials of the AF_UNIX peer matter,
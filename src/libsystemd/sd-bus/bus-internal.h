@@ -271,6 +271,9 @@ struct sd_bus {
 
         uint64_t creds_mask;
 
+        /* Broker supplied credentials of the senders of recent method calls, by unique name */
+        Hashmap *sender_creds;
+
         int *fds;
         size_t n_fds;
 
@@ -51,10 +51,16 @@ static bool BUS_MATCH_IS_COMPARE(enum bus_match_node_type t) {
         return t >= BUS_MATCH_SENDER && t <= BUS_MATCH_ARG_HAS_LAST;
 }
 
+static bool BUS_MATCH_IS_NAMESPACE(enum bus_match_node_type t) {
+        return t == BUS_MATCH_PATH_NAMESPACE ||
+                (t >= BUS_MATCH_ARG_NAMESPACE && t <= BUS_MATCH_ARG_NAMESPACE_LAST);
+}
+
 static bool BUS_MATCH_CAN_HASH(enum bus_match_node_type t) {
         return (t >= BUS_MATCH_MESSAGE_TYPE && t <= BUS_MATCH_PATH) ||
                 (t >= BUS_MATCH_ARG && t <= BUS_MATCH_ARG_LAST) ||
-                (t >= BUS_MATCH_ARG_HAS && t <= BUS_MATCH_ARG_HAS_LAST);
+                (t >= BUS_MATCH_ARG_HAS && t <= BUS_MATCH_ARG_HAS_LAST) ||
+                BUS_MATCH_IS_NAMESPACE(t);
 }
 
 static void bus_match_node_free(struct bus_match_node *node) {
@@ -238,6 +244,72 @@ static bool value_node_same(
         }
 }
 
+static int bus_match_run_namespace(
+                sd_bus *bus,
+                struct bus_match_node *node,
+                sd_bus_message *m,
+                const char *value,
+                char separator) {
+
+        _cleanup_free_ char *buf = NULL;
+        size_t last = SIZE_MAX;
+        int r;
+
+        assert(node);
+        assert(BUS_MATCH_IS_NAMESPACE(node->type));
+
+        /* A namespace match matches the value itself, as well as every prefix of it that is followed by a
+         * separator, both with and without that separator (see simple_pattern_check()). Hence, instead of
+         * testing every child, let's look up each of these prefixes in the hash table. */
+
+        if (!value)
+                return 0;
+
+        buf = strdup(value);
+        if (!buf)
+                return -ENOMEM;
+
+        for (size_t i = 0;; i++) {
+                size_t candidates[2];
+                unsigned n = 0;
+
+                if (value[i] == 0)
+                        candidates[n++] = i;
+                else if (value[i] == separator) {
+                        candidates[n++] = i;
+                        candidates[n++] = i + 1;
+                }
+
+                for (unsigned k = 0; k < n; k++) {
+                        struct bus_match_node *found;
+                        char c;
+
+                        /* Don't look up the same prefix twice, e.g. if there are two separators in a row */
+                        if (candidates[k] == last)
+                                continue;
+                        last = candidates[k];
+
+                        c = buf[last];
+                        buf[last] = 0;
+                        found = hashmap_get(node->compare.children, buf);
+                        buf[last] = c;
+
+                        if (!found)
+                                continue;
+
+                        r = bus_match_run(bus, found, m);
+                        if (r != 0)
+                                return r;
+
+                        if (bus && bus->match_callbacks_modified)
+                                return 0;
+                }
+
+                if (value[i] == 0)
+                        return 0;
+        }
+}
+
 int bus_match_run(
                 sd_bus *bus,
                 struct bus_match_node *node,
@@ -383,7 +455,14 @@ int bus_match_run(
 
                 /* Lookup via hash table, nice! So let's jump directly. */
 
-                if (test_str)
+                if (BUS_MATCH_IS_NAMESPACE(node->type)) {
+                        r = bus_match_run_namespace(bus, node, m, test_str,
+                                                    node->type == BUS_MATCH_PATH_NAMESPACE ? '/' : '.');
+                        if (r != 0)
+                                return r;
+
+                        found = NULL;
+                } else if (test_str)
                         found = hashmap_get(node->compare.children, test_str);
                 else if (test_strv) {
                         char **i;
@@ -31,6 +31,9 @@
 
 #define SNDBUF_SIZE (8*1024*1024)
 
+/* The maximum number of queued messages we try to write in a single syscall */
+#define WRITE_BATCH_MAX 64U
+
 static void iovec_advance(struct iovec iov[], unsigned *idx, size_t size) {
 
         while (size > 0) {
@@ -1009,56 +1012,77 @@ int bus_socket_take_fd(sd_bus *b) {
         return bus_socket_start_auth(b);
 }
 
-int bus_socket_write_message(sd_bus *bus, sd_bus_message *m, size_t *idx) {
+int bus_socket_write_messages(sd_bus *bus, sd_bus_message **m, size_t n, size_t *idx) {
         struct iovec *iov;
+        size_t n_msg, n_iov = 0;
+        unsigned i = 0;
         ssize_t k;
-        size_t n;
-        unsigned j;
         int r;
 
         assert(bus);
         assert(m);
+        assert(n > 0);
         assert(idx);
         assert(IN_SET(bus->state, BUS_RUNNING, BUS_HELLO));
 
-        if (*idx >= BUS_MESSAGE_SIZE(m))
+        /* Writes the messages m[0…n-1] as far as possible in a single syscall. *idx is the offset into the
+         * concatenation of the messages, but is always within the first one on entry. Messages carrying fds
+         * are only included if they come first, since the fds are attached to the first byte of the
+         * write. */
+
+        if (*idx >= BUS_MESSAGE_SIZE(m[0]))
                 return 0;
 
-        r = bus_message_setup_iovec(m);
-        if (r < 0)
-                return r;
+        for (n_msg = 0; n_msg < MIN(n, WRITE_BATCH_MAX); n_msg++) {
+                if (n_msg > 0 && m[n_msg]->n_fds > 0 && !bus->prefer_writev)
+                        break;
+
+                r = bus_message_setup_iovec(m[n_msg]);
+                if (r < 0) {
+                        if (n_msg > 0)
+                                break; /* Write what we have so far, this will be hit again afterwards */
+                        return r;
+                }
 
-        n = m->n_iovec * sizeof(struct iovec);
-        iov = newa(struct iovec, n);
-        memcpy_safe(iov, m->iovec, n);
+                if (n_msg > 0 && n_iov + m[n_msg]->n_iovec > IOV_MAX)
+                        break;
 
-        j = 0;
-        iovec_advance(iov, &j, *idx);
+                n_iov += m[n_msg]->n_iovec;
+        }
+
+        iov = newa(struct iovec, n_iov);
+        n_iov = 0;
+        for (size_t j = 0; j < n_msg; j++) {
+                memcpy_safe(iov + n_iov, m[j]->iovec, m[j]->n_iovec * sizeof(struct iovec));
+                n_iov += m[j]->n_iovec;
+        }
+
+        iovec_advance(iov, &i, *idx);
 
         if (bus->prefer_writev)
-                k = writev(bus->output_fd, iov, m->n_iovec);
+                k = writev(bus->output_fd, iov, n_iov);
         else {
                 struct msghdr mh = {
                         .msg_iov = iov,
-                        .msg_iovlen = m->n_iovec,
+                        .msg_iovlen = n_iov,
                 };
 
-                if (m->n_fds > 0 && *idx == 0) {
+                if (m[0]->n_fds > 0 && *idx == 0) {
                         struct cmsghdr *control;
 
-                        mh.msg_controllen = CMSG_SPACE(sizeof(int) * m->n_fds);
+                        mh.msg_controllen = CMSG_SPACE(sizeof(int) * m[0]->n_fds);
                         mh.msg_control = alloca0(mh.msg_controllen);
                         control = CMSG_FIRSTHDR(&mh);
-                        control->cmsg_len = CMSG_LEN(sizeof(int) * m->n_fds);
+                        control->cmsg_len = CMSG_LEN(sizeof(int) * m[0]->n_fds);
                         control->cmsg_level = SOL_SOCKET;
                         control->cmsg_type = SCM_RIGHTS;
-                        memcpy(CMSG_DATA(control), m->fds, sizeof(int) * m->n_fds);
+                        memcpy(CMSG_DATA(control), m[0]->fds, sizeof(int) * m[0]->n_fds);
                 }
 
                 k = sendmsg(bus->output_fd, &mh, MSG_DONTWAIT|MSG_NOSIGNAL);
                 if (k < 0 && errno == ENOTSOCK) {
                         bus->prefer_writev = true;
-                        k = writev(bus->output_fd, iov, m->n_iovec);
+                        k = writev(bus->output_fd, iov, n_iov);
                 }
         }
 
@@ -1069,6 +1093,10 @@ int bus_socket_write_message(sd_bus *bus, sd_bus_message *m, size_t *idx) {
         return 1;
 }
 
+int bus_socket_write_message(sd_bus *bus, sd_bus_message *m, size_t *idx) {
+        return bus_socket_write_messages(bus, &m, 1, idx);
+}
+
 static int bus_socket_read_message_need(sd_bus *bus, size_t *need) {
         uint32_t a, b;
         uint8_t e;
@@ -1191,6 +1219,10 @@ int bus_socket_read_message(sd_bus *bus) {
         if (bus->rbuffer_size >= need)
                 return bus_socket_make_message(bus, need);
 
+        /* Note that we never read more than the current message: after the fixed header we know the full
+         * size, so the buffer is grown exactly once, and then handed over to the message object without
+         * copying. Reading further ahead would save a syscall per message, but would mean copying the
+         * excess into a new buffer, and might pick up fds that belong to the next message. */
         b = realloc(bus->rbuffer, need);
         if (!b)
                 return -ENOMEM;
@@ -8,16 +8,24 @@
 #include "alloc-util.h"
 #include "bus-internal.h"
 #include "bus-kernel.h"
+#include "bus-message.h"
 #include "def.h"
 #include "fd-util.h"
+#include "json.h"
 #include "missing_resource.h"
+#include "stdio-util.h"
 #include "string-util.h"
 #include "time-util.h"
 #include "util.h"
 
 #define MAX_SIZE (2*1024*1024)
 
+#define FANOUT_CLIENTS 8U
+#define FANOUT_SIGNALS 5000U
+
 static usec_t arg_loop_usec = 100 * USEC_PER_MSEC;
+static bool arg_json = false;
+static JsonVariant *json_results = NULL;
 
 typedef enum Type {
         TYPE_LEGACY,
@@ -206,10 +214,445 @@ static void client_chart(Type type, const char *address, const char *server_name
         sd_bus_unref(b);
 }
 
+static void report(const char *benchmark, const char *name, uint64_t ops) {
+        _cleanup_(json_variant_unrefp) JsonVariant *v = NULL;
+
+        /* The JSON output is meant to be compared between releases, hence keep the field names stable */
+
+        if (!arg_json) {
+                printf("%s\t%s\t%" PRIu64 "\n", benchmark, name, ops);
+                return;
+        }
+
+        assert_se(json_build(&v, JSON_BUILD_OBJECT(
+                                             JSON_BUILD_PAIR("benchmark", JSON_BUILD_STRING(benchmark)),
+                                             JSON_BUILD_PAIR("case", JSON_BUILD_STRING(name)),
+                                             JSON_BUILD_PAIR("opsPerSecond", JSON_BUILD_UNSIGNED(ops)))) >= 0);
+        assert_se(json_variant_append_array(&json_results, v) >= 0);
+}
+
+static uint64_t measure(void (*f)(void *userdata), void *userdata) {
+        usec_t t;
+        uint64_t n;
+
+        t = now(CLOCK_MONOTONIC);
+        for (n = 1;; n++) {
+                f(userdata);
+                if (now(CLOCK_MONOTONIC) >= t + arg_loop_usec)
+                        break;
+        }
+
+        return n * USEC_PER_SEC / arg_loop_usec;
+}
+
+static void direct_pair(sd_bus **ret_server, sd_bus **ret_client) {
+        sd_bus *a, *b;
+        int pair[2];
+
+        assert_se(socketpair(AF_UNIX, SOCK_STREAM|SOCK_CLOEXEC, 0, pair) >= 0);
+
+        assert_se(sd_bus_new(&a) >= 0);
+        assert_se(sd_bus_set_fd(a, pair[0], pair[0]) >= 0);
+        assert_se(sd_bus_set_server(a, true, SD_ID128_NULL) >= 0);
+        assert_se(sd_bus_start(a) >= 0);
+
+        assert_se(sd_bus_new(&b) >= 0);
+        assert_se(sd_bus_set_fd(b, pair[1], pair[1]) >= 0);
+        assert_se(sd_bus_start(b) >= 0);
+
+        while (sd_bus_is_ready(a) <= 0 || sd_bus_is_ready(b) <= 0) {
+                assert_se(sd_bus_process(a, NULL) >= 0);
+                assert_se(sd_bus_process(b, NULL) >= 0);
+        }
+
+        *ret_server = a;
+        *ret_client = b;
+}
+
+static void marshal_string(sd_bus_message *m) {
+        assert_se(sd_bus_message_append(m, "s", "org.freedesktop.systemd1.Unit") >= 0);
+}
+
+static void marshal_properties(sd_bus_message *m) {
+        /* Roughly what a GetAll() reply on a unit object looks like, just shorter */
+        assert_se(sd_bus_message_open_container(m, 'a', "{sv}") >= 0);
+        for (unsigned i = 0; i < 32; i++) {
+                char name[DECIMAL_STR_MAX(unsigned) + 9];
+
+                xsprintf(name, "Property%u", i);
+
+                switch (i % 4) {
+                case 0:
+                        assert_se(sd_bus_message_append(m, "{sv}", name, "s", "some-string-value") >= 0);
+                        break;
+                case 1:
+                        assert_se(sd_bus_message_append(m, "{sv}", name, "t", (uint64_t) i) >= 0);
+                        break;
+                case 2:
+                        assert_se(sd_bus_message_append(m, "{sv}", name, "b", true) >= 0);
+                        break;
+                case 3:
+                        assert_se(sd_bus_message_append(m, "{sv}", name, "as", 3, "a", "bb", "ccc") >= 0);
+                        break;
+                }
+        }
+        assert_se(sd_bus_message_close_container(m) >= 0);
+}
+
+static void marshal_structs(sd_bus_message *m) {
+        assert_se(sd_bus_message_append(m,
+                                        "a(usv)", 3,
+                                        4711, "first-string-parameter", "(st)", "X", (uint64_t) 1111,
+                                        4712, "second-string-parameter", "(a(si))", 2, "Y", 5, "Z", 6,
+                                        4713, "third-string-parameter", "(uu)", 1, 2) >= 0);
+}
+
+static void marshal_blob(sd_bus_message *m) {
+        void *p;
+
+        assert_se(sd_bus_message_append_array_space(m, 'y', 64 * 1024, &p) >= 0);
+        memset(p, 0x80, 64 * 1024);
+}
+
+typedef struct MarshalContext {
+        sd_bus *bus;
+        void (*append)(sd_bus_message *m);
+        uint64_t cookie;
+} MarshalContext;
+
+static void marshal_one(void *userdata) {
+        _cleanup_(sd_bus_message_unrefp) sd_bus_message *m = NULL, *n = NULL;
+        MarshalContext *c = userdata;
+        void *blob;
+        size_t sz;
+        int r;
+
+        assert_se(sd_bus_message_new_method_call(c->bus, &m, "benchmark.server", "/benchmark", "benchmark.server", "Marshal") >= 0);
+        c->append(m);
+        assert_se(sd_bus_message_seal(m, ++c->cookie, 0) >= 0);
+
+        assert_se(bus_message_get_blob(m, &blob, &sz) >= 0);
+        assert_se(bus_message_from_malloc(c->bus, blob, sz, NULL, 0, NULL, &n) >= 0);
+
+        /* Walk the whole body, every element is validated this way */
+        while ((r = sd_bus_message_skip(n, NULL)) > 0)
+                ;
+        assert_se(r >= 0 || r == -ENXIO);
+}
+
+static void benchmark_marshal(void) {
+        static const struct {
+                const char *name;
+                void (*append)(sd_bus_message *m);
+        } cases[] = {
+                { "s",      marshal_string     },
+                { "a{sv}",  marshal_properties },
+                { "a(usv)", marshal_structs    },
+                { "ay",     marshal_blob       },
+        };
+        sd_bus *a, *b;
+
+        direct_pair(&a, &b);
+
+        for (size_t i = 0; i < ELEMENTSOF(cases); i++)
+                for (unsigned version = 1; version <= 2; version++) {
+                        MarshalContext c = {
+                                .bus = b,
+                                .append = cases[i].append,
+                        };
+                        char name[32];
+
+                        b->message_version = version; /* dirty hack to enable gvariant */
+
+                        xsprintf(name, "%s/%s", cases[i].name, version == 2 ? "gvariant" : "dbus1");
+                        report("marshal", name, measure(marshal_one, &c));
+                }
+
+        b->message_version = 1;
+
+        sd_bus_flush_close_unref(b);
+        sd_bus_flush_close_unref(a);
+}
+
+static int match_handler(sd_bus_message *m, void *userdata, sd_bus_error *ret_error) {
+        uint64_t *hits = userdata;
+
+        (*hits)++;
+        return 0;
+}
+
+typedef struct DispatchContext {
+        sd_bus *server;
+        sd_bus *client;
+        const char *path;
+        const char *interface;
+        const char *member;
+        uint64_t cookie;
+        uint64_t n;
+} DispatchContext;
+
+static void dispatch_signal_one(void *userdata) {
+        _cleanup_(sd_bus_message_unrefp) sd_bus_message *m = NULL;
+        DispatchContext *c = userdata;
+
+        assert_se(sd_bus_message_new_signal(c->server, &m, c->path, c->interface, c->member) >= 0);
+        assert_se(sd_bus_message_seal(m, ++c->cookie, 0) >= 0);
+        m->read_counter = ++c->server->read_counter; /* Matches only apply to messages read after they were added */
+        assert_se(sd_bus_enqueue_for_read(c->server, m) >= 0);
+        assert_se(sd_bus_process(c->server, NULL) > 0);
+
+        c->n++;
+}
+
+static void benchmark_match(void) {
+        static const unsigned n_rules[] = { 1, 100, 10000 };
+
+        for (size_t i = 0; i < ELEMENTSOF(n_rules); i++) {
+                char path[STRLEN("/benchmark/") + DECIMAL_STR_MAX(unsigned)], name[64];
+                uint64_t hits = 0;
+                DispatchContext c;
+                sd_bus *a, *b;
+
+                direct_pair(&a, &b);
+
+                for (unsigned k = 0; k < n_rules[i]; k++) {
+                        char rule[128];
+
+                        xsprintf(rule, "type='signal',path='/benchmark/%u',interface='benchmark.match',member='Ping'", k);
+                        assert_se(sd_bus_add_match(a, NULL, rule, match_handler, &hits) >= 0);
+                }
+
+                xsprintf(path, "/benchmark/%u", n_rules[i] / 2);
+
+                c = (DispatchContext) {
+                        .server = a,
+                        .path = path,
+                        .interface = "benchmark.match",
+                        .member = "Ping",
+                };
+                xsprintf(name, "%u-rules/hit", n_rules[i]);
+                report("match", name, measure(dispatch_signal_one, &c));
+                assert_se(hits == c.n);
+
+                c = (DispatchContext) {
+                        .server = a,
+                        .path = "/benchmark/none",
+                        .interface = "benchmark.match",
+                        .member = "Ping",
+                };
+                xsprintf(name, "%u-rules/miss", n_rules[i]);
+                report("match", name, measure(dispatch_signal_one, &c));
+
+                sd_bus_flush_close_unref(b);
+                sd_bus_flush_close_unref(a);
+        }
+}
+
+static int method_echo(sd_bus_message *m, void *userdata, sd_bus_error *error) {
+        const char *s;
+        int r;
+
+        r = sd_bus_message_read(m, "s", &s);
+        if (r < 0)
+                return r;
+
+        return sd_bus_reply_method_return(m, "s", s);
+}
+
+static int property_get(
+                sd_bus *bus,
+                const char *path,
+                const char *interface,
+                const char *property,
+                sd_bus_message *reply,
+                void *userdata,
+                sd_bus_error *error) {
+
+        return sd_bus_message_append(reply, "s", property);
+}
+
+static const sd_bus_vtable dispatch_vtable[] = {
+        SD_BUS_VTABLE_START(0),
+        SD_BUS_METHOD("Echo", "s", "s", method_echo, 0),
+        SD_BUS_PROPERTY("A", "s", property_get, 0, SD_BUS_VTABLE_PROPERTY_CONST),
+        SD_BUS_PROPERTY("B", "s", property_get, 0, SD_BUS_VTABLE_PROPERTY_CONST),
+        SD_BUS_PROPERTY("C", "s", property_get, 0, SD_BUS_VTABLE_PROPERTY_CONST),
+        SD_BUS_PROPERTY("D", "s", property_get, 0, SD_BUS_VTABLE_PROPERTY_CONST),
+        SD_BUS_PROPERTY("E", "s", property_get, 0, SD_BUS_VTABLE_PROPERTY_CONST),
+        SD_BUS_PROPERTY("F", "s", property_get, 0, SD_BUS_VTABLE_PROPERTY_CONST),
+        SD_BUS_PROPERTY("G", "s", property_get, 0, SD_BUS_VTABLE_PROPERTY_CONST),
+        SD_BUS_PROPERTY("H", "s", property_get, 0, SD_BUS_VTABLE_PROPERTY_CONST),
+        SD_BUS_VTABLE_END
+};
+
+static void dispatch_method_one(void *userdata) {
+        _cleanup_(sd_bus_message_unrefp) sd_bus_message *m = NULL;
+        DispatchContext *c = userdata;
+
+        assert_se(sd_bus_message_new_method_call(c->server, &m, NULL, c->path, c->interface, c->member) >= 0);
+        if (streq(c->member, "Echo"))
+                assert_se(sd_bus_message_append(m, "s", "hello") >= 0);
+        else
+                assert_se(sd_bus_message_append(m, "s", "benchmark.vtable") >= 0);
+        assert_se(sd_bus_message_seal(m, ++c->cookie, 0) >= 0);
+        assert_se(sd_bus_enqueue_for_read(c->server, m) >= 0);
+        assert_se(sd_bus_process(c->server, NULL) > 0);
+
+        /* Read and drop the reply on the other side */
+        while (sd_bus_process(c->client, NULL) > 0)
+                ;
+}
+
+static void benchmark_vtable(void) {
+        static const struct {
+                const char *name;
+                const char *interface;
+                const char *member;
+        } cases[] = {
+                { "method",  "benchmark.vtable",                "Echo"   },
+                { "get-all", "org.freedesktop.DBus.Properties", "GetAll" },
+        };
+        sd_bus *a, *b;
+
+        direct_pair(&a, &b);
+
+        assert_se(sd_bus_add_object_vtable(a, NULL, "/benchmark", "benchmark.vtable", dispatch_vtable, NULL) >= 0);
+
+        for (size_t i = 0; i < ELEMENTSOF(cases); i++) {
+                DispatchContext c = {
+                        .server = a,
+                        .client = b,
+                        .path = "/benchmark",
+                        .interface = cases[i].interface,
+                        .member = cases[i].member,
+                };
+
+                report("vtable", cases[i].name, measure(dispatch_method_one, &c));
+        }
+
+        sd_bus_flush_close_unref(b);
+        sd_bus_flush_close_unref(a);
+}
+
+static void fanout_client(const char *server_name) {
+        _cleanup_(sd_bus_flush_close_unrefp) sd_bus *b = NULL;
+        uint64_t hits = 0;
+        char *match;
+
+        assert_se(sd_bus_open_user(&b) >= 0);
+
+        match = strjoina("type='signal',sender='", server_name, "',interface='benchmark.fanout',member='Ping'");
+        assert_se(sd_bus_add_match(b, NULL, match, match_handler, &hits) >= 0);
+
+        assert_se(sd_bus_call_method(b, server_name, "/", "benchmark.fanout", "Ready", NULL, NULL, NULL) >= 0);
+
+        while (hits < FANOUT_SIGNALS) {
+                int r;
+
+                r = sd_bus_process(b, NULL);
+                assert_se(r >= 0);
+                if (r == 0)
+                        assert_se(sd_bus_wait(b, USEC_INFINITY) >= 0);
+        }
+
+        assert_se(sd_bus_call_method(b, server_name, "/", "benchmark.fanout", "Done", NULL, NULL, NULL) >= 0);
+}
+
+static void benchmark_fanout(void) {
+        _cleanup_(sd_bus_flush_close_unrefp) sd_bus *b = NULL;
+        unsigned n_ready = 0, n_done = 0;
+        _cleanup_free_ char *server_name = NULL;
+        char name[DECIMAL_STR_MAX(unsigned) + 8];
+        const char *unique;
+        pid_t pids[FANOUT_CLIENTS];
+        usec_t t = 0;
+        int r;
+
+        r = sd_bus_open_user(&b);
+        if (r < 0) {
+                log_notice_errno(r, "Failed to connect to user bus, skipping signal fan-out benchmark: %m");
+                return;
+        }
+
+        assert_se(sd_bus_get_unique_name(b, &unique) >= 0);
+        server_name = strdup(unique);
+        assert_se(server_name);
+
+        for (unsigned i = 0; i < FANOUT_CLIENTS; i++) {
+                pids[i] = fork();
+                assert_se(pids[i] >= 0);
+
+                if (pids[i] == 0) {
+                        b = sd_bus_unref(b);
+                        fanout_client(server_name);
+                        _exit(EXIT_SUCCESS);
+                }
+        }
+
+        while (n_done < FANOUT_CLIENTS) {
+                _cleanup_(sd_bus_message_unrefp) sd_bus_message *m = NULL;
+
+                r = sd_bus_process(b, &m);
+                assert_se(r >= 0);
+                if (r == 0)
+                        assert_se(sd_bus_wait(b, USEC_INFINITY) >= 0);
+                if (!m)
+                        continue;
+
+                if (sd_bus_message_is_method_call(m, "benchmark.fanout", "Ready")) {
+                        assert_se(sd_bus_reply_method_return(m, NULL) >= 0);
+
+                        if (++n_ready < FANOUT_CLIENTS)
+                                continue;
+
+                        t = now(CLOCK_MONOTONIC);
+                        for (unsigned i = 0; i < FANOUT_SIGNALS; i++)
+                                assert_se(sd_bus_emit_signal(b, "/", "benchmark.fanout", "Ping", NULL) >= 0);
+
+                } else if (sd_bus_message_is_method_call(m, "benchmark.fanout", "Done")) {
+                        assert_se(sd_bus_reply_method_return(m, NULL) >= 0);
+                        n_done++;
+                }
+        }
+
+        t = now(CLOCK_MONOTONIC) - t;
+
+        for (unsigned i = 0; i < FANOUT_CLIENTS; i++)
+                assert_se(waitpid(pids[i], NULL, 0) == pids[i]);
+
+        /* Signals received per second, summed up over all clients */
+        xsprintf(name, "%u-clients", FANOUT_CLIENTS);
+        report("fanout", name, (uint64_t) FANOUT_CLIENTS * FANOUT_SIGNALS * USEC_PER_SEC / MAX(t, 1U));
+}
+
+static void benchmark_suite(bool marshal, bool match, bool vtable, bool fanout) {
+        if (!arg_json)
+                printf("BENCHMARK\tCASE\tOPS/s\n");
+
+        if (marshal)
+                benchmark_marshal();
+        if (match)
+                benchmark_match();
+        if (vtable)
+                benchmark_vtable();
+        if (fanout)
+                benchmark_fanout();
+
+        if (arg_json)
+                json_variant_dump(json_results, JSON_FORMAT_NEWLINE|JSON_FORMAT_PRETTY_AUTO, stdout, NULL);
+
+        json_results = json_variant_unref(json_results);
+}
+
 int main(int argc, char *argv[]) {
         enum {
                 MODE_BISECT,
                 MODE_CHART,
+                MODE_MARSHAL,
+                MODE_MATCH,
+                MODE_VTABLE,
+                MODE_FANOUT,
+                MODE_SUITE,
         } mode = MODE_BISECT;
         Type type = TYPE_LEGACY;
         int i, pair[2] = { -1, -1 };
@@ -232,6 +675,24 @@ int main(int argc, char *argv[]) {
                 } else if (streq(argv[i], "direct")) {
                         type = TYPE_DIRECT;
                         continue;
+                } else if (streq(argv[i], "marshal")) {
+                        mode = MODE_MARSHAL;
+                        continue;
+                } else if (streq(argv[i], "match")) {
+                        mode = MODE_MATCH;
+                        continue;
+                } else if (streq(argv[i], "vtable")) {
+                        mode = MODE_VTABLE;
+                        continue;
+                } else if (streq(argv[i], "fanout")) {
+                        mode = MODE_FANOUT;
+                        continue;
+                } else if (streq(argv[i], "suite")) {
+                        mode = MODE_SUITE;
+                        continue;
+                } else if (streq(argv[i], "json")) {
+                        arg_json = true;
+                        continue;
                 }
 
                 assert_se(parse_sec(argv[i], &arg_loop_usec) >= 0);
@@ -239,6 +700,16 @@ int main(int argc, char *argv[]) {
 
         assert_se(arg_loop_usec > 0);
 
+        /* These run in-process (except for the fan-out one, which needs a bus broker), and don't need the
+         * setup below */
+        if (mode >= MODE_MARSHAL) {
+                benchmark_suite(IN_SET(mode, MODE_MARSHAL, MODE_SUITE),
+                                IN_SET(mode, MODE_MATCH, MODE_SUITE),
+                                IN_SET(mode, MODE_VTABLE, MODE_SUITE),
+                                IN_SET(mode, MODE_FANOUT, MODE_SUITE));
+                return 0;
+        }
+
         if (type == TYPE_LEGACY) {
                 const char *e;
 
@@ -301,6 +772,9 @@ int main(int argc, char *argv[]) {
                 case MODE_CHART:
                         client_chart(type, address, server_name, pair[1]);
                         break;
+
+                default:
+                        assert_not_reached("Unexpected mode");
                 }
 
                 _exit(EXIT_SUCCESS);
@@ -1,5 +1,6 @@
 /* SPDX-License-Identifier: LGPL-2.1-or-later */
 
+#include "alloc-util.h"
 #include "bus-match.h"
 #include "bus-message.h"
 #include "bus-slot.h"
@@ -7,6 +8,7 @@
 #include "macro.h"
 #include "memory-util.h"
 #include "tests.h"
+#include "time-util.h"
 
 static bool mask[32];
 
@@ -57,6 +59,58 @@ static int match_add(sd_bus_slot *slots, struct bus_match_node *root, const char
         return r;
 }
 
+static int count_filter(sd_bus_message *m, void *userdata, sd_bus_error *ret_error) {
+        unsigned *count = userdata;
+
+        (*count)++;
+        return 0;
+}
+
+static void test_match_many(sd_bus *bus, const char *fmt, unsigned n) {
+        struct bus_match_node root = {
+                .type = BUS_MATCH_ROOT,
+        };
+        _cleanup_(sd_bus_message_unrefp) sd_bus_message *m = NULL;
+        _cleanup_free_ sd_bus_slot *slots = NULL;
+        char buf[FORMAT_TIMESPAN_MAX];
+        unsigned count = 0;
+        usec_t start;
+
+        log_info("/* %s(\"%s\", %u) */", __func__, fmt, n);
+
+        assert_se(slots = new0(sd_bus_slot, n));
+
+        for (unsigned i = 0; i < n; i++) {
+                struct bus_match_component *components;
+                _cleanup_free_ char *match = NULL;
+                unsigned n_components;
+
+                assert_se(asprintf(&match, fmt, i) >= 0);
+                assert_se(bus_match_parse(match, &components, &n_components) >= 0);
+
+                slots[i].userdata = &count;
+                slots[i].match_callback.callback = count_filter;
+                assert_se(bus_match_add(&root, components, n_components, &slots[i].match_callback) >= 0);
+                bus_match_parse_free(components, n_components);
+        }
+
+        assert_se(sd_bus_message_new_signal(bus, &m, "/org/freedesktop/systemd1/unit/u42",
+                                            "org.freedesktop.DBus.Properties", "PropertiesChanged") >= 0);
+        assert_se(sd_bus_message_append(m, "s", "org.freedesktop.systemd1.u42") >= 0);
+        assert_se(sd_bus_message_seal(m, 1, 0) >= 0);
+
+        start = now(CLOCK_MONOTONIC);
+        for (unsigned i = 0; i < 1000; i++)
+                assert_se(bus_match_run(NULL, &root, m) == 0);
+        log_info("Ran 1000 messages against %u matches in %s", n,
+                 format_timespan(buf, sizeof(buf), now(CLOCK_MONOTONIC) - start, 1));
+
+        /* Exactly one match is for u42 */
+        assert_se(count == 1000);
+
+        bus_match_free(&root);
+}
+
 static void test_match_scope(const char *match, enum bus_match_scope scope) {
         struct bus_match_component *components = NULL;
         unsigned n_components = 0;
@@ -73,7 +127,7 @@ int main(int argc, char *argv[]) {
 
         _cleanup_(sd_bus_message_unrefp) sd_bus_message *m = NULL;
         _cleanup_(sd_bus_flush_close_unrefp) sd_bus *bus = NULL;
-        sd_bus_slot slots[19] = {};
+        sd_bus_slot slots[24] = {};
         int r;
 
         test_setup_logging(LOG_INFO);
@@ -102,6 +156,11 @@ int main(int argc, char *argv[]) {
         assert_se(match_add(slots, &root, "arg4has='pa'", 16) >= 0);
         assert_se(match_add(slots, &root, "arg4has='po'", 17) >= 0);
         assert_se(match_add(slots, &root, "arg4='pi'", 18) >= 0);
+        assert_se(match_add(slots, &root, "path_namespace='/'", 19) >= 0);
+        assert_se(match_add(slots, &root, "path_namespace='/foo/'", 20) >= 0);
+        assert_se(match_add(slots, &root, "path_namespace='/foo/ba'", 21) >= 0);
+        assert_se(match_add(slots, &root, "arg3namespace='prefix.four'", 22) >= 0);
+        assert_se(match_add(slots, &root, "arg3namespace='prefix.fo'", 23) >= 0);
 
         bus_match_dump(stdout, &root, 0);
 
@@ -111,7 +170,7 @@ int main(int argc, char *argv[]) {
 
         zero(mask);
         assert_se(bus_match_run(NULL, &root, m) == 0);
-        assert_se(mask_contains((unsigned[]) { 9, 8, 7, 5, 10, 12, 13, 14, 15, 16, 17 }, 11));
+        assert_se(mask_contains((unsigned[]) { 9, 8, 7, 5, 10, 12, 13, 14, 15, 16, 17, 19, 20, 22 }, 14));
 
         assert_se(bus_match_remove(&root, &slots[8].match_callback) >= 0);
         assert_se(bus_match_remove(&root, &slots[13].match_callback) >= 0);
@@ -120,7 +179,7 @@ int main(int argc, char *argv[]) {
 
         zero(mask);
         assert_se(bus_match_run(NULL, &root, m) == 0);
-        assert_se(mask_contains((unsigned[]) { 9, 5, 10, 12, 14, 7, 15, 16, 17 }, 9));
+        assert_se(mask_contains((unsigned[]) { 9, 5, 10, 12, 14, 7, 15, 16, 17, 19, 20, 22 }, 12));
 
         for (enum bus_match_node_type i = 0; i < _BUS_MATCH_NODE_TYPE_MAX; i++) {
                 char buf[32];
@@ -134,6 +193,10 @@ int main(int argc, char *argv[]) {
 
         bus_match_free(&root);
 
+        test_match_many(bus, "path_namespace='/org/freedesktop/systemd1/unit/u%u'", 10000);
+        test_match_many(bus, "arg0namespace='org.freedesktop.systemd1.u%u'", 10000);
+        test_match_many(bus, "path='/org/freedesktop/systemd1/unit/u%u',interface='org.freedesktop.DBus.Properties'", 10000);
+
         test_match_scope("interface='foobar'", BUS_MATCH_GENERIC);
         test_match_scope("", BUS_MATCH_GENERIC);
         test_match_scope("interface='org.freedesktop.DBus.Local'", BUS_MATCH_LOCAL);
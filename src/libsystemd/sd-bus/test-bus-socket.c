@@ -0,0 +1,138 @@
+/* SPDX-License-Identifier: LGPL-2.1-or-later */
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "sd-bus.h"
+
+#include "bus-internal.h"
+#include "fd-util.h"
+#include "io-util.h"
+#include "tests.h"
+
+#define N_MESSAGES 100U
+
+static bool message_has_fd(unsigned i) {
+        return i % 3 == 0;
+}
+
+static void process_until_ready(sd_bus *a, sd_bus *b) {
+        while (sd_bus_is_ready(a) <= 0 || sd_bus_is_ready(b) <= 0) {
+                int r, q;
+
+                r = sd_bus_process(a, NULL);
+                assert_se(r >= 0);
+                q = sd_bus_process(b, NULL);
+                assert_se(q >= 0);
+
+                if (r == 0 && q == 0)
+                        assert_se(sd_bus_wait(a, 10 * USEC_PER_MSEC) >= 0);
+        }
+}
+
+static void send_one(sd_bus *bus, unsigned i) {
+        _cleanup_(sd_bus_message_unrefp) sd_bus_message *m = NULL;
+        char padding[512];
+
+        memset(padding, 'a' + i % 26, sizeof(padding) - 1);
+        padding[sizeof(padding) - 1] = 0;
+
+        assert_se(sd_bus_message_new_signal(bus, &m, "/", "org.freedesktop.systemd.test", "Item") >= 0);
+        assert_se(sd_bus_message_append(m, "us", i, padding) >= 0);
+
+        if (message_has_fd(i)) {
+                _cleanup_close_pair_ int p[2] = { -1, -1 };
+
+                /* The receiver reads the index back through the fd, to check it got the right one */
+                assert_se(pipe2(p, O_CLOEXEC) >= 0);
+                assert_se(loop_write(p[1], &i, sizeof(i), false) >= 0);
+                assert_se(sd_bus_message_append(m, "h", p[0]) >= 0);
+        }
+
+        assert_se(sd_bus_send(bus, m, NULL) >= 0);
+}
+
+static void check_one(sd_bus_message *m, unsigned i) {
+        const char *padding;
+        unsigned j;
+
+        assert_se(sd_bus_message_is_signal(m, "org.freedesktop.systemd.test", "Item"));
+        assert_se(sd_bus_message_read(m, "us", &j, &padding) >= 0);
+        assert_se(j == i);
+        assert_se(strlen(padding) == 511 && padding[0] == 'a' + i % 26);
+
+        if (message_has_fd(i)) {
+                int fd;
+
+                assert_se(sd_bus_message_read(m, "h", &fd) >= 0);
+                assert_se(loop_read_exact(fd, &j, sizeof(j), false) >= 0);
+                assert_se(j == i);
+        } else
+                assert_se(sd_bus_message_at_end(m, true) > 0);
+}
+
+static void test_write_interleaved_fds(void) {
+        _cleanup_(sd_bus_flush_close_unrefp) sd_bus *client = NULL, *server = NULL;
+        int fds[2], sndbuf = 4096;
+        unsigned n = 0;
+        sd_id128_t id;
+
+        log_info("/* %s */", __func__);
+
+        /* Queue messages with and without fds while the socket is full, so that the write queue is
+         * flushed in batches, and check that they arrive in order, each with its own fd. */
+
+        assert_se(socketpair(AF_UNIX, SOCK_STREAM|SOCK_CLOEXEC|SOCK_NONBLOCK, 0, fds) >= 0);
+
+        assert_se(sd_id128_randomize(&id) >= 0);
+
+        assert_se(sd_bus_new(&server) >= 0);
+        assert_se(sd_bus_set_fd(server, fds[0], fds[0]) >= 0);
+        assert_se(sd_bus_set_server(server, true, id) >= 0);
+        assert_se(sd_bus_negotiate_fds(server, true) >= 0);
+        assert_se(sd_bus_start(server) >= 0);
+
+        assert_se(sd_bus_new(&client) >= 0);
+        assert_se(sd_bus_set_fd(client, fds[1], fds[1]) >= 0);
+        assert_se(sd_bus_negotiate_fds(client, true) >= 0);
+        assert_se(sd_bus_start(client) >= 0);
+
+        process_until_ready(server, client);
+        assert_se(sd_bus_can_send(client, 'h') > 0);
+
+        /* sd-bus enlarges the send buffer while setting up the connection, shrink it again afterwards */
+        assert_se(setsockopt(fds[1], SOL_SOCKET, SO_SNDBUF, &sndbuf, sizeof(sndbuf)) >= 0);
+
+        for (unsigned i = 0; i < N_MESSAGES; i++)
+                send_one(client, i);
+
+        /* The socket buffer is too small for all of them, hence most are still queued */
+        assert_se(client->wqueue_size > 1);
+
+        while (n < N_MESSAGES) {
+                _cleanup_(sd_bus_message_unrefp) sd_bus_message *m = NULL;
+                int r, q;
+
+                r = sd_bus_process(server, &m);
+                assert_se(r >= 0);
+                if (m)
+                        check_one(m, n++);
+
+                q = sd_bus_process(client, NULL);
+                assert_se(q >= 0);
+
+                if (r == 0 && q == 0)
+                        assert_se(sd_bus_wait(server, 10 * USEC_PER_MSEC) >= 0);
+        }
+
+        assert_se(client->wqueue_size == 0);
+}
+
+int main(int argc, char *argv[]) {
+        test_setup_logging(LOG_DEBUG);
+
+        test_write_interleaved_fds();
+
+        return 0;
+}
@@ -441,6 +441,11 @@ static int enumerator_scan_dir_and_add_devices(sd_device_enumerator *enumerator,
                         continue;
                 }
 
+                /* Check the parent first, as that only needs the syspath we already have, while the
+                 * checks below need to read the udev database or sysfs attributes. */
+                if (!match_parent(enumerator, device))
+                        continue;
+
                 initialized = sd_device_get_is_initialized(device);
                 if (initialized < 0) {
                         if (initialized != -ENOENT)
@@ -466,9 +471,6 @@ static int enumerator_scan_dir_and_add_devices(sd_device_enumerator *enumerator,
                      sd_device_get_ifindex(device, NULL) >= 0))
                         continue;
 
-                if (!match_parent(enumerator, device))
-                        continue;
-
                 if (!match_tag(enumerator, device))
                         continue;
 
@@ -576,17 +578,8 @@ static int enumerator_scan_devices_tag(sd_device_enumerator *enumerator, const c
                         continue;
                 }
 
-                k = sd_device_get_subsystem(device, &subsystem);
-                if (k < 0) {
-                        if (k != -ENOENT)
-                                /* this is necessarily racy, so ignore missing devices */
-                                r = k;
-                        continue;
-                }
-
-                if (!match_subsystem(enumerator, subsystem))
-                        continue;
-
+                /* The sysname and the parent are derived from the syspath, so check them before the
+                 * subsystem, which may require reading the 'subsystem' link in sysfs. */
                 k = sd_device_get_sysname(device, &sysname);
                 if (k < 0) {
                         r = k;
@@ -599,6 +592,17 @@ static int enumerator_scan_devices_tag(sd_device_enumerator *enumerator, const c
                 if (!match_parent(enumerator, device))
                         continue;
 
+                k = sd_device_get_subsystem(device, &subsystem);
+                if (k < 0) {
+                        if (k != -ENOENT)
+                                /* this is necessarily racy, so ignore missing devices */
+                                r = k;
+                        continue;
+                }
+
+                if (!match_subsystem(enumerator, subsystem))
+                        continue;
+
                 if (!match_property(enumerator, device))
                         continue;
 
@@ -644,20 +648,20 @@ static int parent_add_child(sd_device_enumerator *enumerator, const char *path)
         else if (r < 0)
                 return r;
 
-        r = sd_device_get_subsystem(device, &subsystem);
-        if (r == -ENOENT)
-                return 0;
+        r = sd_device_get_sysname(device, &sysname);
         if (r < 0)
                 return r;
 
-        if (!match_subsystem(enumerator, subsystem))
+        if (!match_sysname(enumerator, sysname))
                 return 0;
 
-        r = sd_device_get_sysname(device, &sysname);
+        r = sd_device_get_subsystem(device, &subsystem);
+        if (r == -ENOENT)
+                return 0;
         if (r < 0)
                 return r;
 
-        if (!match_sysname(enumerator, sysname))
+        if (!match_subsystem(enumerator, subsystem))
                 return 0;
 
         if (!match_property(enumerator, device))
@@ -14,6 +14,7 @@
 #include "fileio.h"
 #include "fs-util.h"
 #include "hashmap.h"
+#include "io-util.h"
 #include "macro.h"
 #include "mkdir.h"
 #include "nulstr-util.h"
@@ -834,59 +835,19 @@ void device_set_db_persist(sd_device *device) {
         device->db_persist = true;
 }
 
-int device_update_db(sd_device *device) {
-        const char *id;
-        char *path;
+static int device_format_db(sd_device *device, bool has_info, char **ret, size_t *ret_size) {
         _cleanup_fclose_ FILE *f = NULL;
-        _cleanup_free_ char *path_tmp = NULL;
-        bool has_info;
+        _cleanup_free_ char *buf = NULL;
+        size_t sz = 0;
         int r;
 
         assert(device);
+        assert(ret);
+        assert(ret_size);
 
-        has_info = device_has_info(device);
-
-        r = device_get_id_filename(device, &id);
-        if (r < 0)
-                return r;
-
-        path = strjoina("/run/udev/data/", id);
-
-        /* do not store anything for otherwise empty devices */
-        if (!has_info && major(device->devnum) == 0 && device->ifindex == 0) {
-                r = unlink(path);
-                if (r < 0 && errno != ENOENT)
-                        return -errno;
-
-                return 0;
-        }
-
-        /* write a database file */
-        r = mkdir_parents(path, 0755);
-        if (r < 0)
-                return r;
-
-        r = fopen_temporary(path, &f, &path_tmp);
-        if (r < 0)
-                return r;
-
-        /*
-         * set 'sticky' bit to indicate that we should not clean the
-         * database when we transition from initramfs to the real root
-         */
-        if (device->db_persist) {
-                r = fchmod(fileno(f), 01644);
-                if (r < 0) {
-                        r = -errno;
-                        goto fail;
-                }
-        } else {
-                r = fchmod(fileno(f), 0644);
-                if (r < 0) {
-                        r = -errno;
-                        goto fail;
-                }
-        }
+        f = open_memstream_unlocked(&buf, &sz);
+        if (!f)
+                return -ENOMEM;
 
         if (has_info) {
                 const char *property, *value, *tag;
@@ -921,6 +882,114 @@ int device_update_db(sd_device *device) {
                 fputs("V:" STRINGIFY(LATEST_UDEV_DATABASE_VERSION) "\n", f);
         }
 
+        r = fflush_and_check(f);
+        if (r < 0)
+                return r;
+
+        f = safe_fclose(f);
+
+        *ret = TAKE_PTR(buf);
+        *ret_size = sz;
+        return 0;
+}
+
+static bool device_db_is_current(const char *path, mode_t mode, const char *data, size_t size) {
+        _cleanup_free_ char *old = NULL;
+        _cleanup_close_ int fd = -1;
+        struct stat st;
+        ssize_t n;
+
+        assert(path);
+        assert(data || size == 0);
+
+        /* Checks whether the database file already has exactly the specified contents and access mode. */
+
+        fd = open(path, O_RDONLY|O_CLOEXEC|O_NOCTTY|O_NOFOLLOW);
+        if (fd < 0)
+                return false;
+
+        if (fstat(fd, &st) < 0)
+                return false;
+
+        if (!S_ISREG(st.st_mode) || (st.st_mode & 07777) != mode || (uint64_t) st.st_size != size)
+                return false;
+
+        if (size == 0)
+                return true;
+
+        /* Read one more byte than we expect, to notice if the file grew in the meantime */
+        old = malloc(size + 1);
+        if (!old)
+                return false;
+
+        n = loop_read(fd, old, size + 1, true);
+        return n == (ssize_t) size && memcmp(old, data, size) == 0;
+}
+
+int device_update_db(sd_device *device) {
+        const char *id;
+        char *path;
+        _cleanup_fclose_ FILE *f = NULL;
+        _cleanup_free_ char *path_tmp = NULL, *data = NULL;
+        size_t size;
+        bool has_info;
+        mode_t mode;
+        int r;
+
+        assert(device);
+
+        has_info = device_has_info(device);
+
+        r = device_get_id_filename(device, &id);
+        if (r < 0)
+                return r;
+
+        path = strjoina("/run/udev/data/", id);
+
+        /* do not store anything for otherwise empty devices */
+        if (!has_info && major(device->devnum) == 0 && device->ifindex == 0) {
+                r = unlink(path);
+                if (r < 0 && errno != ENOENT)
+                        return -errno;
+
+                return 0;
+        }
+
+        r = device_format_db(device, has_info, &data, &size);
+        if (r < 0)
+                return log_device_debug_errno(device, r, "sd-device: Failed to format db for '%s': %m", device->devpath);
+
+        /*
+         * set 'sticky' bit to indicate that we should not clean the
+         * database when we transition from initramfs to the real root
+         */
+        mode = device->db_persist ? 01644 : 0644;
+
+        /* Devices often get several events in a row (e.g. "add" followed by "change" during coldplug) that
+         * leave the database unchanged. Don't replace the file in that case. */
+        if (device_db_is_current(path, mode, data, size)) {
+                log_device_debug(device, "sd-device: %s file '%s' for '%s' is up to date", has_info ? "db" : "empty",
+                                 path, device->devpath);
+                return 0;
+        }
+
+        /* write a database file */
+        r = mkdir_parents(path, 0755);
+        if (r < 0)
+                return r;
+
+        r = fopen_temporary(path, &f, &path_tmp);
+        if (r < 0)
+                return r;
+
+        r = fchmod(fileno(f), mode);
+        if (r < 0) {
+                r = -errno;
+                goto fail;
+        }
+
+        fwrite(data, 1, size, f);
+
         r = fflush_and_check(f);
         if (r < 0)
                 goto fail;
@@ -677,6 +677,33 @@ _public_ int sd_device_get_syspath(sd_device *device, const char **ret) {
         return 0;
 }
 
+static int device_new_from_canonical_syspath(sd_device **ret, const char *syspath) {
+        _cleanup_(sd_device_unrefp) sd_device *device = NULL;
+        const char *uevent;
+        int r;
+
+        assert(ret);
+        assert(path_startswith(syspath, "/sys/devices/"));
+
+        /* The syspath is known to be canonical already, e.g. because it is derived from the syspath of a
+         * child device. Hence, there is no need to chase symlinks again, only check that this is a device. */
+
+        uevent = strjoina(syspath, "/uevent");
+        if (access(uevent, F_OK) < 0)
+                return errno == ENOENT ? -ENODEV : -errno;
+
+        r = device_new_aux(&device);
+        if (r < 0)
+                return r;
+
+        r = device_set_syspath(device, syspath, false);
+        if (r < 0)
+                return r;
+
+        *ret = TAKE_PTR(device);
+        return 0;
+}
+
 static int device_new_from_child(sd_device **ret, sd_device *child) {
         _cleanup_free_ char *path = NULL;
         const char *subdir, *syspath;
@@ -703,7 +730,10 @@ static int device_new_from_child(sd_device **ret, sd_device *child) {
 
                 *pos = '\0';
 
-                r = sd_device_new_from_syspath(ret, path);
+                if (path_startswith(path, "/sys/devices/"))
+                        r = device_new_from_canonical_syspath(ret, path);
+                else
+                        r = sd_device_new_from_syspath(ret, path);
                 if (r < 0)
                         continue;
 
@@ -63,6 +63,7 @@ struct sd_event_source {
         bool floating:1;
         bool exit_on_failure:1;
         bool ratelimited:1;
+        bool from_pool:1;
 
         int64_t priority;
         unsigned pending_index;
@@ -81,6 +82,12 @@ struct sd_event_source {
         unsigned earliest_index;
         unsigned latest_index;
 
+        /* Dispatch accounting, only maintained if $SD_EVENT_PROFILE_DELAYS is set, and reset whenever it is
+         * logged. */
+        usec_t pending_usec;
+        unsigned n_dispatched;
+        usec_t dispatch_usec, dispatch_max_usec, latency_max_usec;
+
         union {
                 struct {
                         sd_event_io_handler_t callback;
@@ -192,6 +199,8 @@ struct inode_data {
         LIST_FIELDS(struct inode_data, to_close);
 };
 
+#define INOTIFY_DATA_BUFFER_SIZE (16 * INOTIFY_EVENT_MAX)
+
 /* A structure encapsulating an inotify fd */
 struct inotify_data {
         WakeupType wakeup;
@@ -205,9 +214,14 @@ struct inotify_data {
         Hashmap *inodes; /* The inode_data structures keyed by dev+ino */
         Hashmap *wd;     /* The inode_data structures keyed by the watch descriptor for each */
 
-        /* The buffer we read inotify events into */
-        union inotify_event_buffer buffer;
-        size_t buffer_filled; /* fill level of the buffer */
+        /* The buffer we read inotify events into. We read as many events as fit in one go, and then process
+         * them one by one from buffer_offset on, so that a burst of events doesn't cost one read() each. */
+        union {
+                struct inotify_event ev;
+                uint8_t raw[INOTIFY_DATA_BUFFER_SIZE];
+        } buffer;
+        size_t buffer_offset; /* offset of the first unprocessed event in the buffer */
+        size_t buffer_filled; /* number of unprocessed bytes in the buffer, starting at buffer_offset */
 
         /* How many event sources are currently marked pending for this inotify. We won't read new events off the
          * inotify fd as long as there are still pending events on the inotify (because we have no strategy of queuing
@@ -11,12 +11,14 @@
 #include "alloc-util.h"
 #include "env-util.h"
 #include "event-source.h"
+#include "event-util.h"
 #include "fd-util.h"
 #include "fs-util.h"
 #include "hashmap.h"
 #include "list.h"
 #include "macro.h"
 #include "memory-util.h"
+#include "mempool.h"
 #include "missing_syscall.h"
 #include "prioq.h"
 #include "process-util.h"
@@ -133,6 +135,7 @@ struct sd_event {
         bool need_process_child:1;
         bool watchdog:1;
         bool profile_delays:1;
+        bool dispatch_batch:1;
 
         int exit_code;
 
@@ -154,6 +157,8 @@ struct sd_event {
 
 static thread_local sd_event *default_event = NULL;
 
+DEFINE_MEMPOOL(event_source_pool, sd_event_source, 64);
+
 static void source_disconnect(sd_event_source *s);
 static void event_gc_inode_data(sd_event *e, struct inode_data *d);
 
@@ -989,6 +994,14 @@ static sd_event_source* source_free(sd_event_source *s) {
                 s->destroy_callback(s->userdata);
 
         free(s->description);
+
+        if (s->from_pool) {
+                /* Ensure that the object didn't get migrated between threads. */
+                assert_se(is_main_thread());
+                mempool_free_tile(&event_source_pool, s);
+                return NULL;
+        }
+
         return mfree(s);
 }
 DEFINE_TRIVIAL_CLEANUP_FUNC(sd_event_source*, source_free);
@@ -1007,6 +1020,9 @@ static int source_set_pending(sd_event_source *s, bool b) {
         if (b) {
                 s->pending_iteration = s->event->iteration;
 
+                if (s->event->profile_delays)
+                        s->pending_usec = now(CLOCK_MONOTONIC);
+
                 r = prioq_put(s->event->pending, s, &s->pending_index);
                 if (r < 0) {
                         s->pending = false;
@@ -1044,10 +1060,15 @@ static int source_set_pending(sd_event_source *s, bool b) {
 
 static sd_event_source *source_new(sd_event *e, bool floating, EventSourceType type) {
         sd_event_source *s;
+        bool use_pool;
 
         assert(e);
 
-        s = new(sd_event_source, 1);
+        /* Event sources are frequently allocated and freed (think per-request timeouts), hence take them from
+         * a pool if we can, the same way as hashmap headers. */
+        use_pool = mempool_enabled();
+
+        s = use_pool ? mempool_alloc_tile(&event_source_pool) : new(sd_event_source, 1);
         if (!s)
                 return NULL;
 
@@ -1055,6 +1076,7 @@ static sd_event_source *source_new(sd_event *e, bool floating, EventSourceType t
                 .n_ref = 1,
                 .event = e,
                 .floating = floating,
+                .from_pool = use_pool,
                 .type = type,
                 .pending_index = PRIOQ_IDX_NULL,
                 .prepare_index = PRIOQ_IDX_NULL,
@@ -2573,6 +2595,11 @@ _public_ int sd_event_source_set_time(sd_event_source *s, uint64_t usec) {
         assert_return(s->event->state != SD_EVENT_FINISHED, -ESTALE);
         assert_return(!event_pid_changed(s->event), -ECHILD);
 
+        /* Rearming a timer to the time it already has is common enough, and means nothing changes in the
+         * prioqs, hence shortcut things in that case. */
+        if (s->time.next == usec && !s->pending)
+                return 0;
+
         r = source_set_pending(s, false);
         if (r < 0)
                 return r;
@@ -2620,13 +2647,16 @@ _public_ int sd_event_source_set_time_accuracy(sd_event_source *s, uint64_t usec
         assert_return(s->event->state != SD_EVENT_FINISHED, -ESTALE);
         assert_return(!event_pid_changed(s->event), -ECHILD);
 
+        if (usec == 0)
+                usec = DEFAULT_ACCURACY_USEC;
+
+        if (s->time.accuracy == usec && !s->pending)
+                return 0;
+
         r = source_set_pending(s, false);
         if (r < 0)
                 return r;
 
-        if (usec == 0)
-                usec = DEFAULT_ACCURACY_USEC;
-
         s->time.accuracy = usec;
 
         event_source_time_prioq_reshuffle(s);
@@ -3313,7 +3343,7 @@ static int event_inotify_data_read(sd_event *e, struct inotify_data *d, uint32_t
         if (d->priority > threshold)
                 return 0;
 
-        n = read(d->fd, &d->buffer, sizeof(d->buffer));
+        n = read(d->fd, d->buffer.raw, sizeof(d->buffer.raw));
         if (n < 0) {
                 if (IN_SET(errno, EAGAIN, EINTR))
                         return 0;
@@ -3322,6 +3352,7 @@ static int event_inotify_data_read(sd_event *e, struct inotify_data *d, uint32_t
         }
 
         assert(n > 0);
+        d->buffer_offset = 0;
         d->buffer_filled = (size_t) n;
         LIST_PREPEND(buffered, e->inotify_data_buffered, d);
 
@@ -3336,12 +3367,22 @@ static void event_inotify_data_drop(sd_event *e, struct inotify_data *d, size_t
         if (sz == 0)
                 return;
 
-        /* Move the rest to the buffer to the front, in order to get things properly aligned again */
-        memmove(d->buffer.raw, d->buffer.raw + sz, d->buffer_filled - sz);
+        /* The kernel pads each event so that the next one is properly aligned, hence we can simply skip over
+         * the processed one. */
+        d->buffer_offset += sz;
         d->buffer_filled -= sz;
 
-        if (d->buffer_filled == 0)
+        if (d->buffer_filled == 0) {
+                d->buffer_offset = 0;
                 LIST_REMOVE(buffered, e->inotify_data_buffered, d);
+        }
+}
+
+static struct inotify_event* event_inotify_data_current(struct inotify_data *d) {
+        assert(d);
+        assert(d->buffer_offset + d->buffer_filled <= sizeof(d->buffer.raw));
+
+        return (struct inotify_event*) (d->buffer.raw + d->buffer_offset);
 }
 
 static int event_inotify_data_process(sd_event *e, struct inotify_data *d) {
@@ -3355,17 +3396,18 @@ static int event_inotify_data_process(sd_event *e, struct inotify_data *d) {
                 return 0;
 
         while (d->buffer_filled > 0) {
+                struct inotify_event *ev = event_inotify_data_current(d);
                 size_t sz;
 
                 /* Let's validate that the event structures are complete */
                 if (d->buffer_filled < offsetof(struct inotify_event, name))
                         return -EIO;
 
-                sz = offsetof(struct inotify_event, name) + d->buffer.ev.len;
+                sz = offsetof(struct inotify_event, name) + ev->len;
                 if (d->buffer_filled < sz)
                         return -EIO;
 
-                if (d->buffer.ev.mask & IN_Q_OVERFLOW) {
+                if (ev->mask & IN_Q_OVERFLOW) {
                         struct inode_data *inode_data;
 
                         /* The queue overran, let's pass this event to all event sources connected to this inotify
@@ -3390,9 +3432,9 @@ static int event_inotify_data_process(sd_event *e, struct inotify_data *d) {
 
                         /* Find the inode object for this watch descriptor. If IN_IGNORED is set we also remove it from
                          * our watch descriptor table. */
-                        if (d->buffer.ev.mask & IN_IGNORED) {
+                        if (ev->mask & IN_IGNORED) {
 
-                                inode_data = hashmap_remove(d->wd, INT_TO_PTR(d->buffer.ev.wd));
+                                inode_data = hashmap_remove(d->wd, INT_TO_PTR(ev->wd));
                                 if (!inode_data) {
                                         event_inotify_data_drop(e, d, sz);
                                         continue;
@@ -3401,7 +3443,7 @@ static int event_inotify_data_process(sd_event *e, struct inotify_data *d) {
                                 /* The watch descriptor was removed by the kernel, let's drop it here too */
                                 inode_data->wd = -1;
                         } else {
-                                inode_data = hashmap_get(d->wd, INT_TO_PTR(d->buffer.ev.wd));
+                                inode_data = hashmap_get(d->wd, INT_TO_PTR(ev->wd));
                                 if (!inode_data) {
                                         event_inotify_data_drop(e, d, sz);
                                         continue;
@@ -3415,8 +3457,8 @@ static int event_inotify_data_process(sd_event *e, struct inotify_data *d) {
                                 if (event_source_is_offline(s))
                                         continue;
 
-                                if ((d->buffer.ev.mask & (IN_IGNORED|IN_UNMOUNT)) == 0 &&
-                                    (s->inotify.mask & d->buffer.ev.mask & IN_ALL_EVENTS) == 0)
+                                if ((ev->mask & (IN_IGNORED|IN_UNMOUNT)) == 0 &&
+                                    (s->inotify.mask & ev->mask & IN_ALL_EVENTS) == 0)
                                         continue;
 
                                 r = source_set_pending(s, true);
@@ -3453,6 +3495,7 @@ static int process_inotify(sd_event *e) {
 static int source_dispatch(sd_event_source *s) {
         _cleanup_(sd_event_unrefp) sd_event *saved_event = NULL;
         EventSourceType saved_type;
+        usec_t start = 0;
         int r = 0;
 
         assert(s);
@@ -3504,6 +3547,13 @@ static int source_dispatch(sd_event_source *s) {
                         return r;
         }
 
+        if (saved_event->profile_delays) {
+                start = now(CLOCK_MONOTONIC);
+
+                if (s->pending_usec != 0)
+                        s->latency_max_usec = MAX(s->latency_max_usec, usec_sub_unsigned(start, s->pending_usec));
+        }
+
         s->dispatching = true;
 
         switch (s->type) {
@@ -3554,17 +3604,20 @@ static int source_dispatch(sd_event_source *s) {
 
         case SOURCE_INOTIFY: {
                 struct sd_event *e = s->event;
+                struct inotify_event *ev;
                 struct inotify_data *d;
                 size_t sz;
 
                 assert(s->inotify.inode_data);
                 assert_se(d = s->inotify.inode_data->inotify_data);
 
+                ev = event_inotify_data_current(d);
+
                 assert(d->buffer_filled >= offsetof(struct inotify_event, name));
-                sz = offsetof(struct inotify_event, name) + d->buffer.ev.len;
+                sz = offsetof(struct inotify_event, name) + ev->len;
                 assert(d->buffer_filled >= sz);
 
-                r = s->inotify.callback(s, &d->buffer.ev, s->userdata);
+                r = s->inotify.callback(s, ev, s->userdata);
 
                 /* When no event is pending anymore on this inotify object, then let's drop the event from the
                  * buffer. */
@@ -3582,6 +3635,21 @@ static int source_dispatch(sd_event_source *s) {
 
         s->dispatching = false;
 
+        if (saved_event->profile_delays) {
+                usec_t end, d;
+
+                end = now(CLOCK_MONOTONIC);
+                d = usec_sub_unsigned(end, start);
+
+                s->n_dispatched++;
+                s->dispatch_usec = usec_add(s->dispatch_usec, d);
+                s->dispatch_max_usec = MAX(s->dispatch_max_usec, d);
+
+                /* Defer and exit sources stay pending, hence consider them ready again right away */
+                if (IN_SET(s->type, SOURCE_DEFER, SOURCE_EXIT))
+                        s->pending_usec = end;
+        }
+
         if (r < 0) {
                 log_debug_errno(r, "Event source %s (type %s) returned error, %s: %m",
                                 strna(s->description),
@@ -4056,8 +4124,44 @@ finish:
         return r;
 }
 
+static int dispatch_batch(sd_event *e, int64_t priority, unsigned n) {
+        sd_event_source *p;
+        int r;
+
+        assert(e);
+
+        /* Continues dispatching after the first source of an iteration, as long as the next pending source
+         * has the same priority as the one we just dispatched. Since a source that became pending while
+         * dispatching at a higher priority sorts before us, priority semantics are preserved. Defer, post
+         * and exit sources are never batched: the first two stay pending after dispatching, and the latter
+         * is handled by dispatch_exit() anyway. To guarantee termination we never dispatch more sources
+         * than were pending when the iteration began. Each batched source counts as an iteration of its
+         * own and gets a fresh timestamp, so that callbacks see the same as without batching. */
+
+        while (--n > 0) {
+                if (e->exit_requested)
+                        break;
+
+                p = event_next_pending(e);
+                if (!p || p->priority != priority ||
+                    IN_SET(p->type, SOURCE_DEFER, SOURCE_POST, SOURCE_EXIT))
+                        break;
+
+                e->iteration++;
+                triple_timestamp_get(&e->timestamp);
+
+                r = source_dispatch(p);
+                if (r < 0)
+                        return r;
+        }
+
+        return 1;
+}
+
 _public_ int sd_event_dispatch(sd_event *e) {
         sd_event_source *p;
+        int64_t priority;
+        unsigned n;
         int r;
 
         assert_return(e, -EINVAL);
@@ -4074,7 +4178,12 @@ _public_ int sd_event_dispatch(sd_event *e) {
                 _unused_ _cleanup_(sd_event_unrefp) sd_event *ref = sd_event_ref(e);
 
                 e->state = SD_EVENT_RUNNING;
+                priority = p->priority;
+                n = prioq_size(e->pending);
+
                 r = source_dispatch(p);
+                if (r >= 0 && e->dispatch_batch)
+                        r = dispatch_batch(e, priority, n);
                 e->state = SD_EVENT_INITIAL;
                 return r;
         }
@@ -4086,6 +4195,7 @@ _public_ int sd_event_dispatch(sd_event *e) {
 
 static void event_log_delays(sd_event *e) {
         char b[ELEMENTSOF(e->delays) * DECIMAL_STR_MAX(unsigned) + 1], *p;
+        sd_event_source *s;
         size_t l, i;
 
         p = b;
@@ -4095,6 +4205,24 @@ static void event_log_delays(sd_event *e) {
                 e->delays[i] = 0;
         }
         log_debug("Event loop iterations: %s", b);
+
+        LIST_FOREACH(sources, s, e->sources) {
+                char t[FORMAT_TIMESPAN_MAX], m[FORMAT_TIMESPAN_MAX], w[FORMAT_TIMESPAN_MAX];
+
+                if (s->n_dispatched == 0)
+                        continue;
+
+                log_debug("Event source %s (type %s): %u dispatches, %s total, %s max runtime, %s max latency",
+                          strna(s->description),
+                          event_source_type_to_string(s->type),
+                          s->n_dispatched,
+                          format_timespan(t, sizeof(t), s->dispatch_usec, 1),
+                          format_timespan(m, sizeof(m), s->dispatch_max_usec, 1),
+                          format_timespan(w, sizeof(w), s->latency_max_usec, 1));
+
+                s->n_dispatched = 0;
+                s->dispatch_usec = s->dispatch_max_usec = s->latency_max_usec = 0;
+        }
 }
 
 _public_ int sd_event_run(sd_event *e, uint64_t timeout) {
@@ -4328,6 +4456,19 @@ _public_ int sd_event_get_watchdog(sd_event *e) {
         return e->watchdog;
 }
 
+int event_set_dispatch_batch(sd_event *e, bool b) {
+        assert(e);
+
+        e = event_resolve(e);
+        if (!e)
+                return -ENOPKG;
+        if (event_pid_changed(e))
+                return -ECHILD;
+
+        e->dispatch_batch = b;
+        return e->dispatch_batch;
+}
+
 _public_ int sd_event_get_iteration(sd_event *e, uint64_t *ret) {
         assert_return(e, -EINVAL);
         assert_return(e = event_resolve(e), -ENOPKG);
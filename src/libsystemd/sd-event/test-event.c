@@ -5,6 +5,7 @@
 #include "sd-event.h"
 
 #include "alloc-util.h"
+#include "event-util.h"
 #include "fd-util.h"
 #include "fs-util.h"
 #include "log.h"
@@ -713,6 +714,143 @@ static void test_simple_timeout(void) {
         assert_se(t >= usec_add(f, some_time));
 }
 
+static int rearm_time_handler(sd_event_source *s, uint64_t usec, void *userdata) {
+        unsigned *c = userdata;
+
+        *c += 1;
+        return 0;
+}
+
+static void test_rearm_timers(unsigned n) {
+        _cleanup_(sd_event_unrefp) sd_event *e = NULL;
+        _cleanup_free_ sd_event_source **sources = NULL;
+        char buf[FORMAT_TIMESPAN_MAX];
+        usec_t base, start;
+        unsigned count = 0;
+
+        log_info("/* %s(%u) */", __func__, n);
+
+        assert_se(sd_event_new(&e) >= 0);
+        assert_se(sources = new(sd_event_source*, n));
+
+        assert_se(sd_event_now(e, CLOCK_MONOTONIC, &base) >= 0);
+
+        for (unsigned i = 0; i < n; i++)
+                assert_se(sd_event_add_time(e, &sources[i], CLOCK_MONOTONIC, usec_add(base, USEC_PER_HOUR + i),
+                                            USEC_PER_MSEC, rearm_time_handler, &count) >= 0);
+
+        /* Rearming to the same time and accuracy must not change anything */
+        start = now(CLOCK_MONOTONIC);
+        for (unsigned i = 0; i < n; i++) {
+                assert_se(sd_event_source_set_time(sources[i], usec_add(base, USEC_PER_HOUR + i)) >= 0);
+                assert_se(sd_event_source_set_time_accuracy(sources[i], USEC_PER_MSEC) >= 0);
+        }
+        log_info("Rearmed %u timers to unchanged times in %s", n,
+                 format_timespan(buf, sizeof(buf), now(CLOCK_MONOTONIC) - start, 1));
+
+        assert_se(sd_event_run(e, 0) >= 0);
+        assert_se(count == 0);
+
+        /* Now let every other one elapse right away, in reverse order */
+        start = now(CLOCK_MONOTONIC);
+        for (unsigned i = 0; i < n; i += 2)
+                assert_se(sd_event_source_set_time(sources[i], usec_sub_unsigned(base, n - i)) >= 0);
+        log_info("Rearmed %u timers to new times in %s", (n + 1) / 2,
+                 format_timespan(buf, sizeof(buf), now(CLOCK_MONOTONIC) - start, 1));
+
+        while (count < (n + 1) / 2)
+                assert_se(sd_event_run(e, UINT64_MAX) >= 0);
+
+        assert_se(sd_event_run(e, 0) >= 0);
+        assert_se(count == (n + 1) / 2);
+
+        for (unsigned i = 0; i < n; i++)
+                sd_event_source_unref(sources[i]);
+}
+
+static int batch_io_handler(sd_event_source *s, int fd, uint32_t revents, void *userdata) {
+        unsigned *count = userdata;
+        char c;
+
+        assert_se(read(fd, &c, 1) == 1);
+        (*count)++;
+
+        return 0;
+}
+
+static void test_dispatch_batch_one(unsigned n, bool batch) {
+        _cleanup_(sd_event_unrefp) sd_event *e = NULL;
+        _cleanup_free_ sd_event_source **sources = NULL;
+        _cleanup_free_ int *fds = NULL;
+        uint64_t first, last;
+        unsigned count = 0, runs = 0;
+
+        assert_se(sd_event_new(&e) >= 0);
+        assert_se(event_set_dispatch_batch(e, batch) == batch);
+
+        assert_se(sources = new(sd_event_source*, n));
+        assert_se(fds = new(int, n * 2));
+
+        /* Half of the sources are at a lower priority, which must still be dispatched in a later iteration */
+        for (unsigned i = 0; i < n; i++) {
+                assert_se(pipe2(fds + i * 2, O_CLOEXEC|O_NONBLOCK) >= 0);
+                assert_se(write(fds[i * 2 + 1], "x", 1) == 1);
+                assert_se(sd_event_add_io(e, &sources[i], fds[i * 2], EPOLLIN, batch_io_handler, &count) >= 0);
+                assert_se(sd_event_source_set_priority(sources[i], i % 2) >= 0);
+        }
+
+        assert_se(sd_event_get_iteration(e, &first) >= 0);
+
+        assert_se(sd_event_run(e, 0) > 0);
+        runs++;
+        assert_se(count == (batch ? (n + 1) / 2 : 1));
+
+        while (count < n) {
+                assert_se(sd_event_run(e, 0) > 0);
+                runs++;
+        }
+
+        /* Batched sources are still accounted as separate iterations */
+        assert_se(sd_event_get_iteration(e, &last) >= 0);
+        assert_se(last - first == n);
+
+        log_info("Dispatched %u ready IO sources in %u runs with%s batching",
+                 n, runs, batch ? "" : "out");
+        assert_se(runs == (batch ? 2 : n));
+
+        for (unsigned i = 0; i < n; i++) {
+                sd_event_source_unref(sources[i]);
+                safe_close_pair(fds + i * 2);
+        }
+}
+
+static void test_dispatch_batch(unsigned n) {
+        log_info("/* %s(%u) */", __func__, n);
+
+        test_dispatch_batch_one(n, false);
+        test_dispatch_batch_one(n, true);
+}
+
+static void test_source_churn(unsigned n) {
+        _cleanup_(sd_event_unrefp) sd_event *e = NULL;
+        char buf[FORMAT_TIMESPAN_MAX];
+        usec_t start;
+
+        log_info("/* %s(%u) */", __func__, n);
+
+        assert_se(sd_event_new(&e) >= 0);
+
+        start = now(CLOCK_MONOTONIC);
+        for (unsigned i = 0; i < n; i++) {
+                sd_event_source *s;
+
+                assert_se(sd_event_add_time_relative(e, &s, CLOCK_MONOTONIC, USEC_PER_HOUR, 0, NULL, NULL) >= 0);
+                assert_se(!sd_event_source_unref(s));
+        }
+        log_info("Allocated and freed %u event sources in %s", n,
+                 format_timespan(buf, sizeof(buf), now(CLOCK_MONOTONIC) - start, 1));
+}
+
 int main(int argc, char *argv[]) {
         test_setup_logging(LOG_DEBUG);
 
@@ -731,5 +869,11 @@ int main(int argc, char *argv[]) {
 
         test_ratelimit();
 
+        test_rearm_timers(10000);
+
+        test_dispatch_batch(100);
+
+        test_source_churn(100000);
+
         return 0;
 }
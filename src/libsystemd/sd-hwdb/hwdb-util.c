@@ -76,18 +76,24 @@ static int trie_children_cmp(const struct trie_child_entry *a, const struct trie
 
 static int node_add_child(struct trie *trie, struct trie_node *node, struct trie_node *node_child, uint8_t c) {
         struct trie_child_entry *child;
+        size_t i;
 
-        /* extend array, add new entry, sort for bisection */
+        /* extend array, insert new entry at its sorted position for bisection */
         child = reallocarray(node->children, node->children_count + 1, sizeof(struct trie_child_entry));
         if (!child)
                 return -ENOMEM;
 
         node->children = child;
         trie->children_count++;
-        node->children[node->children_count].c = c;
-        node->children[node->children_count].child = node_child;
+
+        for (i = node->children_count; i > 0 && node->children[i - 1].c > c; i--)
+                node->children[i] = node->children[i - 1];
+
+        node->children[i] = (struct trie_child_entry) {
+                .c = c,
+                .child = node_child,
+        };
         node->children_count++;
-        typesafe_qsort(node->children, node->children_count, trie_children_cmp);
         trie->nodes_count++;
 
         return 0;
@@ -132,23 +138,11 @@ static int trie_values_cmp(const struct trie_value_entry *a, const struct trie_v
 }
 
 static int trie_node_add_value(struct trie *trie, struct trie_node *node,
-                               const char *key, const char *value,
-                               const char *filename, uint16_t file_priority, uint32_t line_number, bool compat) {
-        ssize_t k, v, fn = 0;
+                               size_t k, size_t v,
+                               size_t fn, uint16_t file_priority, uint32_t line_number) {
         struct trie_value_entry *val;
-
-        k = strbuf_add_string(trie->strings, key, strlen(key));
-        if (k < 0)
-                return k;
-        v = strbuf_add_string(trie->strings, value, strlen(value));
-        if (v < 0)
-                return v;
-
-        if (!compat) {
-                fn = strbuf_add_string(trie->strings, filename, strlen(filename));
-                if (fn < 0)
-                        return fn;
-        }
+        const char *key;
+        size_t i;
 
         if (node->values_count) {
                 struct trie_value_entry search = {
@@ -168,13 +162,18 @@ static int trie_node_add_value(struct trie *trie, struct trie_node *node,
                 }
         }
 
-        /* extend array, add new entry, sort for bisection */
+        /* extend array, insert new entry at its sorted position for bisection */
         val = reallocarray(node->values, node->values_count + 1, sizeof(struct trie_value_entry));
         if (!val)
                 return -ENOMEM;
         trie->values_count++;
         node->values = val;
-        node->values[node->values_count] = (struct trie_value_entry) {
+
+        key = trie->strings->buf + k;
+        for (i = node->values_count; i > 0 && strcmp(trie->strings->buf + node->values[i - 1].key_off, key) > 0; i--)
+                node->values[i] = node->values[i - 1];
+
+        node->values[i] = (struct trie_value_entry) {
                 .key_off = k,
                 .value_off = v,
                 .filename_off = fn,
@@ -182,13 +181,12 @@ static int trie_node_add_value(struct trie *trie, struct trie_node *node,
                 .line_number = line_number,
         };
         node->values_count++;
-        typesafe_qsort_r(node->values, node->values_count, trie_values_cmp, trie);
         return 0;
 }
 
 static int trie_insert(struct trie *trie, struct trie_node *node, const char *search,
-                       const char *key, const char *value,
-                       const char *filename, uint16_t file_priority, uint32_t line_number, bool compat) {
+                       size_t key_off, size_t value_off,
+                       size_t filename_off, uint16_t file_priority, uint32_t line_number) {
         int r = 0;
 
         for (size_t i = 0;; i++) {
@@ -241,7 +239,7 @@ static int trie_insert(struct trie *trie, struct trie_node *node, const char *se
 
                 c = search[i];
                 if (c == '\0')
-                        return trie_node_add_value(trie, node, key, value, filename, file_priority, line_number, compat);
+                        return trie_node_add_value(trie, node, key_off, value_off, filename_off, file_priority, line_number);
 
                 child = node_lookup(node, c);
                 if (!child) {
@@ -266,7 +264,7 @@ static int trie_insert(struct trie *trie, struct trie_node *node, const char *se
                                 return r;
 
                         child = TAKE_PTR(new_child);
-                        return trie_node_add_value(trie, child, key, value, filename, file_priority, line_number, compat);
+                        return trie_node_add_value(trie, child, key_off, value_off, filename_off, file_priority, line_number);
                 }
 
                 node = child;
@@ -432,8 +430,9 @@ static int trie_store(struct trie *trie, const char *filename, bool compat) {
 }
 
 static int insert_data(struct trie *trie, char **match_list, char *line, const char *filename,
-                       uint16_t file_priority, uint32_t line_number, bool compat) {
+                       size_t filename_off, uint16_t file_priority, uint32_t line_number) {
         char *value, **entry;
+        ssize_t k, v;
 
         assert(line[0] == ' ');
 
@@ -454,8 +453,16 @@ static int insert_data(struct trie *trie, char **match_list, char *line, const c
                                   "Empty key in \"%s=%s\", ignoring.",
                                   line, value);
 
+        /* Add the strings once, they are shared by all matches of the record */
+        k = strbuf_add_string(trie->strings, line, strlen(line));
+        if (k < 0)
+                return k;
+        v = strbuf_add_string(trie->strings, value, strlen(value));
+        if (v < 0)
+                return v;
+
         STRV_FOREACH(entry, match_list)
-                trie_insert(trie, trie->root, *entry, line, value, filename, file_priority, line_number, compat);
+                trie_insert(trie, trie->root, *entry, k, v, filename_off, file_priority, line_number);
 
         return 0;
 }
@@ -469,12 +476,19 @@ static int import_file(struct trie *trie, const char *filename, uint16_t file_pr
         _cleanup_fclose_ FILE *f = NULL;
         _cleanup_strv_free_ char **match_list = NULL;
         uint32_t line_number = 0;
+        ssize_t filename_off = 0;
         int r, err;
 
         f = fopen(filename, "re");
         if (!f)
                 return -errno;
 
+        if (!compat) {
+                filename_off = strbuf_add_string(trie->strings, filename, strlen(filename));
+                if (filename_off < 0)
+                        return filename_off;
+        }
+
         for (;;) {
                 _cleanup_free_ char *line = NULL;
                 size_t len;
@@ -543,7 +557,7 @@ static int import_file(struct trie *trie, const char *filename, uint16_t file_pr
 
                         /* first data */
                         state = HW_DATA;
-                        err = insert_data(trie, match_list, line, filename, file_priority, line_number, compat);
+                        err = insert_data(trie, match_list, line, filename, filename_off, file_priority, line_number);
                         if (err < 0)
                                 r = err;
                         break;
@@ -564,7 +578,7 @@ static int import_file(struct trie *trie, const char *filename, uint16_t file_pr
                                 break;
                         }
 
-                        err = insert_data(trie, match_list, line, filename, file_priority, line_number, compat);
+                        err = insert_data(trie, match_list, line, filename, filename_off, file_priority, line_number);
                         if (err < 0)
                                 r = err;
                         break;
@@ -194,6 +194,45 @@ static int hwdb_add_property(sd_hwdb *hwdb, const struct trie_value_entry_f *ent
         return 0;
 }
 
+static bool linebuf_glob_prefix_may_match(struct linebuf *buf, const char *search) {
+        const char *pattern;
+        bool bracket = false;
+        bool r;
+
+        /* Checks whether any pattern starting with the glob in the buffer can match the search string,
+         * i.e. whether the buffer with a "*" appended matches. That only holds if the buffer does not end
+         * in the middle of a bracket expression or an escape sequence, otherwise assume it may match. */
+
+        for (size_t i = 0; i < buf->len; i++) {
+                char c = buf->bytes[i];
+
+                if (bracket) {
+                        if (c == '\\')
+                                return true;
+                        if (c == ']' && !(buf->bytes[i - 1] == '[' || (buf->bytes[i - 1] == '!' && buf->bytes[i - 2] == '[')))
+                                bracket = false;
+                } else if (c == '[')
+                        bracket = true;
+                else if (c == '\\') {
+                        if (i + 1 >= buf->len)
+                                return true;
+                        i++;
+                }
+        }
+
+        if (bracket)
+                return true;
+
+        if (!linebuf_add_char(buf, '*'))
+                return true;
+
+        pattern = linebuf_get(buf);
+        r = !pattern || fnmatch(pattern, search, 0) == 0;
+
+        linebuf_rem_char(buf);
+        return r;
+}
+
 static int trie_fnmatch_f(sd_hwdb *hwdb, const struct trie_node_f *node, size_t p,
                           struct linebuf *buf, const char *search) {
         size_t len;
@@ -205,6 +244,12 @@ static int trie_fnmatch_f(sd_hwdb *hwdb, const struct trie_node_f *node, size_t
         len = strlen(prefix + p);
         linebuf_add(buf, prefix + p, len);
 
+        /* If no pattern in this subtree can match, don't bother walking it */
+        if (node->children_count > 0 && !linebuf_glob_prefix_may_match(buf, search)) {
+                linebuf_rem(buf, len);
+                return 0;
+        }
+
         for (i = 0; i < node->children_count; i++) {
                 const struct trie_child_entry_f *child = trie_node_child(hwdb, node, i);
 
@@ -1,6 +1,8 @@
 /* SPDX-License-Identifier: LGPL-2.1-or-later */
 
 #include <inttypes.h>
+#include <pthread.h>
+#include <sched.h>
 #include <stdlib.h>
 #include <sys/mman.h>
 #include <sys/types.h>
@@ -52,6 +54,116 @@ static int zstd_ret_to_errno(size_t ret) {
                 return -EBADMSG;
         }
 }
+
+/* Inputs smaller than this are compressed on the calling thread only, spinning up workers isn't worth it */
+#define ZSTD_STREAM_WORKERS_SIZE_MIN (64U*1024U*1024U)
+
+/* Upper bound for the number of worker threads used for compressing large streams */
+#define ZSTD_STREAM_WORKERS_MAX 4
+
+static int zstd_stream_workers(int fdf) {
+        cpu_set_t mask;
+        struct stat st;
+
+        /* Compressing large files (read: coredumps) takes a long time with a single thread. If libzstd was
+         * built with multi-threading support, spread the work over the CPUs we may run on. */
+
+        if (fstat(fdf, &st) < 0 || !S_ISREG(st.st_mode) || st.st_size < ZSTD_STREAM_WORKERS_SIZE_MIN)
+                return 0;
+
+        if (sched_getaffinity(0, sizeof(mask), &mask) < 0)
+                return 0;
+
+        return MIN(CPU_COUNT(&mask), ZSTD_STREAM_WORKERS_MAX);
+}
+
+/* Journal data objects are small, hence setting up a fresh ZSTD context for each of them costs more than the
+ * actual (de)compression. Keep one context of each kind per thread around, and reuse it. The contexts are
+ * hung off a thread-specific key, so that they are freed when the thread exits. */
+typedef struct ZstdContexts {
+        ZSTD_CCtx *cctx;
+        ZSTD_DCtx *dctx;
+} ZstdContexts;
+
+static pthread_once_t zstd_contexts_once = PTHREAD_ONCE_INIT;
+static pthread_key_t zstd_contexts_key;
+static bool zstd_contexts_key_valid = false;
+
+static void zstd_contexts_free(void *p) {
+        ZstdContexts *c = p;
+
+        if (!c)
+                return;
+
+        ZSTD_freeCCtx(c->cctx);
+        ZSTD_freeDCtx(c->dctx);
+        free(c);
+}
+
+static void zstd_contexts_key_init(void) {
+        zstd_contexts_key_valid = pthread_key_create(&zstd_contexts_key, zstd_contexts_free) == 0;
+}
+
+_destructor_ static void zstd_contexts_key_done(void) {
+        /* When we are unloaded (or the process exits), free the contexts of the current thread and delete
+         * the key, so that the destructor of other threads doesn't point into unmapped code. */
+
+        if (!zstd_contexts_key_valid)
+                return;
+
+        zstd_contexts_free(pthread_getspecific(zstd_contexts_key));
+        (void) pthread_key_delete(zstd_contexts_key);
+        zstd_contexts_key_valid = false;
+}
+
+static ZstdContexts* zstd_contexts_get(void) {
+        ZstdContexts *c;
+
+        if (pthread_once(&zstd_contexts_once, zstd_contexts_key_init) != 0 || !zstd_contexts_key_valid)
+                return NULL;
+
+        c = pthread_getspecific(zstd_contexts_key);
+        if (c)
+                return c;
+
+        c = new0(ZstdContexts, 1);
+        if (!c)
+                return NULL;
+
+        if (pthread_setspecific(zstd_contexts_key, c) != 0)
+                return mfree(c);
+
+        return c;
+}
+
+static ZSTD_CCtx* zstd_cctx_get(void) {
+        ZstdContexts *c;
+
+        c = zstd_contexts_get();
+        if (!c)
+                return NULL;
+
+        if (!c->cctx)
+                c->cctx = ZSTD_createCCtx();
+
+        return c->cctx;
+}
+
+static ZSTD_DCtx* zstd_dctx_get(void) {
+        ZstdContexts *c;
+
+        c = zstd_contexts_get();
+        if (!c)
+                return NULL;
+
+        /* A previous user might have stopped decompressing in the middle of a frame, hence reset */
+        if (c->dctx)
+                (void) ZSTD_DCtx_reset(c->dctx, ZSTD_reset_session_only);
+        else
+                c->dctx = ZSTD_createDCtx();
+
+        return c->dctx;
+}
 #endif
 
 #define ALIGN_8(l) ALIGN_TO(l, sizeof(size_t))
@@ -138,6 +250,7 @@ int compress_blob_zstd(
                 const void *src, uint64_t src_size,
                 void *dst, size_t dst_alloc_size, size_t *dst_size) {
 #if HAVE_ZSTD
+        ZSTD_CCtx *cctx;
         size_t k;
 
         assert(src);
@@ -146,7 +259,11 @@ int compress_blob_zstd(
         assert(dst_alloc_size > 0);
         assert(dst_size);
 
-        k = ZSTD_compress(dst, dst_alloc_size, src, src_size, 0);
+        cctx = zstd_cctx_get();
+        if (!cctx)
+                return -ENOMEM;
+
+        k = ZSTD_compressCCtx(cctx, dst, dst_alloc_size, src, src_size, 0);
         if (ZSTD_isError(k))
                 return zstd_ret_to_errno(k);
 
@@ -283,7 +400,7 @@ int decompress_blob_zstd(
         if (!(greedy_realloc(dst, dst_alloc_size, MAX(ZSTD_DStreamOutSize(), size), 1)))
                 return -ENOMEM;
 
-        _cleanup_(ZSTD_freeDCtxp) ZSTD_DCtx *dctx = ZSTD_createDCtx();
+        ZSTD_DCtx *dctx = zstd_dctx_get();
         if (!dctx)
                 return -ENOMEM;
 
@@ -472,7 +589,7 @@ int decompress_startswith_zstd(
         if (size < prefix_len + 1)
                 return 0; /* Decompressed text too short to match the prefix and extra */
 
-        _cleanup_(ZSTD_freeDCtxp) ZSTD_DCtx *dctx = ZSTD_createDCtx();
+        ZSTD_DCtx *dctx = zstd_dctx_get();
         if (!dctx)
                 return -ENOMEM;
 
@@ -846,6 +963,7 @@ int compress_stream_zstd(int fdf, int fdt, uint64_t max_bytes) {
         size_t in_allocsize, out_allocsize;
         size_t z;
         uint64_t left = max_bytes, in_bytes = 0;
+        int workers;
 
         assert(fdf >= 0);
         assert(fdt >= 0);
@@ -863,6 +981,13 @@ int compress_stream_zstd(int fdf, int fdt, uint64_t max_bytes) {
         if (ZSTD_isError(z))
                 log_debug("Failed to enable ZSTD checksum, ignoring: %s", ZSTD_getErrorName(z));
 
+        workers = zstd_stream_workers(fdf);
+        if (workers > 1) {
+                z = ZSTD_CCtx_setParameter(cctx, ZSTD_c_nbWorkers, workers);
+                if (ZSTD_isError(z))
+                        log_debug("Failed to enable %i ZSTD worker threads, ignoring: %s", workers, ZSTD_getErrorName(z));
+        }
+
         /* This loop read from the input file, compresses that entire chunk,
          * and writes all output produced to the output file.
          */
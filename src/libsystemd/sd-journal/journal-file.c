@@ -26,6 +26,7 @@
 #include "lookup3.h"
 #include "memory-util.h"
 #include "path-util.h"
+#include "prioq.h"
 #include "random-util.h"
 #include "set.h"
 #include "sort-util.h"
@@ -73,6 +74,19 @@
 /* How many entries to keep in the entry array chain cache at max */
 #define CHAIN_CACHE_MAX 20
 
+/* Writers link each new entry into the chain of every data object it references, hence keep the tails
+ * of more chains around for writable files */
+#define CHAIN_CACHE_MAX_WRITABLE 256
+
+/* Number of slots in the cache of recently appended data objects, and the largest payload we remember */
+#define DATA_CACHE_SLOTS 128U
+#define DATA_CACHE_PAYLOAD_MAX 256U
+
+/* How much to read ahead of sequential scans through a journal file, and how many consecutive steps in the
+ * same direction we need to see before we consider a scan sequential */
+#define READAHEAD_SIZE (4ULL*1024ULL*1024ULL)
+#define READAHEAD_STEPS_MIN 16U
+
 /* How much to increase the journal file size at once each time we allocate something new. */
 #define FILE_SIZE_INCREASE (8 * 1024 * 1024ULL)          /* 8MB */
 
@@ -122,6 +136,11 @@ static void journal_file_set_offline_internal(JournalFile *f) {
 
                         f->header->state = f->archive ? STATE_ARCHIVED : STATE_OFFLINE;
                         (void) fsync(f->fd);
+
+                        /* If we were archived, the file was renamed. Sync that to disk here too, so that the
+                         * caller doesn't have to wait for the directory to be synced. */
+                        if (f->archive)
+                                (void) fsync_directory_of_file(f->fd);
                         break;
 
                 case OFFLINE_OFFLINING:
@@ -366,7 +385,7 @@ JournalFile* journal_file_close(JournalFile *f) {
 #endif
 
         if (f->post_change_timer) {
-                if (sd_event_source_get_enabled(f->post_change_timer, NULL) > 0)
+                if (f->post_change_pending)
                         journal_file_post_change(f);
 
                 sd_event_source_disable_unref(f->post_change_timer);
@@ -374,6 +393,8 @@ JournalFile* journal_file_close(JournalFile *f) {
 
         journal_file_set_offline(f, true);
 
+        journal_file_data_cache_stats_log_debug(f);
+
         if (f->mmap && f->cache_fd)
                 mmap_cache_free_fd(f->mmap, f->cache_fd);
 
@@ -397,6 +418,8 @@ JournalFile* journal_file_close(JournalFile *f) {
 
         ordered_hashmap_free_free(f->chain_cache);
 
+        free(f->data_cache);
+
 #if HAVE_COMPRESSION
         free(f->compress_buffer);
 #endif
@@ -1655,12 +1678,83 @@ static int journal_file_append_field(
         return 0;
 }
 
+struct DataCacheItem {
+        uint64_t hash;
+        uint64_t offset;          /* 0 if the slot is unused */
+        uint64_t size;
+        uint8_t payload[DATA_CACHE_PAYLOAD_MAX];
+};
+
+static uint64_t data_cache_get(JournalFile *f, const void *data, uint64_t size, uint64_t hash) {
+        DataCacheItem *i;
+
+        assert(f);
+
+        if (size > DATA_CACHE_PAYLOAD_MAX)
+                return 0;
+
+        if (f->data_cache) {
+                i = f->data_cache + hash % DATA_CACHE_SLOTS;
+
+                if (i->offset > 0 &&
+                    i->hash == hash &&
+                    i->size == size &&
+                    memcmp_safe(i->payload, data, size) == 0) {
+                        f->n_data_cache_hit++;
+                        return i->offset;
+                }
+        }
+
+        f->n_data_cache_miss++;
+        return 0;
+}
+
+static void data_cache_put(JournalFile *f, const void *data, uint64_t size, uint64_t hash, uint64_t offset) {
+        DataCacheItem *i;
+
+        assert(f);
+        assert(offset > 0);
+
+        /* Consecutive entries tend to share most of their fields (_HOSTNAME=, _BOOT_ID=, _SYSTEMD_UNIT=, …),
+         * hence remember where we found or placed the most recent data objects, so that we don't have to
+         * walk the hash chains for them again. Data objects never move, so entries never go stale. The
+         * cache is direct-mapped: a new object simply replaces whatever was in its slot before. */
+
+        if (size > DATA_CACHE_PAYLOAD_MAX)
+                return;
+
+        if (!f->data_cache) {
+                f->data_cache = new(DataCacheItem, DATA_CACHE_SLOTS);
+                if (!f->data_cache)
+                        return;
+
+                for (unsigned k = 0; k < DATA_CACHE_SLOTS; k++)
+                        f->data_cache[k].offset = 0;
+        }
+
+        i = f->data_cache + hash % DATA_CACHE_SLOTS;
+        i->hash = hash;
+        i->offset = offset;
+        i->size = size;
+        memcpy_safe(i->payload, data, size);
+}
+
+void journal_file_data_cache_stats_log_debug(JournalFile *f) {
+        assert(f);
+
+        if (f->n_data_cache_hit + f->n_data_cache_miss == 0)
+                return;
+
+        log_debug("%s: data object cache statistics: %" PRIu64 " hit, %" PRIu64 " miss",
+                  f->path, f->n_data_cache_hit, f->n_data_cache_miss);
+}
+
 static int journal_file_append_data(
                 JournalFile *f,
-                const void *data, uint64_t size,
-                Object **ret, uint64_t *ret_offset) {
+                const void *data, uint64_t size, uint64_t hash,
+                uint64_t *ret_offset) {
 
-        uint64_t hash, p;
+        uint64_t p;
         uint64_t osize;
         Object *o;
         int r, compression = 0;
@@ -1669,15 +1763,19 @@ static int journal_file_append_data(
         assert(f);
         assert(data || size == 0);
 
-        hash = journal_file_hash_data(f, data, size);
+        p = data_cache_get(f, data, size, hash);
+        if (p > 0) {
+                if (ret_offset)
+                        *ret_offset = p;
+
+                return 0;
+        }
 
-        r = journal_file_find_data_object_with_hash(f, data, size, hash, &o, &p);
+        r = journal_file_find_data_object_with_hash(f, data, size, hash, NULL, &p);
         if (r < 0)
                 return r;
         if (r > 0) {
-
-                if (ret)
-                        *ret = o;
+                data_cache_put(f, data, size, hash, p);
 
                 if (ret_offset)
                         *ret_offset = p;
@@ -1747,8 +1845,7 @@ static int journal_file_append_data(
                 fo->field.head_data_offset = le64toh(p);
         }
 
-        if (ret)
-                *ret = o;
+        data_cache_put(f, data, size, hash, p);
 
         if (ret_offset)
                 *ret_offset = p;
@@ -1800,12 +1897,62 @@ uint64_t journal_file_hash_table_n_items(Object *o) {
         return (sz - offsetof(Object, hash_table.items)) / sizeof(HashItem);
 }
 
+typedef struct ChainCacheItem {
+        uint64_t first; /* the array at the beginning of the chain */
+        uint64_t array; /* the cached array */
+        uint64_t begin; /* the first item in the cached array */
+        uint64_t total; /* the total number of items in all arrays before this one in the chain */
+        uint64_t last_index; /* the last index we looked at, to optimize locality when bisecting */
+} ChainCacheItem;
+
+static void chain_cache_put(
+                JournalFile *f,
+                ChainCacheItem *ci,
+                uint64_t first,
+                uint64_t array,
+                uint64_t begin,
+                uint64_t total,
+                uint64_t last_index) {
+
+        OrderedHashmap *h = f->chain_cache;
+
+        if (!ci) {
+                /* If the chain item to cache for this chain is the
+                 * first one it's not worth caching anything */
+                if (array == first)
+                        return;
+
+                if (ordered_hashmap_size(h) >= (f->writable ? CHAIN_CACHE_MAX_WRITABLE : CHAIN_CACHE_MAX)) {
+                        ci = ordered_hashmap_steal_first(h);
+                        assert(ci);
+                } else {
+                        ci = new(ChainCacheItem, 1);
+                        if (!ci)
+                                return;
+                }
+
+                ci->first = first;
+
+                if (ordered_hashmap_put(h, &ci->first, ci) < 0) {
+                        free(ci);
+                        return;
+                }
+        } else
+                assert(ci->first == first);
+
+        ci->array = array;
+        ci->begin = begin;
+        ci->total = total;
+        ci->last_index = last_index;
+}
+
 static int link_entry_into_array(JournalFile *f,
                                  le64_t *first,
                                  le64_t *idx,
                                  uint64_t p) {
         int r;
-        uint64_t n = 0, ap = 0, q, i, a, hidx;
+        uint64_t n = 0, ap = 0, q, i, a, hidx, fa, t = 0;
+        ChainCacheItem *ci;
         Object *o;
 
         assert(f);
@@ -1814,8 +1961,18 @@ static int link_entry_into_array(JournalFile *f,
         assert(idx);
         assert(p > 0);
 
-        a = le64toh(*first);
+        a = fa = le64toh(*first);
         i = hidx = le64toh(READ_NOW(*idx));
+
+        /* All arrays but the last one in a chain are full, hence if we linked into this chain before, we
+         * can skip straight to where we left off, instead of walking the whole chain again. */
+        ci = fa > 0 ? ordered_hashmap_get(f->chain_cache, &fa) : NULL;
+        if (ci && i >= ci->total) {
+                a = ci->array;
+                i -= ci->total;
+                t = ci->total;
+        }
+
         while (a > 0) {
 
                 r = journal_file_move_to_object(f, OBJECT_ENTRY_ARRAY, a, &o);
@@ -1826,10 +1983,12 @@ static int link_entry_into_array(JournalFile *f,
                 if (i < n) {
                         o->entry_array.items[i] = htole64(p);
                         *idx = htole64(hidx + 1);
+                        chain_cache_put(f, ci, fa, a, le64toh(o->entry_array.items[0]), t, UINT64_MAX);
                         return 0;
                 }
 
                 i -= n;
+                t += n;
                 ap = a;
                 a = le64toh(o->entry_array.next_entry_array_offset);
         }
@@ -1864,6 +2023,8 @@ static int link_entry_into_array(JournalFile *f,
                         return r;
 
                 o->entry_array.next_entry_array_offset = htole64(q);
+
+                chain_cache_put(f, ci, fa, q, i == 0 ? p : 0, t, UINT64_MAX);
         }
 
         if (JOURNAL_HEADER_CONTAINS(f->header, n_entry_arrays))
@@ -2041,10 +2202,35 @@ void journal_file_post_change(JournalFile *f) {
                 log_debug_errno(errno, "Failed to truncate file to its own size: %m");
 }
 
+static void start_post_change_timer(JournalFile *f) {
+        int r;
+
+        assert(f);
+        assert(f->post_change_timer);
+
+        r = sd_event_source_set_time_relative(f->post_change_timer, f->post_change_timer_period);
+        if (r < 0) {
+                log_debug_errno(r, "Failed to set time for scheduling ftruncate: %m");
+                return;
+        }
+
+        r = sd_event_source_set_enabled(f->post_change_timer, SD_EVENT_ONESHOT);
+        if (r < 0)
+                log_debug_errno(r, "Failed to enable scheduled ftruncate: %m");
+}
+
 static int post_change_thunk(sd_event_source *timer, uint64_t usec, void *userdata) {
-        assert(userdata);
+        JournalFile *f = userdata;
 
-        journal_file_post_change(userdata);
+        assert(f);
+
+        /* If there were more changes while the timer was running, post them now, and keep coalescing
+         * until things calm down again. */
+        if (f->post_change_pending) {
+                f->post_change_pending = false;
+                journal_file_post_change(f);
+                start_post_change_timer(f);
+        }
 
         return 1;
 }
@@ -2058,28 +2244,22 @@ static void schedule_post_change(JournalFile *f) {
         r = sd_event_source_get_enabled(f->post_change_timer, NULL);
         if (r < 0) {
                 log_debug_errno(r, "Failed to get ftruncate timer state: %m");
-                goto fail;
-        }
-        if (r > 0)
-                return;
 
-        r = sd_event_source_set_time_relative(f->post_change_timer, f->post_change_timer_period);
-        if (r < 0) {
-                log_debug_errno(r, "Failed to set time for scheduling ftruncate: %m");
-                goto fail;
+                /* On failure, let's simply post the change immediately. */
+                journal_file_post_change(f);
+                return;
         }
-
-        r = sd_event_source_set_enabled(f->post_change_timer, SD_EVENT_ONESHOT);
-        if (r < 0) {
-                log_debug_errno(r, "Failed to enable scheduled ftruncate: %m");
-                goto fail;
+        if (r > 0) {
+                /* We posted a change recently, coalesce this one with any further ones until the timer
+                 * elapses. */
+                f->post_change_pending = true;
+                return;
         }
 
-        return;
-
-fail:
-        /* On failure, let's simply post the change immediately. */
+        /* Nothing was posted recently, hence post right away, so that readers following the journal see
+         * isolated entries without delay. Only then start coalescing. */
         journal_file_post_change(f);
+        start_post_change_timer(f);
 }
 
 /* Enable coalesced change posting in a timer on the provided sd_event instance */
@@ -2151,10 +2331,11 @@ int journal_file_append_entry(
         items = newa(EntryItem, MAX(1u, n_iovec));
 
         for (unsigned i = 0; i < n_iovec; i++) {
-                uint64_t p;
-                Object *o;
+                uint64_t p, h;
+
+                h = journal_file_hash_data(f, iovec[i].iov_base, iovec[i].iov_len);
 
-                r = journal_file_append_data(f, iovec[i].iov_base, iovec[i].iov_len, &o, &p);
+                r = journal_file_append_data(f, iovec[i].iov_base, iovec[i].iov_len, h, &p);
                 if (r < 0)
                         return r;
 
@@ -2170,10 +2351,10 @@ int journal_file_append_entry(
                 if (JOURNAL_HEADER_KEYED_HASH(f->header))
                         xor_hash ^= jenkins_hash64(iovec[i].iov_base, iovec[i].iov_len);
                 else
-                        xor_hash ^= le64toh(o->data.hash);
+                        xor_hash ^= h;
 
                 items[i].object_offset = htole64(p);
-                items[i].hash = o->data.hash;
+                items[i].hash = htole64(h);
         }
 
         /* Order by the position on disk, in order to improve seek
@@ -2198,53 +2379,6 @@ int journal_file_append_entry(
         return r;
 }
 
-typedef struct ChainCacheItem {
-        uint64_t first; /* the array at the beginning of the chain */
-        uint64_t array; /* the cached array */
-        uint64_t begin; /* the first item in the cached array */
-        uint64_t total; /* the total number of items in all arrays before this one in the chain */
-        uint64_t last_index; /* the last index we looked at, to optimize locality when bisecting */
-} ChainCacheItem;
-
-static void chain_cache_put(
-                OrderedHashmap *h,
-                ChainCacheItem *ci,
-                uint64_t first,
-                uint64_t array,
-                uint64_t begin,
-                uint64_t total,
-                uint64_t last_index) {
-
-        if (!ci) {
-                /* If the chain item to cache for this chain is the
-                 * first one it's not worth caching anything */
-                if (array == first)
-                        return;
-
-                if (ordered_hashmap_size(h) >= CHAIN_CACHE_MAX) {
-                        ci = ordered_hashmap_steal_first(h);
-                        assert(ci);
-                } else {
-                        ci = new(ChainCacheItem, 1);
-                        if (!ci)
-                                return;
-                }
-
-                ci->first = first;
-
-                if (ordered_hashmap_put(h, &ci->first, ci) < 0) {
-                        free(ci);
-                        return;
-                }
-        } else
-                assert(ci->first == first);
-
-        ci->array = array;
-        ci->begin = begin;
-        ci->total = total;
-        ci->last_index = last_index;
-}
-
 static int generic_array_get(
                 JournalFile *f,
                 uint64_t first,
@@ -2290,7 +2424,7 @@ static int generic_array_get(
 
 found:
         /* Let's cache this item for the next invocation */
-        chain_cache_put(f->chain_cache, ci, first, a, le64toh(o->entry_array.items[0]), t, i);
+        chain_cache_put(f, ci, first, a, le64toh(o->entry_array.items[0]), t, i);
 
         r = journal_file_move_to_object(f, OBJECT_ENTRY, p, &o);
         if (r < 0)
@@ -2533,7 +2667,7 @@ found:
                 return 0;
 
         /* Let's cache this item for the next invocation */
-        chain_cache_put(f->chain_cache, ci, first, a, le64toh(array->entry_array.items[0]), t, subtract_one ? (i > 0 ? i-1 : UINT64_MAX) : i);
+        chain_cache_put(f, ci, first, a, le64toh(array->entry_array.items[0]), t, subtract_one ? (i > 0 ? i-1 : UINT64_MAX) : i);
 
         if (subtract_one && i == 0)
                 p = last_p;
@@ -2887,6 +3021,55 @@ static bool check_properly_ordered(uint64_t new_offset, uint64_t old_offset, dir
                 new_offset < old_offset;
 }
 
+static void journal_file_readahead(JournalFile *f, uint64_t offset, direction_t direction) {
+        uint64_t start, end;
+
+        assert(f);
+
+        /* Entries and the data objects they reference are mostly appended in order, hence when iterating
+         * through a file entry by entry we access it more or less sequentially. Faulting that in page by page
+         * is slow on rotating media and network block devices, hence tell the kernel what's coming next. */
+
+        if (f->writable)
+                return;
+
+        if (f->readahead_direction != direction) {
+                f->readahead_direction = direction;
+                f->readahead_steps = 0;
+        }
+
+        if (f->readahead_steps < READAHEAD_STEPS_MIN) {
+                f->readahead_steps++;
+                return;
+        }
+
+        /* Still well within the range we asked for last time, or did that already reach the end of the file? */
+        if (offset >= f->readahead_start && offset < f->readahead_end) {
+                if (direction == DIRECTION_DOWN) {
+                        if (f->readahead_end - offset > READAHEAD_SIZE / 2 ||
+                            f->readahead_end >= (uint64_t) f->last_stat.st_size)
+                                return;
+                } else {
+                        if (offset - f->readahead_start > READAHEAD_SIZE / 2 ||
+                            f->readahead_start == 0)
+                                return;
+                }
+        }
+
+        if (direction == DIRECTION_DOWN) {
+                start = offset;
+                end = offset + READAHEAD_SIZE;
+        } else {
+                start = offset > READAHEAD_SIZE ? offset - READAHEAD_SIZE : 0;
+                end = offset;
+        }
+
+        (void) posix_fadvise(f->fd, start, end - start, POSIX_FADV_WILLNEED);
+
+        f->readahead_start = start;
+        f->readahead_end = end;
+}
+
 int journal_file_next_entry(
                 JournalFile *f,
                 uint64_t p,
@@ -2948,6 +3131,8 @@ int journal_file_next_entry(
                                        "%s: entry array not properly ordered at entry %" PRIu64,
                                        f->path, i);
 
+        journal_file_readahead(f, ofs, direction);
+
         if (ret_offset)
                 *ret_offset = ofs;
 
@@ -3436,6 +3621,7 @@ int journal_file_open(
         *f = (JournalFile) {
                 .fd = fd,
                 .mode = mode,
+                .prioq_idx = PRIOQ_IDX_NULL,
 
                 .flags = flags,
                 .writable = (flags & O_ACCMODE) != O_RDONLY,
@@ -3604,6 +3790,11 @@ int journal_file_open(
                         goto fail;
         }
 
+        /* Archived files never change again, hence when reading them we can map them in one go instead of
+         * in many small windows */
+        if (!f->writable && f->header->state == STATE_ARCHIVED)
+                mmap_cache_fd_set_map_whole(f->cache_fd, true);
+
 #if HAVE_GCRYPT
         if (!newly_created && f->writable) {
                 r = journal_file_fss_load(f);
@@ -3704,8 +3895,8 @@ int journal_file_archive(JournalFile *f) {
         if (rename(f->path, p) < 0 && errno != ENOENT)
                 return -errno;
 
-        /* Sync the rename to disk */
-        (void) fsync_directory_of_file(f->fd);
+        /* The rename is synced to disk when the file is taken offline, which usually happens in a separate
+         * thread, see journal_file_set_offline_internal(). */
 
         /* Set as archive so offlining commits w/state=STATE_ARCHIVED. Previously we would set old_file->header->state
          * to STATE_ARCHIVED directly here, but journal_file_set_offline() short-circuits when state != STATE_ONLINE,
@@ -3888,11 +4079,10 @@ int journal_file_copy_entry(JournalFile *from, JournalFile *to, Object *o, uint6
         items = newa(EntryItem, MAX(1u, n));
 
         for (uint64_t i = 0; i < n; i++) {
-                uint64_t l, h;
+                uint64_t l, h, hash;
                 le64_t le_hash;
                 size_t t;
                 void *data;
-                Object *u;
 
                 q = le64toh(o->entry.items[i].object_offset);
                 le_hash = o->entry.items[i].hash;
@@ -3932,17 +4122,19 @@ int journal_file_copy_entry(JournalFile *from, JournalFile *to, Object *o, uint6
                 } else
                         data = o->data.payload;
 
-                r = journal_file_append_data(to, data, l, &u, &h);
+                hash = journal_file_hash_data(to, data, l);
+
+                r = journal_file_append_data(to, data, l, hash, &h);
                 if (r < 0)
                         return r;
 
                 if (JOURNAL_HEADER_KEYED_HASH(to->header))
                         xor_hash ^= jenkins_hash64(data, l);
                 else
-                        xor_hash ^= le64toh(u->data.hash);
+                        xor_hash ^= hash;
 
                 items[i].object_offset = htole64(h);
-                items[i].hash = u->data.hash;
+                items[i].hash = htole64(hash);
 
                 r = journal_file_move_to_object(from, OBJECT_ENTRY, p, &o);
                 if (r < 0)
@@ -56,6 +56,8 @@ typedef enum OfflineState {
         OFFLINE_DONE
 } OfflineState;
 
+typedef struct DataCacheItem DataCacheItem;
+
 typedef struct JournalFile {
         int fd;
         MMapFileDescriptor *cache_fd;
@@ -72,10 +74,12 @@ typedef struct JournalFile {
         bool close_fd:1;
         bool archive:1;
         bool keyed_hash:1;
+        bool post_change_pending:1;
 
         direction_t last_direction;
         LocationType location_type;
         uint64_t last_n_entries;
+        unsigned prioq_idx;
 
         char *path;
         struct stat last_stat;
@@ -100,6 +104,15 @@ typedef struct JournalFile {
 
         OrderedHashmap *chain_cache;
 
+        direction_t readahead_direction;
+        unsigned readahead_steps;
+        uint64_t readahead_start;
+        uint64_t readahead_end;
+
+        DataCacheItem *data_cache;
+        uint64_t n_data_cache_hit;
+        uint64_t n_data_cache_miss;
+
         pthread_t offline_thread;
         volatile OfflineState offline_state;
 
@@ -244,6 +257,7 @@ int journal_file_copy_entry(JournalFile *from, JournalFile *to, Object *o, uint6
 
 void journal_file_dump(JournalFile *f);
 void journal_file_print_header(JournalFile *f);
+void journal_file_data_cache_stats_log_debug(JournalFile *f);
 
 int journal_file_archive(JournalFile *f);
 JournalFile* journal_initiate_close(JournalFile *f, Set *deferred_closes);
@@ -12,6 +12,7 @@
 #include "journal-def.h"
 #include "journal-file.h"
 #include "list.h"
+#include "prioq.h"
 #include "set.h"
 
 typedef struct Match Match;
@@ -33,6 +34,7 @@ struct Match {
         char *data;
         size_t size;
         uint64_t hash; /* old-style jenkins hash. New-style siphash is different per file, hence won't be cached here */
+        Hashmap *data_offsets; /* JournalFile → offset of the matching data object, 0 if it will never exist */
 
         /* For terms */
         LIST_HEAD(Match, matches);
@@ -80,6 +82,14 @@ struct sd_journal {
         JournalFile *current_file;
         uint64_t current_field;
 
+        /* Files which have a candidate entry in files_prioq_direction, ordered by that entry, plus the
+         * exhausted files that might still get new entries appended. Rebuilt on every seek and whenever
+         * the set of files changes, so that stepping through the journal doesn't need to look at every
+         * single file for each entry. */
+        Prioq *files_prioq;
+        Set *files_growable;
+        direction_t files_prioq_direction;
+
         Match *level0, *level1, *level2;
 
         pid_t original_pid;
@@ -93,6 +103,8 @@ struct sd_journal {
         char *unique_field;
         JournalFile *unique_file;
         uint64_t unique_offset;
+        Set *unique_hashes; /* Unkeyed hashes of all values seen so far, to avoid looking them up in every
+                             * earlier file when they can't be there */
 
         /* Iterating through known fields */
         JournalFile *fields_file;
@@ -124,6 +124,7 @@ int journal_directory_vacuum(
                 uint64_t n_max_files,
                 usec_t max_retention_usec,
                 usec_t *oldest_usec,
+                uint64_t *ret_freed,
                 bool verbose) {
 
         uint64_t sum = 0, freed = 0, n_active_files = 0;
@@ -137,6 +138,9 @@ int journal_directory_vacuum(
 
         assert(directory);
 
+        if (ret_freed)
+                *ret_freed = 0;
+
         if (max_use <= 0 && max_retention_usec <= 0 && n_max_files <= 0)
                 return 0;
 
@@ -317,5 +321,8 @@ finish:
 
         log_full(verbose ? LOG_INFO : LOG_DEBUG, "Vacuuming done, freed %s of archived journals from %s.", format_bytes(sbytes, sizeof(sbytes), freed), directory);
 
+        if (ret_freed)
+                *ret_freed = freed;
+
         return r;
 }
@@ -10,6 +10,7 @@
 #include "fd-util.h"
 #include "fileio.h"
 #include "fs-util.h"
+#include "io-util.h"
 #include "journal-authenticate.h"
 #include "journal-def.h"
 #include "journal-file.h"
@@ -352,15 +353,44 @@ static int journal_file_object_verify(JournalFile *f, uint64_t offset, Object *o
         return 0;
 }
 
-static int write_uint64(int fd, uint64_t p) {
-        ssize_t k;
+/* The offsets of all objects of a type are collected in a temporary file during the first pass. Batch
+ * them up, so that we don't issue a write() for each and every object in the file. */
+#define OFFSET_BUFFER_ITEMS 256U
 
-        k = write(fd, &p, sizeof(p));
-        if (k < 0)
-                return -errno;
-        if (k != sizeof(p))
-                return -EIO;
+typedef struct OffsetBuffer {
+        int fd;
+        size_t n;
+        uint64_t items[OFFSET_BUFFER_ITEMS];
+} OffsetBuffer;
 
+static int offset_buffer_flush(OffsetBuffer *b) {
+        int r;
+
+        assert(b);
+
+        if (b->n == 0)
+                return 0;
+
+        r = loop_write(b->fd, b->items, b->n * sizeof(uint64_t), false);
+        if (r < 0)
+                return r;
+
+        b->n = 0;
+        return 0;
+}
+
+static int offset_buffer_put(OffsetBuffer *b, uint64_t p) {
+        int r;
+
+        assert(b);
+
+        if (b->n >= ELEMENTSOF(b->items)) {
+                r = offset_buffer_flush(b);
+                if (r < 0)
+                        return r;
+        }
+
+        b->items[b->n++] = p;
         return 0;
 }
 
@@ -816,6 +846,7 @@ int journal_file_verify(
         uint64_t n_weird = 0, n_objects = 0, n_entries = 0, n_data = 0, n_fields = 0, n_data_hash_tables = 0, n_field_hash_tables = 0, n_entry_arrays = 0, n_tags = 0;
         usec_t last_usec = 0;
         int data_fd = -1, entry_fd = -1, entry_array_fd = -1;
+        OffsetBuffer data_buffer = {}, entry_buffer = {}, entry_array_buffer = {};
         MMapFileDescriptor *cache_data_fd = NULL, *cache_entry_fd = NULL, *cache_entry_array_fd = NULL;
         unsigned i;
         bool found_last = false;
@@ -864,6 +895,14 @@ int journal_file_verify(
                 goto fail;
         }
 
+        data_buffer.fd = data_fd;
+        entry_buffer.fd = entry_fd;
+        entry_array_buffer.fd = entry_array_fd;
+
+        /* The first pass walks through the whole file from the beginning to the end, let the kernel know
+         * so that it reads ahead more aggressively. */
+        (void) posix_fadvise(f->fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
         cache_data_fd = mmap_cache_add_fd(f->mmap, data_fd, PROT_READ|PROT_WRITE);
         if (!cache_data_fd) {
                 r = log_oom();
@@ -956,7 +995,7 @@ int journal_file_verify(
                 switch (o->object.type) {
 
                 case OBJECT_DATA:
-                        r = write_uint64(data_fd, p);
+                        r = offset_buffer_put(&data_buffer, p);
                         if (r < 0)
                                 goto fail;
 
@@ -974,7 +1013,7 @@ int journal_file_verify(
                                 goto fail;
                         }
 
-                        r = write_uint64(entry_fd, p);
+                        r = offset_buffer_put(&entry_buffer, p);
                         if (r < 0)
                                 goto fail;
 
@@ -1061,7 +1100,7 @@ int journal_file_verify(
                         break;
 
                 case OBJECT_ENTRY_ARRAY:
-                        r = write_uint64(entry_array_fd, p);
+                        r = offset_buffer_put(&entry_array_buffer, p);
                         if (r < 0)
                                 goto fail;
 
@@ -1251,6 +1290,16 @@ int journal_file_verify(
                 goto fail;
         }
 
+        r = offset_buffer_flush(&data_buffer);
+        if (r >= 0)
+                r = offset_buffer_flush(&entry_buffer);
+        if (r >= 0)
+                r = offset_buffer_flush(&entry_array_buffer);
+        if (r < 0) {
+                log_error_errno(r, "Failed to write offsets to temporary file: %m");
+                goto fail;
+        }
+
         /* Second iteration: we follow all objects referenced from the
          * two entry points: the object hash table and the entry
          * array. We also check that everything referenced (directly
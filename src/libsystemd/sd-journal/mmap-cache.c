@@ -5,6 +5,7 @@
 #include <sys/mman.h>
 
 #include "alloc-util.h"
+#include "env-util.h"
 #include "errno-util.h"
 #include "fd-util.h"
 #include "hashmap.h"
@@ -13,6 +14,7 @@
 #include "macro.h"
 #include "memory-util.h"
 #include "mmap-cache.h"
+#include "parse-util.h"
 #include "sigbus.h"
 
 typedef struct Window Window;
@@ -50,6 +52,7 @@ struct MMapFileDescriptor {
         int fd;
         int prot;
         bool sigbus;
+        bool map_whole;
         LIST_HEAD(Window, windows);
 };
 
@@ -57,7 +60,10 @@ struct MMapCache {
         unsigned n_ref;
         unsigned n_windows;
 
-        unsigned n_context_cache_hit, n_window_list_hit, n_missed;
+        unsigned n_context_cache_hit, n_window_list_hit, n_missed, n_evicted;
+
+        uint64_t window_size;
+        unsigned windows_min;
 
         Hashmap *fds;
         Context *contexts[MMAP_CACHE_MAX_CONTEXTS];
@@ -75,6 +81,46 @@ struct MMapCache {
 # define WINDOW_SIZE (8ULL*1024ULL*1024ULL)
 #endif
 
+/* Files that are mapped as a whole may not be larger than this, so that we don't exhaust the address space
+ * of 32bit systems */
+#define WINDOW_WHOLE_MAX (sizeof(void*) >= 8 ? 64ULL*1024ULL*1024ULL*1024ULL : 256ULL*1024ULL*1024ULL)
+
+static uint64_t window_size_from_env(void) {
+        const char *e;
+        uint64_t sz;
+        int r;
+
+        e = getenv("SYSTEMD_JOURNAL_MMAP_WINDOW_SIZE");
+        if (!e)
+                return WINDOW_SIZE;
+
+        r = parse_size(e, 1024, &sz);
+        if (r < 0) {
+                log_debug_errno(r, "Failed to parse $SYSTEMD_JOURNAL_MMAP_WINDOW_SIZE, ignoring: %s", e);
+                return WINDOW_SIZE;
+        }
+
+        return CLAMP(PAGE_ALIGN(sz), (uint64_t) page_size(), WINDOW_WHOLE_MAX);
+}
+
+static unsigned windows_min_from_env(void) {
+        const char *e;
+        unsigned n;
+        int r;
+
+        e = getenv("SYSTEMD_JOURNAL_MMAP_WINDOWS_MIN");
+        if (!e)
+                return WINDOWS_MIN;
+
+        r = safe_atou(e, &n);
+        if (r < 0) {
+                log_debug_errno(r, "Failed to parse $SYSTEMD_JOURNAL_MMAP_WINDOWS_MIN, ignoring: %s", e);
+                return WINDOWS_MIN;
+        }
+
+        return n;
+}
+
 MMapCache* mmap_cache_new(void) {
         MMapCache *m;
 
@@ -83,6 +129,8 @@ MMapCache* mmap_cache_new(void) {
                 return NULL;
 
         m->n_ref = 1;
+        m->window_size = window_size_from_env();
+        m->windows_min = windows_min_from_env();
         return m;
 }
 
@@ -158,7 +206,7 @@ static Window *window_add(MMapCache *m, MMapFileDescriptor *f, bool keep_always,
         assert(m);
         assert(f);
 
-        if (!m->last_unused || m->n_windows <= WINDOWS_MIN) {
+        if (!m->last_unused || m->n_windows <= m->windows_min) {
 
                 /* Allocate a new window */
                 w = new(Window, 1);
@@ -170,6 +218,7 @@ static Window *window_add(MMapCache *m, MMapFileDescriptor *f, bool keep_always,
                 /* Reuse an existing one */
                 w = m->last_unused;
                 window_unlink(w);
+                m->n_evicted++;
         }
 
         *w = (Window) {
@@ -296,6 +345,7 @@ static int make_room(MMapCache *m) {
                 return 0;
 
         window_free(m->last_unused);
+        m->n_evicted++;
         return 1;
 }
 
@@ -434,17 +484,23 @@ static int add_mmap(
         wsize = size + (offset - woffset);
         wsize = PAGE_ALIGN(wsize);
 
-        if (wsize < WINDOW_SIZE) {
+        if (f->map_whole && st && (uint64_t) st->st_size <= WINDOW_WHOLE_MAX && offset + size <= (uint64_t) st->st_size) {
+                /* The file won't change anymore, hence map all of it at once, and never come back here for
+                 * it, unless the window is evicted. */
+                woffset = 0;
+                wsize = PAGE_ALIGN(st->st_size);
+
+        } else if (wsize < m->window_size) {
                 uint64_t delta;
 
-                delta = PAGE_ALIGN((WINDOW_SIZE - wsize) / 2);
+                delta = PAGE_ALIGN((m->window_size - wsize) / 2);
 
                 if (delta > offset)
                         woffset = 0;
                 else
                         woffset -= delta;
 
-                wsize = WINDOW_SIZE;
+                wsize = m->window_size;
         }
 
         if (st) {
@@ -521,10 +577,24 @@ int mmap_cache_get(
         return add_mmap(m, f, context, keep_always, offset, size, st, ret);
 }
 
+void mmap_cache_get_stats(MMapCache *m, MMapCacheStats *ret) {
+        assert(m);
+        assert(ret);
+
+        *ret = (MMapCacheStats) {
+                .n_context_cache_hit = m->n_context_cache_hit,
+                .n_window_list_hit = m->n_window_list_hit,
+                .n_missed = m->n_missed,
+                .n_evicted = m->n_evicted,
+                .n_windows = m->n_windows,
+        };
+}
+
 void mmap_cache_stats_log_debug(MMapCache *m) {
         assert(m);
 
-        log_debug("mmap cache statistics: %u context cache hit, %u window list hit, %u miss", m->n_context_cache_hit, m->n_window_list_hit, m->n_missed);
+        log_debug("mmap cache statistics: %u context cache hit, %u window list hit, %u miss, %u evicted, %u windows",
+                  m->n_context_cache_hit, m->n_window_list_hit, m->n_missed, m->n_evicted, m->n_windows);
 }
 
 static void mmap_cache_process_sigbus(MMapCache *m) {
@@ -628,6 +698,13 @@ MMapFileDescriptor* mmap_cache_add_fd(MMapCache *m, int fd, int prot) {
         return f;
 }
 
+void mmap_cache_fd_set_map_whole(MMapFileDescriptor *f, bool b) {
+        assert(f);
+
+        /* Only for files that never change anymore: we don't notice if they grow or shrink */
+        f->map_whole = b;
+}
+
 void mmap_cache_free_fd(MMapCache *m, MMapFileDescriptor *f) {
         assert(m);
         assert(f);
@@ -10,6 +10,14 @@
 typedef struct MMapCache MMapCache;
 typedef struct MMapFileDescriptor MMapFileDescriptor;
 
+typedef struct MMapCacheStats {
+        unsigned n_context_cache_hit;
+        unsigned n_window_list_hit;
+        unsigned n_missed;
+        unsigned n_evicted;
+        unsigned n_windows;
+} MMapCacheStats;
+
 MMapCache* mmap_cache_new(void);
 MMapCache* mmap_cache_ref(MMapCache *m);
 MMapCache* mmap_cache_unref(MMapCache *m);
@@ -24,8 +32,10 @@ int mmap_cache_get(
         struct stat *st,
         void **ret);
 MMapFileDescriptor * mmap_cache_add_fd(MMapCache *m, int fd, int prot);
+void mmap_cache_fd_set_map_whole(MMapFileDescriptor *f, bool b);
 void mmap_cache_free_fd(MMapCache *m, MMapFileDescriptor *f);
 
+void mmap_cache_get_stats(MMapCache *m, MMapCacheStats *ret);
 void mmap_cache_stats_log_debug(MMapCache *m);
 
 bool mmap_cache_got_sigbus(MMapCache *m, MMapFileDescriptor *f);
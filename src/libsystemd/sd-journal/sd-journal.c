@@ -53,6 +53,21 @@
 
 static void remove_file_real(sd_journal *j, JournalFile *f);
 
+static void files_prioq_invalidate(sd_journal *j) {
+        assert(j);
+
+        j->files_prioq = prioq_free(j->files_prioq);
+        j->files_growable = set_free(j->files_growable);
+}
+
+static bool file_may_grow(JournalFile *f) {
+        assert(f);
+
+        /* Archived files are never written to again, hence whatever we found out about their contents
+         * stays valid for as long as we keep them open. */
+        return f->header->state != STATE_ARCHIVED;
+}
+
 static bool journal_pid_changed(sd_journal *j) {
         assert(j);
 
@@ -106,6 +121,8 @@ static void detach_location(sd_journal *j) {
         j->current_file = NULL;
         j->current_field = 0;
 
+        files_prioq_invalidate(j);
+
         ORDERED_HASHMAP_FOREACH(f, j->files)
                 journal_file_reset_location(f);
 }
@@ -220,10 +237,26 @@ static void match_free(Match *m) {
         if (m->parent)
                 LIST_REMOVE(matches, m->parent->matches, m);
 
+        hashmap_free(m->data_offsets);
         free(m->data);
         free(m);
 }
 
+static void match_forget_file(Match *m, JournalFile *f) {
+        Match *i;
+
+        assert(f);
+
+        if (!m)
+                return;
+
+        if (m->type == MATCH_DISCRETE)
+                free(hashmap_remove(m->data_offsets, f));
+
+        LIST_FOREACH(matches, i, m->matches)
+                match_forget_file(i, f);
+}
+
 static void match_free_if_empty(Match *m) {
         if (!m || m->matches)
                 return;
@@ -481,6 +514,63 @@ _pure_ static int compare_with_location(const JournalFile *f, const Location *l,
         return 0;
 }
 
+DEFINE_PRIVATE_HASH_OPS_WITH_VALUE_DESTRUCTOR(match_data_offset_hash_ops, void, trivial_hash_func, trivial_compare_func,
+                                              uint64_t, free);
+
+static int match_find_data_object(Match *m, JournalFile *f, uint64_t *ret_offset) {
+        _cleanup_free_ uint64_t *p = NULL;
+        uint64_t *cached, dp, hash;
+        int r;
+
+        assert(m);
+        assert(m->type == MATCH_DISCRETE);
+        assert(f);
+        assert(ret_offset);
+
+        /* Looks up the data object for a discrete match in the specified file. Data objects never move,
+         * hence we remember where we found them, so that we don't have to hash the match data and walk the
+         * hash table again and again while iterating. That they are missing is only remembered for
+         * archived files though, as they might still be added to all other files. Returns 0 if the file
+         * does not contain the data object. */
+
+        cached = hashmap_get(m->data_offsets, f);
+        if (cached) {
+                if (*cached == 0)
+                        return 0;
+
+                *ret_offset = *cached;
+                return 1;
+        }
+
+        /* If the keyed hash logic is used, we need to calculate the hash fresh per file. Otherwise
+         * we can use what we pre-calculated. */
+        if (JOURNAL_HEADER_KEYED_HASH(f->header))
+                hash = journal_file_hash_data(f, m->data, m->size);
+        else
+                hash = m->hash;
+
+        r = journal_file_find_data_object_with_hash(f, m->data, m->size, hash, NULL, &dp);
+        if (r < 0)
+                return r;
+        if (r == 0) {
+                if (file_may_grow(f))
+                        return 0;
+
+                dp = 0;
+        }
+
+        /* This is only a cache, hence ignore allocation failures */
+        p = newdup(uint64_t, &dp, 1);
+        if (p && hashmap_ensure_put(&m->data_offsets, &match_data_offset_hash_ops, f, p) >= 0)
+                TAKE_PTR(p);
+
+        if (r == 0)
+                return 0;
+
+        *ret_offset = dp;
+        return 1;
+}
+
 static int next_for_match(
                 sd_journal *j,
                 Match *m,
@@ -499,16 +589,9 @@ static int next_for_match(
         assert(f);
 
         if (m->type == MATCH_DISCRETE) {
-                uint64_t dp, hash;
-
-                /* If the keyed hash logic is used, we need to calculate the hash fresh per file. Otherwise
-                 * we can use what we pre-calculated. */
-                if (JOURNAL_HEADER_KEYED_HASH(f->header))
-                        hash = journal_file_hash_data(f, m->data, m->size);
-                else
-                        hash = m->hash;
+                uint64_t dp;
 
-                r = journal_file_find_data_object_with_hash(f, m->data, m->size, hash, NULL, &dp);
+                r = match_find_data_object(m, f, &dp);
                 if (r <= 0)
                         return r;
 
@@ -595,14 +678,9 @@ static int find_location_for_match(
         assert(f);
 
         if (m->type == MATCH_DISCRETE) {
-                uint64_t dp, hash;
+                uint64_t dp;
 
-                if (JOURNAL_HEADER_KEYED_HASH(f->header))
-                        hash = journal_file_hash_data(f, m->data, m->size);
-                else
-                        hash = m->hash;
-
-                r = journal_file_find_data_object_with_hash(f, m->data, m->size, hash, NULL, &dp);
+                r = match_find_data_object(m, f, &dp);
                 if (r <= 0)
                         return r;
 
@@ -684,6 +762,39 @@ static int find_location_for_match(
         }
 }
 
+static bool location_beyond_file(JournalFile *f, const Location *l, direction_t direction) {
+        assert(f);
+        assert(f->header);
+        assert(l);
+
+        /* Checks whether the file header alone tells us that there is no entry at or beyond the specified
+         * location in the specified direction. This allows us to skip the file without touching its entry
+         * arrays, which matters a lot when seeking in a directory with lots of archived files. */
+
+        if (f->header->n_entries == 0)
+                return true;
+
+        if (IN_SET(l->type, LOCATION_HEAD, LOCATION_TAIL))
+                return false;
+
+        if (l->seqnum_set && sd_id128_equal(l->seqnum_id, f->header->seqnum_id))
+                return direction == DIRECTION_DOWN ?
+                        l->seqnum > le64toh(f->header->tail_entry_seqnum) :
+                        l->seqnum < le64toh(f->header->head_entry_seqnum);
+
+        /* A monotonic timestamp takes precedence over the realtime one, but the header only carries the
+         * monotonic timestamp of the tail entry, hence we can't say anything in that case. */
+        if (l->monotonic_set)
+                return false;
+
+        if (l->realtime_set)
+                return direction == DIRECTION_DOWN ?
+                        l->realtime > le64toh(f->header->tail_entry_realtime) :
+                        l->realtime < le64toh(f->header->head_entry_realtime);
+
+        return false;
+}
+
 static int find_location_with_matches(
                 sd_journal *j,
                 JournalFile *f,
@@ -698,6 +809,9 @@ static int find_location_with_matches(
         assert(ret);
         assert(offset);
 
+        if (location_beyond_file(f, &j->current_location, direction))
+                return 0;
+
         if (!j->level0) {
                 /* No matches is simple */
 
@@ -705,8 +819,17 @@ static int find_location_with_matches(
                         return journal_file_next_entry(f, 0, DIRECTION_DOWN, ret, offset);
                 if (j->current_location.type == LOCATION_TAIL)
                         return journal_file_next_entry(f, 0, DIRECTION_UP, ret, offset);
-                if (j->current_location.seqnum_set && sd_id128_equal(j->current_location.seqnum_id, f->header->seqnum_id))
+                if (j->current_location.seqnum_set && sd_id128_equal(j->current_location.seqnum_id, f->header->seqnum_id)) {
+                        /* When resuming from a cursor, most files lie entirely after the location (or before
+                         * it, when going backwards). The header tells us that we'll end up at the first (or
+                         * last) entry then, no need to bisect. */
+                        if (direction == DIRECTION_DOWN ?
+                            j->current_location.seqnum <= le64toh(f->header->head_entry_seqnum) :
+                            j->current_location.seqnum >= le64toh(f->header->tail_entry_seqnum))
+                                return journal_file_next_entry(f, 0, direction, ret, offset);
+
                         return journal_file_move_to_entry_by_seqnum(f, j->current_location.seqnum, direction, ret, offset);
+                }
                 if (j->current_location.monotonic_set) {
                         r = journal_file_move_to_entry_by_monotonic(f, j->current_location.boot_id, j->current_location.monotonic, direction, ret, offset);
                         if (r != -ENOENT)
@@ -813,21 +936,57 @@ static int next_beyond_location(sd_journal *j, JournalFile *f, direction_t direc
         }
 }
 
-static int real_journal_next(sd_journal *j, direction_t direction) {
+static int files_prioq_compare(const void *a, const void *b) {
+        JournalFile *x = (JournalFile*) a, *y = (JournalFile*) b;
+        int r;
+
+        assert(x->last_direction == y->last_direction);
+
+        r = journal_file_compare_locations(x, y);
+        return x->last_direction == DIRECTION_DOWN ? r : -r;
+}
+
+static int files_prioq_exhausted(sd_journal *j, JournalFile *f) {
+        int r;
+
+        assert(j);
+        assert(f);
+
+        f->location_type = LOCATION_TAIL;
+
+        (void) prioq_remove(j->files_prioq, f, &f->prioq_idx);
+        f->prioq_idx = PRIOQ_IDX_NULL;
+
+        if (!file_may_grow(f))
+                return 0;
+
+        r = set_ensure_put(&j->files_growable, NULL, f);
+        return r < 0 ? r : 0;
+}
+
+static int real_journal_next_scan(sd_journal *j, direction_t direction, JournalFile **ret) {
         JournalFile *new_file = NULL;
-        unsigned i, n_files;
+        unsigned n_files;
         const void **files;
-        Object *o;
         int r;
 
-        assert_return(j, -EINVAL);
-        assert_return(!journal_pid_changed(j), -ECHILD);
+        assert(j);
+        assert(ret);
+
+        /* Look at every single file, and fill the priority queue on the way, so that subsequent steps in
+         * the same direction only need to advance the file whose entry got picked. If we fail to allocate
+         * anything for that we simply continue without it and end up here again next time. */
+
+        files_prioq_invalidate(j);
 
         r = iterated_cache_get(j->files_cache, NULL, &files, &n_files);
         if (r < 0)
                 return r;
 
-        for (i = 0; i < n_files; i++) {
+        if (prioq_ensure_allocated(&j->files_prioq, files_prioq_compare) >= 0)
+                j->files_prioq_direction = direction;
+
+        for (unsigned i = 0; i < n_files; i++) {
                 JournalFile *f = (JournalFile *)files[i];
                 bool found;
 
@@ -838,9 +997,17 @@ static int real_journal_next(sd_journal *j, direction_t direction) {
                         continue;
                 } else if (r == 0) {
                         f->location_type = LOCATION_TAIL;
+
+                        if (j->files_prioq && file_may_grow(f) &&
+                            set_ensure_put(&j->files_growable, NULL, f) < 0)
+                                files_prioq_invalidate(j);
+
                         continue;
                 }
 
+                if (j->files_prioq && prioq_put(j->files_prioq, f, &f->prioq_idx) < 0)
+                        files_prioq_invalidate(j);
+
                 if (!new_file)
                         found = true;
                 else {
@@ -855,8 +1022,120 @@ static int real_journal_next(sd_journal *j, direction_t direction) {
                         new_file = f;
         }
 
-        if (!new_file)
-                return 0;
+        *ret = new_file;
+        return !!new_file;
+}
+
+static int real_journal_next_prioq(sd_journal *j, direction_t direction, JournalFile **ret) {
+        JournalFile *f;
+        int r;
+
+        assert(j);
+        assert(ret);
+
+        /* Returns -EAGAIN if the priority queue cannot be used, and the caller should fall back to
+         * looking at all files instead. */
+
+        if (!j->files_prioq ||
+            j->files_prioq_direction != direction ||
+            j->current_location.type != LOCATION_DISCRETE ||
+            !j->current_file)
+                return -EAGAIN;
+
+        /* First, move the file whose entry got picked last time on to its next candidate. The queue is
+         * ordered by these candidates, hence this needs to happen before the queue is touched at all. If
+         * we already ran off its end, it is tracked in files_growable (if at all) like any other file. */
+        f = j->current_file;
+        if (prioq_peek_by_index(j->files_prioq, f->prioq_idx) == f) {
+                r = next_beyond_location(j, f, direction);
+                if (r < 0) {
+                        log_debug_errno(r, "Can't iterate through %s, ignoring: %m", f->path);
+                        remove_file_real(j, f);
+                        return -EAGAIN;
+                }
+                if (r == 0)
+                        r = files_prioq_exhausted(j, f);
+                else
+                        r = prioq_reshuffle(j->files_prioq, f, &f->prioq_idx);
+                if (r < 0)
+                        goto fallback;
+        } else if (f->location_type != LOCATION_TAIL)
+                return -EAGAIN;
+
+        /* Then, check whether any of the files we ran off the end of got new entries. */
+        SET_FOREACH(f, j->files_growable) {
+                r = next_beyond_location(j, f, direction);
+                if (r < 0) {
+                        log_debug_errno(r, "Can't iterate through %s, ignoring: %m", f->path);
+                        remove_file_real(j, f);
+                        return -EAGAIN;
+                }
+                if (r == 0) {
+                        f->location_type = LOCATION_TAIL;
+                        continue;
+                }
+
+                r = prioq_put(j->files_prioq, f, &f->prioq_idx);
+                if (r < 0)
+                        goto fallback;
+
+                (void) set_remove(j->files_growable, f);
+        }
+
+        /* Finally, pick the earliest candidate. It might be a duplicate of the entry we are currently
+         * looking at, in which case next_beyond_location() moves it, and we need to look again. */
+        for (;;) {
+                uint64_t p;
+
+                f = prioq_peek(j->files_prioq);
+                if (!f) {
+                        *ret = NULL;
+                        return 0;
+                }
+
+                p = f->current_offset;
+
+                r = next_beyond_location(j, f, direction);
+                if (r < 0) {
+                        log_debug_errno(r, "Can't iterate through %s, ignoring: %m", f->path);
+                        remove_file_real(j, f);
+                        return -EAGAIN;
+                }
+                if (r == 0) {
+                        r = files_prioq_exhausted(j, f);
+                        if (r < 0)
+                                goto fallback;
+                        continue;
+                }
+
+                if (f->current_offset == p) {
+                        *ret = f;
+                        return 1;
+                }
+
+                r = prioq_reshuffle(j->files_prioq, f, &f->prioq_idx);
+                if (r < 0)
+                        goto fallback;
+        }
+
+fallback:
+        files_prioq_invalidate(j);
+        return -EAGAIN;
+}
+
+static int real_journal_next(sd_journal *j, direction_t direction) {
+        JournalFile *new_file;
+        Object *o;
+        int r;
+
+        assert_return(j, -EINVAL);
+        assert_return(!journal_pid_changed(j), -ECHILD);
+
+        r = real_journal_next_prioq(j, direction, &new_file);
+        if (r == -EAGAIN)
+                r = real_journal_next_scan(j, direction, &new_file);
+        if (r <= 0)
+                return r;
 
         r = journal_file_move_to_object(new_file, OBJECT_ENTRY, new_file->current_offset, &o);
         if (r < 0)
@@ -1359,6 +1638,7 @@ static int add_any_file(
         track_file_disposition(j, f);
         check_network(j, f->fd);
 
+        files_prioq_invalidate(j);
         j->current_invalidate_counter++;
 
         log_debug("File %s added.", f->path);
@@ -1427,6 +1707,9 @@ static void remove_file_real(sd_journal *j, JournalFile *f) {
 
         log_debug("File %s removed.", f->path);
 
+        files_prioq_invalidate(j);
+        match_forget_file(j->level0, f);
+
         if (j->current_file == f) {
                 j->current_file = NULL;
                 j->current_field = 0;
@@ -2152,6 +2435,7 @@ _public_ void sd_journal_close(sd_journal *j) {
 
         sd_journal_flush_matches(j);
 
+        files_prioq_invalidate(j);
         ordered_hashmap_free_with_destructor(j->files, journal_file_close);
         iterated_cache_free(j->files_cache);
 
@@ -2177,6 +2461,7 @@ _public_ void sd_journal_close(sd_journal *j) {
         free(j->prefix);
         free(j->namespace);
         free(j->unique_field);
+        set_free(j->unique_hashes);
         free(j->fields_buffer);
         free(j);
 }
@@ -2873,6 +3158,7 @@ _public_ int sd_journal_query_unique(sd_journal *j, const char *field) {
         j->unique_file = NULL;
         j->unique_offset = 0;
         j->unique_file_lost = false;
+        set_clear(j->unique_hashes);
 
         return 0;
 }
@@ -2904,7 +3190,7 @@ _public_ int sd_journal_enumerate_unique(sd_journal *j, const void **data, size_
                 Object *o;
                 const void *odata;
                 size_t ol;
-                bool found;
+                uint64_t h;
                 int r;
 
                 /* Proceed to next data object in the field's linked list */
@@ -2964,29 +3250,39 @@ _public_ int sd_journal_enumerate_unique(sd_journal *j, const void **data, size_
                                                j->unique_offset,
                                                j->unique_field);
 
-                /* OK, now let's see if we already returned this data
-                 * object by checking if it exists in the earlier
-                 * traversed files. */
-                found = false;
-                ORDERED_HASHMAP_FOREACH(of, j->files) {
-                        if (of == j->unique_file)
-                                break;
+                /* OK, now let's see if we already returned this data object. The hash stored in the object
+                 * might be keyed by the file it is in, hence calculate our own. If we never saw it before,
+                 * this data can't be in any of the earlier traversed files. Only if we did, we need to check
+                 * if it exists in the earlier traversed files, as it might just be a collision. */
+                h = jenkins_hash64(odata, ol);
+                r = set_ensure_put(&j->unique_hashes, NULL, UINT64_TO_PTR(h));
+                if (r < 0)
+                        return r;
+                if (r == 0) {
+                        bool found = false;
 
-                        /* Skip this file it didn't have any fields indexed */
-                        if (JOURNAL_HEADER_CONTAINS(of->header, n_fields) && le64toh(of->header->n_fields) <= 0)
-                                continue;
+                        ORDERED_HASHMAP_FOREACH(of, j->files) {
+                                if (of == j->unique_file)
+                                        break;
 
-                        r = journal_file_find_data_object_with_hash(of, odata, ol, le64toh(o->data.hash), NULL, NULL);
-                        if (r < 0)
-                                return r;
-                        if (r > 0) {
-                                found = true;
-                                break;
+                                /* Skip this file it didn't have any fields indexed */
+                                if (JOURNAL_HEADER_CONTAINS(of->header, n_fields) && le64toh(of->header->n_fields) <= 0)
+                                        continue;
+
+                                /* Don't use the hash of the object here, the other file might use a
+                                 * different hash key. */
+                                r = journal_file_find_data_object(of, odata, ol, NULL, NULL);
+                                if (r < 0)
+                                        return r;
+                                if (r > 0) {
+                                        found = true;
+                                        break;
+                                }
                         }
-                }
 
-                if (found)
-                        continue;
+                        if (found)
+                                continue;
+                }
 
                 r = return_data(j, j->unique_file, o, data, l);
                 if (r < 0)
@@ -3017,6 +3313,7 @@ _public_ void sd_journal_restart_unique(sd_journal *j) {
         j->unique_file = NULL;
         j->unique_offset = 0;
         j->unique_file_lost = false;
+        set_clear(j->unique_hashes);
 }
 
 _public_ int sd_journal_enumerate_fields(sd_journal *j, const char **field) {
@@ -12,7 +12,9 @@
 #include "journal-vacuum.h"
 #include "log.h"
 #include "parse-util.h"
+#include "rlimit-util.h"
 #include "rm-rf.h"
+#include "stdio-util.h"
 #include "tests.h"
 #include "util.h"
 
@@ -107,6 +109,46 @@ static void test_check_numbers_up (sd_journal *j, int count) {
 
 }
 
+static void test_check_seek_realtime(sd_journal *j, int count) {
+        uint64_t realtime[count];
+        int r;
+
+        assert_ret(sd_journal_seek_head(j));
+        for (int i = 0; i < count; i++) {
+                assert_ret(r = sd_journal_next(j));
+                assert_se(r == 1);
+                assert_ret(sd_journal_get_realtime_usec(j, &realtime[i]));
+        }
+
+        for (int i = 1; i < count; i++) {
+                assert_se(realtime[i - 1] < realtime[i]);
+
+                assert_ret(sd_journal_seek_realtime_usec(j, realtime[i - 1] + 1));
+                assert_ret(r = sd_journal_next(j));
+                assert_se(r == 1);
+                test_check_number(j, i + 1);
+
+                assert_ret(sd_journal_seek_realtime_usec(j, realtime[i] - 1));
+                assert_ret(r = sd_journal_previous(j));
+                assert_se(r == 1);
+                test_check_number(j, i);
+        }
+
+        assert_ret(sd_journal_seek_realtime_usec(j, realtime[count - 1] + 1));
+        assert_ret(r = sd_journal_next(j));
+        assert_se(r == 0);
+        assert_ret(r = sd_journal_previous(j));
+        assert_se(r == 1);
+        test_check_number(j, count);
+
+        assert_ret(sd_journal_seek_realtime_usec(j, realtime[0] - 1));
+        assert_ret(r = sd_journal_previous(j));
+        assert_se(r == 0);
+        assert_ret(r = sd_journal_next(j));
+        assert_se(r == 1);
+        test_check_number(j, 1);
+}
+
 static void setup_sequential(void) {
         JournalFile *one, *two;
         one = test_open("one.journal");
@@ -183,12 +225,18 @@ static void test_skip(void (*setup)(void)) {
         test_check_numbers_up(j, 4);
         sd_journal_close(j);
 
+        /* Seek to the realtime timestamps between entries, and beyond either end.
+         */
+        assert_ret(sd_journal_open_directory(&j, t, 0));
+        test_check_seek_realtime(j, 4);
+        sd_journal_close(j);
+
         log_info("Done...");
 
         if (arg_keep)
                 log_info("Not removing %s", t);
         else {
-                journal_directory_vacuum(".", 3000000, 0, 0, NULL, true);
+                journal_directory_vacuum(".", 3000000, 0, 0, NULL, NULL, true);
 
                 assert_se(rm_rf(t, REMOVE_ROOT|REMOVE_PHYSICAL) >= 0);
         }
@@ -196,6 +244,82 @@ static void test_skip(void (*setup)(void)) {
         puts("------------------------------------------------------------");
 }
 
+static int journal_get_number(sd_journal *j) {
+        const void *d;
+        size_t l;
+        int x;
+
+        assert_ret(sd_journal_get_data(j, "NUMBER", &d, &l));
+        assert_se(l > STRLEN("NUMBER="));
+        assert_se(safe_atoi(strndupa(d, l) + STRLEN("NUMBER="), &x) >= 0);
+
+        return x;
+}
+
+static void test_many_files(unsigned n_files) {
+        char t[] = "/var/tmp/journal-many-XXXXXX";
+        _cleanup_free_ JournalFile **files = NULL;
+        char b[FORMAT_TIMESPAN_MAX];
+        unsigned n_entries = 2 * n_files;
+        sd_journal *j;
+        usec_t ts;
+        int r;
+
+        /* Interleave entries across many files, so that every single step needs to consider the next
+         * entry from another file. Also serves as a benchmark for the merge in sd_journal_next(). */
+
+        log_info("/* %s(%u) */", __func__, n_files);
+
+        mkdtemp_chdir_chattr(t);
+
+        assert_se(files = new0(JournalFile*, n_files));
+
+        for (unsigned i = 0; i < n_files; i++) {
+                char fn[STRLEN("many-") + DECIMAL_STR_MAX(unsigned) + STRLEN(".journal")];
+
+                xsprintf(fn, "many-%u.journal", i);
+                files[i] = test_open(fn);
+                append_number(files[i], i + 1, NULL);
+        }
+
+        for (unsigned i = 0; i < n_files; i++) {
+                append_number(files[i], n_files + i + 1, NULL);
+                test_close(files[i]);
+        }
+
+        assert_ret(sd_journal_open_directory(&j, t, 0));
+
+        assert_ret(sd_journal_seek_head(j));
+        ts = now(CLOCK_MONOTONIC);
+        for (unsigned i = 1; i <= n_entries; i++) {
+                assert_ret(r = sd_journal_next(j));
+                assert_se(r == 1);
+                assert_se(journal_get_number(j) == (int) i);
+        }
+        assert_ret(r = sd_journal_next(j));
+        assert_se(r == 0);
+        log_info("Iterated down through %u entries in %u files in %s.", n_entries, n_files,
+                 format_timespan(b, sizeof(b), now(CLOCK_MONOTONIC) - ts, 0));
+
+        ts = now(CLOCK_MONOTONIC);
+        for (unsigned i = n_entries - 1; i >= 1; i--) {
+                assert_ret(r = sd_journal_previous(j));
+                assert_se(r == 1);
+                assert_se(journal_get_number(j) == (int) i);
+        }
+        assert_ret(r = sd_journal_previous(j));
+        assert_se(r == 0);
+        log_info("Iterated up through %u entries in %u files in %s.", n_entries, n_files,
+                 format_timespan(b, sizeof(b), now(CLOCK_MONOTONIC) - ts, 0));
+
+        sd_journal_close(j);
+
+        if (arg_keep)
+                log_info("Not removing %s", t);
+        else
+                assert_se(rm_rf(t, REMOVE_ROOT|REMOVE_PHYSICAL) >= 0);
+}
+
 static void test_sequence_numbers(void) {
 
         char t[] = "/var/tmp/journal-seq-XXXXXX";
@@ -272,7 +396,7 @@ static void test_sequence_numbers(void) {
         if (arg_keep)
                 log_info("Not removing %s", t);
         else {
-                journal_directory_vacuum(".", 3000000, 0, 0, NULL, true);
+                journal_directory_vacuum(".", 3000000, 0, 0, NULL, NULL, true);
 
                 assert_se(rm_rf(t, REMOVE_ROOT|REMOVE_PHYSICAL) >= 0);
         }
@@ -292,5 +416,14 @@ int main(int argc, char *argv[]) {
 
         test_sequence_numbers();
 
+        /* Every journal file needs its own fd */
+        (void) rlimit_nofile_bump(-1);
+
+        test_many_files(100);
+        if (slow_tests_enabled()) {
+                test_many_files(1000);
+                test_many_files(5000);
+        }
+
         return 0;
 }
@@ -62,7 +62,7 @@ static void verify_contents(sd_journal *j, unsigned skip) {
 static void run_test(void) {
         JournalFile *one, *two, *three;
         char t[] = "/var/tmp/journal-stream-XXXXXX";
-        unsigned i;
+        unsigned i, n;
         _cleanup_(sd_journal_closep) sd_journal *j = NULL;
         char *z;
         const void *data;
@@ -169,6 +169,19 @@ static void run_test(void) {
         SD_JOURNAL_FOREACH_UNIQUE(j, data, l)
                 printf("%.*s\n", (int) l, (const char*) data);
 
+        /* Values present in more than one file must be returned only once */
+        n = 0;
+        sd_journal_restart_unique(j);
+        SD_JOURNAL_FOREACH_UNIQUE(j, data, l)
+                n++;
+        assert_se(n == N_ENTRIES);
+
+        assert_se(sd_journal_query_unique(j, "MAGIC") >= 0);
+        n = 0;
+        SD_JOURNAL_FOREACH_UNIQUE(j, data, l)
+                n++;
+        assert_se(n == 2);
+
         assert_se(rm_rf(t, REMOVE_ROOT|REMOVE_PHYSICAL) >= 0);
 }
 
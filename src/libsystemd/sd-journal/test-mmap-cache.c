@@ -11,6 +11,43 @@
 #include "tmpfile-util.h"
 #include "util.h"
 
+static void test_map_whole(void) {
+        char path[] = "/tmp/testmmapWXXXXXX";
+        MMapFileDescriptor *fw;
+        MMapCacheStats stats;
+        struct stat st;
+        MMapCache *m;
+        void *p, *q;
+        int w;
+
+        assert_se(m = mmap_cache_new());
+
+        w = mkostemp_safe(path);
+        assert_se(w >= 0);
+        unlink(path);
+
+        assert_se(ftruncate(w, 32ULL*1024ULL*1024ULL) >= 0);
+        assert_se(fstat(w, &st) >= 0);
+
+        assert_se(fw = mmap_cache_add_fd(m, w, PROT_READ));
+        mmap_cache_fd_set_map_whole(fw, true);
+
+        /* Offsets much further apart than the default window size must end up in the same mapping */
+        assert_se(mmap_cache_get(m, fw, 0, false, 1, 2, &st, &p) >= 0);
+        assert_se(mmap_cache_get(m, fw, 1, false, 30ULL*1024ULL*1024ULL, 2, &st, &q) >= 0);
+        assert_se((uint8_t*) p + 30ULL*1024ULL*1024ULL - 1 == (uint8_t*) q);
+
+        mmap_cache_get_stats(m, &stats);
+        assert_se(stats.n_missed == 1);
+        assert_se(stats.n_window_list_hit == 1);
+        assert_se(stats.n_windows == 1);
+
+        mmap_cache_free_fd(m, fw);
+        mmap_cache_unref(m);
+
+        safe_close(w);
+}
+
 int main(int argc, char *argv[]) {
         MMapFileDescriptor *fx;
         int x, y, z, r;
@@ -62,5 +99,7 @@ int main(int argc, char *argv[]) {
         safe_close(y);
         safe_close(z);
 
+        test_map_whole();
+
         return 0;
 }
@@ -352,6 +352,43 @@ int sd_rtnl_message_nexthop_get_protocol(const sd_netlink_message *m, uint8_t *p
         return 0;
 }
 
+int sd_rtnl_message_new_stats(sd_netlink *rtnl, sd_netlink_message **ret,
+                              uint16_t nlmsg_type, int ifindex, uint32_t filter_mask) {
+        struct if_stats_msg *ifsm;
+        int r;
+
+        assert_return(rtnl_message_type_is_stats(nlmsg_type), -EINVAL);
+        assert_return(ifindex >= 0, -EINVAL);
+        assert_return(ret, -EINVAL);
+
+        r = message_new(rtnl, ret, nlmsg_type);
+        if (r < 0)
+                return r;
+
+        ifsm = NLMSG_DATA((*ret)->hdr);
+
+        ifsm->family = AF_UNSPEC;
+        ifsm->ifindex = ifindex;
+        ifsm->filter_mask = filter_mask;
+
+        return 0;
+}
+
+int sd_rtnl_message_stats_get_ifindex(const sd_netlink_message *m, int *ifindex) {
+        struct if_stats_msg *ifsm;
+
+        assert_return(m, -EINVAL);
+        assert_return(m->hdr, -EINVAL);
+        assert_return(rtnl_message_type_is_stats(m->hdr->nlmsg_type), -EINVAL);
+        assert_return(ifindex, -EINVAL);
+
+        ifsm = NLMSG_DATA(m->hdr);
+
+        *ifindex = ifsm->ifindex;
+
+        return 0;
+}
+
 int sd_rtnl_message_neigh_set_flags(sd_netlink_message *m, uint8_t flags) {
         struct ndmsg *ndm;
 
@@ -20,6 +20,11 @@
 /* Some really high limit, to catch programming errors */
 #define REPLY_CALLBACKS_MAX UINT16_MAX
 
+/* How many messages to process per wakeup of the IO event source, so that route or link storms are
+ * drained without going through the event loop for every single datagram, while other event sources
+ * still get a chance to run. */
+#define RTNL_PROCESS_BATCH_MAX 64U
+
 static int sd_netlink_new(sd_netlink **ret) {
         _cleanup_(sd_netlink_unrefp) sd_netlink *rtnl = NULL;
 
@@ -777,13 +782,22 @@ int sd_netlink_get_timeout(const sd_netlink *rtnl, uint64_t *timeout_usec) {
 
 static int io_callback(sd_event_source *s, int fd, uint32_t revents, void *userdata) {
         sd_netlink *rtnl = userdata;
+        NETLINK_DONT_DESTROY(rtnl);
         int r;
 
         assert(rtnl);
 
-        r = sd_netlink_process(rtnl, NULL);
-        if (r < 0)
-                return r;
+        for (unsigned i = 0; i < RTNL_PROCESS_BATCH_MAX; i++) {
+                r = sd_netlink_process(rtnl, NULL);
+                if (r < 0)
+                        return r;
+                if (r == 0)
+                        break;
+
+                /* A callback might have detached us from the event loop. */
+                if (!rtnl->io_event_source)
+                        break;
+        }
 
         return 1;
 }
@@ -597,6 +597,9 @@ void link_set_state(Link *link, LinkState state) {
                        link_state_to_string(link->state),
                        link_state_to_string(state));
 
+        if (state == LINK_STATE_CONFIGURING)
+                link->configuring_usec = now(CLOCK_MONOTONIC);
+
         link->state = state;
 
         link_send_changed(link, "AdministrativeState", NULL);
@@ -709,12 +712,17 @@ static int link_join_netdevs_after_configured(Link *link) {
 }
 
 static void link_enter_configured(Link *link) {
+        char buf[FORMAT_TIMESPAN_MAX];
+
         assert(link);
         assert(link->network);
 
         if (link->state != LINK_STATE_CONFIGURING)
                 return;
 
+        log_link_debug(link, "Configuration took %s.",
+                       format_timespan(buf, sizeof(buf), usec_sub_unsigned(now(CLOCK_MONOTONIC), link->configuring_usec), USEC_PER_MSEC));
+
         link_set_state(link, LINK_STATE_CONFIGURED);
 
         (void) link_join_netdevs_after_configured(link);
@@ -72,6 +72,7 @@ typedef struct Link {
         Network *network;
 
         LinkState state;
+        usec_t configuring_usec; /* CLOCK_MONOTONIC timestamp of entering the configuring state */
         LinkOperationalState operstate;
         LinkCarrierState carrier_state;
         LinkAddressState address_state;
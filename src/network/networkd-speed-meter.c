@@ -19,10 +19,12 @@ static int process_message(Manager *manager, sd_netlink_message *message) {
         if (r < 0)
                 return r;
 
-        if (type != RTM_NEWLINK)
+        if (type == RTM_NEWSTATS)
+                r = sd_rtnl_message_stats_get_ifindex(message, &ifindex);
+        else if (type == RTM_NEWLINK)
+                r = sd_rtnl_message_link_get_ifindex(message, &ifindex);
+        else
                 return 0;
-
-        r = sd_rtnl_message_link_get_ifindex(message, &ifindex);
         if (r < 0)
                 return r;
 
@@ -32,7 +34,8 @@ static int process_message(Manager *manager, sd_netlink_message *message) {
 
         link->stats_old = link->stats_new;
 
-        r = sd_netlink_message_read(message, IFLA_STATS64, sizeof link->stats_new, &link->stats_new);
+        r = sd_netlink_message_read(message, type == RTM_NEWSTATS ? IFLA_STATS_LINK_64 : IFLA_STATS64,
+                                    sizeof link->stats_new, &link->stats_new);
         if (r < 0)
                 return r;
 
@@ -41,8 +44,32 @@ static int process_message(Manager *manager, sd_netlink_message *message) {
         return 0;
 }
 
+static int speed_meter_dump(Manager *manager, uint16_t type, sd_netlink_message **ret) {
+        _cleanup_(sd_netlink_message_unrefp) sd_netlink_message *req = NULL;
+        int r;
+
+        assert(manager);
+        assert(ret);
+
+        /* RTM_GETSTATS lets us ask for the counters only, which is much cheaper for the kernel to
+         * generate and for us to parse than full RTM_NEWLINK messages. */
+        if (type == RTM_GETSTATS)
+                r = sd_rtnl_message_new_stats(manager->rtnl, &req, RTM_GETSTATS, 0,
+                                              IFLA_STATS_FILTER_BIT(IFLA_STATS_LINK_64));
+        else
+                r = sd_rtnl_message_new_link(manager->rtnl, &req, RTM_GETLINK, 0);
+        if (r < 0)
+                return r;
+
+        r = sd_netlink_message_request_dump(req, true);
+        if (r < 0)
+                return r;
+
+        return sd_netlink_call(manager->rtnl, req, 0, ret);
+}
+
 static int speed_meter_handler(sd_event_source *s, uint64_t usec, void *userdata) {
-        _cleanup_(sd_netlink_message_unrefp) sd_netlink_message *req = NULL, *reply = NULL;
+        _cleanup_(sd_netlink_message_unrefp) sd_netlink_message *reply = NULL;
         Manager *manager = userdata;
         usec_t usec_now;
         Link *link;
@@ -65,21 +92,11 @@ static int speed_meter_handler(sd_event_source *s, uint64_t usec, void *userdata
         HASHMAP_FOREACH(link, manager->links)
                 link->stats_updated = false;
 
-        r = sd_rtnl_message_new_link(manager->rtnl, &req, RTM_GETLINK, 0);
-        if (r < 0) {
-                log_warning_errno(r, "Failed to allocate RTM_GETLINK netlink message, ignoring: %m");
-                return 0;
-        }
-
-        r = sd_netlink_message_request_dump(req, true);
-        if (r < 0) {
-                log_warning_errno(r, "Failed to set dump flag, ignoring: %m");
-                return 0;
-        }
-
-        r = sd_netlink_call(manager->rtnl, req, 0, &reply);
+        r = speed_meter_dump(manager, RTM_GETSTATS, &reply);
+        if (r == -EOPNOTSUPP) /* RTM_GETSTATS is supported since kernel 4.7 */
+                r = speed_meter_dump(manager, RTM_GETLINK, &reply);
         if (r < 0) {
-                log_warning_errno(r, "Failed to call RTM_GETLINK, ignoring: %m");
+                log_warning_errno(r, "Failed to request interface statistics, ignoring: %m");
                 return 0;
         }
 
@@ -393,8 +393,9 @@ static void serialize_addresses(
 
 int link_save(Link *link) {
         const char *admin_state, *oper_state, *carrier_state, *address_state;
-        _cleanup_(unlink_and_freep) char *temp_path = NULL;
+        _cleanup_free_ char *buf = NULL;
         _cleanup_fclose_ FILE *f = NULL;
+        size_t size;
         int r;
 
         assert(link);
@@ -419,11 +420,9 @@ int link_save(Link *link) {
         address_state = link_address_state_to_string(link->address_state);
         assert(address_state);
 
-        r = fopen_temporary(link->state_file, &f, &temp_path);
-        if (r < 0)
-                return r;
-
-        (void) fchmod(fileno(f), 0644);
+        f = open_memstream_unlocked(&buf, &size);
+        if (!f)
+                return -ENOMEM;
 
         fprintf(f,
                 "# This is private data. Do not parse.\n"
@@ -634,12 +633,12 @@ int link_save(Link *link) {
         if (r < 0)
                 return r;
 
-        r = conservative_rename(temp_path, link->state_file);
+        /* sd-network monitors watch the links directory and reparse everything on every event there, hence
+         * don't touch the file if the contents did not change. */
+        r = write_data_file_atomic_if_changed(link->state_file, buf, size, 0644);
         if (r < 0)
                 return r;
 
-        temp_path = mfree(temp_path);
-
         return 0;
 }
 
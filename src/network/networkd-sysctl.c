@@ -3,6 +3,7 @@
 #include <netinet/in.h>
 #include <linux/if.h>
 
+#include "alloc-util.h"
 #include "missing_network.h"
 #include "networkd-link.h"
 #include "networkd-network.h"
@@ -54,6 +55,18 @@ static bool link_ip_forward_enabled(Link *link, int family) {
         return link->network->ip_forward & (family == AF_INET ? ADDRESS_FAMILY_IPV4 : ADDRESS_FAMILY_IPV6);
 }
 
+static int sysctl_enable_global_forwarding(int af, const char *ifname, const char *property) {
+        _cleanup_free_ char *value = NULL;
+
+        /* Writing net.ipv6.conf.all.forwarding makes the kernel take the RTNL lock and walk all
+         * interfaces, even if the value does not change. As this is done for every link that enables
+         * forwarding, skip the write if it is already on. */
+        if (sysctl_read_ip_property(af, ifname, property, &value) >= 0 && streq(value, "1"))
+                return 0;
+
+        return sysctl_write_ip_property(af, ifname, property, "1");
+}
+
 static int link_set_ipv4_forward(Link *link) {
         assert(link);
 
@@ -67,7 +80,7 @@ static int link_set_ipv4_forward(Link *link) {
          * primarily to keep IPv4 and IPv6 packet forwarding behaviour
          * somewhat in sync (see below). */
 
-        return sysctl_write_ip_property(AF_INET, NULL, "ip_forward", "1");
+        return sysctl_enable_global_forwarding(AF_INET, NULL, "ip_forward");
 }
 
 static int link_set_ipv6_forward(Link *link) {
@@ -85,7 +98,7 @@ static int link_set_ipv6_forward(Link *link) {
          * same behaviour there and also propagate the setting from
          * one to all, to keep things simple (see above). */
 
-        return sysctl_write_ip_property(AF_INET6, "all", "forwarding", "1");
+        return sysctl_enable_global_forwarding(AF_INET6, "all", "forwarding");
 }
 
 static int link_set_ipv6_privacy_extensions(Link *link) {
@@ -6,6 +6,8 @@
 #include "hashmap.h"
 #include "link.h"
 #include "manager.h"
+#include "stat-util.h"
+#include "stdio-util.h"
 #include "string-util.h"
 
 int link_new(Manager *m, Link **ret, int ifindex, const char *ifname) {
@@ -98,11 +100,25 @@ int link_update_rtnl(Link *l, sd_netlink_message *m) {
 
 int link_update_monitor(Link *l) {
         _cleanup_free_ char *operstate = NULL, *required_operstate = NULL, *state = NULL;
+        char path[STRLEN("/run/systemd/netif/links/") + DECIMAL_STR_MAX(int)];
+        struct stat st;
         int r, ret = 0;
 
         assert(l);
         assert(l->ifname);
 
+        /* We are called for every link whenever any state file changes. Each of the calls below parses
+         * the link's state file again, hence skip all of them if the file has not been replaced since we
+         * last looked at it. networkd always replaces the file atomically, so checking the inode and the
+         * modification time is enough. */
+        xsprintf(path, "/run/systemd/netif/links/%i", l->ifindex);
+        if (stat(path, &st) < 0)
+                l->state_file_stat = (struct stat) {};
+        else if (stat_inode_unmodified(&l->state_file_stat, &st))
+                return 0;
+        else
+                l->state_file_stat = st;
+
         r = sd_network_link_get_required_for_online(l->ifindex);
         if (r < 0)
                 ret = log_link_debug_errno(l, r, "Failed to determine whether the link is required for online or not, "
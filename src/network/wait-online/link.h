@@ -1,6 +1,8 @@
 /* SPDX-License-Identifier: LGPL-2.1-or-later */
 #pragma once
 
+#include <sys/stat.h>
+
 #include "sd-netlink.h"
 
 #include "log-link.h"
@@ -20,6 +22,8 @@ struct Link {
         LinkOperationalStateRange required_operstate;
         LinkOperationalState operational_state;
         char *state;
+
+        struct stat state_file_stat; /* of the state file we last read the information above from */
 };
 
 int link_new(Manager *m, Link **ret, int ifindex, const char *ifname);
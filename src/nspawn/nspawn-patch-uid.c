@@ -243,16 +243,20 @@ static int patch_fd(int fd, const char *name, const struct stat *st, uid_t shift
                 if (r < 0)
                         return -errno;
 
-                /* The Linux kernel alters the mode in some cases of chown(). Let's undo this. */
-                if (name) {
-                        if (!S_ISLNK(st->st_mode))
-                                r = fchmodat(fd, name, st->st_mode, 0);
-                        else /* AT_SYMLINK_NOFOLLOW is not available for fchmodat() */
-                                r = 0;
-                } else
-                        r = fchmod(fd, st->st_mode);
-                if (r < 0)
-                        return -errno;
+                /* The Linux kernel alters the mode in some cases of chown(), i.e. it drops the SUID/SGID
+                 * bits. Let's undo this, but don't bother if there's nothing to restore, this saves a
+                 * syscall for almost every inode of the tree. */
+                if (st->st_mode & (S_ISUID|S_ISGID)) {
+                        if (name) {
+                                if (!S_ISLNK(st->st_mode))
+                                        r = fchmodat(fd, name, st->st_mode, 0);
+                                else /* AT_SYMLINK_NOFOLLOW is not available for fchmodat() */
+                                        r = 0;
+                        } else
+                                r = fchmod(fd, st->st_mode);
+                        if (r < 0)
+                                return -errno;
+                }
 
                 changed = true;
         }
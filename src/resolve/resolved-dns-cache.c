@@ -11,9 +11,9 @@
 #include "resolved-dns-packet.h"
 #include "string-util.h"
 
-/* Never cache more than 4K entries. RFC 1536, Section 5 suggests to
+/* By default, never cache more than 4K entries. RFC 1536, Section 5 suggests to
  * leave DNS caches unbounded, but that's crazy. */
-#define CACHE_MAX 4096
+#define CACHE_MAX 4096U
 
 /* We never keep any item longer than 2h in our cache */
 #define CACHE_TTL_MAX_USEC (2 * USEC_PER_HOUR)
@@ -168,14 +168,18 @@ void dns_cache_flush(DnsCache *c) {
 }
 
 static void dns_cache_make_space(DnsCache *c, unsigned add) {
+        unsigned max;
+
         assert(c);
 
         if (add <= 0)
                 return;
 
+        max = c->max_entries > 0 ? c->max_entries : CACHE_MAX;
+
         /* Makes space for n new entries. Note that we actually allow
-         * the cache to grow beyond CACHE_MAX, but only when we shall
-         * add more RRs to the cache than CACHE_MAX at once. In that
+         * the cache to grow beyond the maximum size, but only when we
+         * shall add more RRs to the cache than that at once. In that
          * case the cache will be emptied completely otherwise. */
 
         for (;;) {
@@ -185,7 +189,7 @@ static void dns_cache_make_space(DnsCache *c, unsigned add) {
                 if (prioq_size(c->by_expiry) <= 0)
                         break;
 
-                if (prioq_size(c->by_expiry) + add < CACHE_MAX)
+                if (prioq_size(c->by_expiry) + add < max)
                         break;
 
                 i = prioq_peek(c->by_expiry);
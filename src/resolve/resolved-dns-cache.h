@@ -11,6 +11,7 @@
 typedef struct DnsCache {
         Hashmap *by_key;
         Prioq *by_expiry;
+        unsigned max_entries; /* 0 selects the default */
         unsigned n_hit;
         unsigned n_miss;
 } DnsCache;
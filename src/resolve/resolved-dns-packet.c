@@ -577,7 +577,9 @@ int dns_packet_append_name(
                 if (r < 0)
                         goto fail;
 
-                if (allow_compression) {
+                /* Compression pointers have only 14 bits, hence there's no point in remembering names
+                 * that start beyond that. */
+                if (allow_compression && n < 0x4000) {
                         _cleanup_free_ char *s = NULL;
 
                         s = strdup(z);
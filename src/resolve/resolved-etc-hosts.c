@@ -124,10 +124,17 @@ static int parse_line(EtcHosts *hosts, unsigned nr, const char *line) {
                         continue;
                 }
 
-                r = strv_extend(&item->names, name);
-                if (r < 0)
+                /* Keep track of the number of names ourselves rather than using strv_extend(), as some
+                 * hosts files list a huge number of names for a single address. */
+                if (!GREEDY_REALLOC(item->names, item->n_allocated, item->n_names + 2))
+                        return log_oom();
+
+                item->names[item->n_names] = strdup(name);
+                if (!item->names[item->n_names])
                         return log_oom();
 
+                item->names[++item->n_names] = NULL;
+
                 bn = hashmap_get(hosts->by_name, name);
                 if (!bn) {
                         r = hashmap_ensure_allocated(&hosts->by_name, &dns_name_hash_ops);
@@ -391,7 +398,7 @@ int manager_etc_hosts_lookup(Manager *m, DnsQuestion* q, DnsAnswer **answer) {
                 if (found_ptr) {
                         char **n;
 
-                        r = dns_answer_reserve(answer, strv_length(item->names));
+                        r = dns_answer_reserve(answer, item->n_names);
                         if (r < 0)
                                 return r;
 
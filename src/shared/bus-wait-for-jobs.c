@@ -15,9 +15,9 @@ typedef struct BusWaitForJobs {
         /* The set of jobs to wait for, as bus object paths */
         Set *jobs;
 
-        /* The unit name and job result of the last Job message */
-        char *name;
-        char *result;
+        /* Unit names and job results of the JobRemoved messages not looked at yet, as pairs. Several of
+         * them may be dispatched at once, for example while waiting for pipelined method replies. */
+        char **results;
 
         sd_bus_slot *slot_job_removed;
         sd_bus_slot *slot_disconnected;
@@ -35,6 +35,7 @@ static int match_disconnected(sd_bus_message *m, void *userdata, sd_bus_error *e
 static int match_job_removed(sd_bus_message *m, void *userdata, sd_bus_error *error) {
         const char *path, *unit, *result;
         BusWaitForJobs *d = userdata;
+        _cleanup_free_ char *u = NULL, *res = NULL;
         uint32_t id;
         char *found;
         int r;
@@ -54,9 +55,19 @@ static int match_job_removed(sd_bus_message *m, void *userdata, sd_bus_error *er
 
         free(found);
 
-        (void) free_and_strdup(&d->result, empty_to_null(result));
+        if (isempty(unit) || isempty(result))
+                return 0;
+
+        u = strdup(unit);
+        res = strdup(result);
+        if (!u || !res) {
+                log_oom();
+                return 0;
+        }
 
-        (void) free_and_strdup(&d->name, empty_to_null(unit));
+        r = strv_consume_pair(&d->results, TAKE_PTR(u), TAKE_PTR(res));
+        if (r < 0)
+                log_oom();
 
         return 0;
 }
@@ -72,8 +83,7 @@ BusWaitForJobs* bus_wait_for_jobs_free(BusWaitForJobs *d) {
 
         sd_bus_unref(d->bus);
 
-        free(d->name);
-        free(d->result);
+        strv_free(d->results);
 
         return mfree(d);
 }
@@ -139,17 +149,17 @@ static int bus_process_wait(sd_bus *bus) {
         }
 }
 
-static int bus_job_get_service_result(BusWaitForJobs *d, char **result) {
+static int bus_job_get_service_result(BusWaitForJobs *d, const char *name, char **result) {
         _cleanup_free_ char *dbus_path = NULL;
 
         assert(d);
-        assert(d->name);
+        assert(name);
         assert(result);
 
-        if (!endswith(d->name, ".service"))
+        if (!endswith(name, ".service"))
                 return -EINVAL;
 
-        dbus_path = unit_dbus_path_from_name(d->name);
+        dbus_path = unit_dbus_path_from_name(name);
         if (!dbus_path)
                 return -ENOMEM;
 
@@ -228,63 +238,69 @@ finish:
                          service_shell_quoted ?: "<service>");
 }
 
-static int check_wait_response(BusWaitForJobs *d, bool quiet, const char* const* extra_args) {
+static int check_wait_response(
+                BusWaitForJobs *d,
+                const char *name,
+                const char *job_result,
+                bool quiet,
+                const char* const* extra_args) {
+
         assert(d);
-        assert(d->name);
-        assert(d->result);
+        assert(name);
+        assert(job_result);
 
         if (!quiet) {
-                if (streq(d->result, "canceled"))
-                        log_error("Job for %s canceled.", strna(d->name));
-                else if (streq(d->result, "timeout"))
-                        log_error("Job for %s timed out.", strna(d->name));
-                else if (streq(d->result, "dependency"))
-                        log_error("A dependency job for %s failed. See 'journalctl -xe' for details.", strna(d->name));
-                else if (streq(d->result, "invalid"))
-                        log_error("%s is not active, cannot reload.", strna(d->name));
-                else if (streq(d->result, "assert"))
-                        log_error("Assertion failed on job for %s.", strna(d->name));
-                else if (streq(d->result, "unsupported"))
-                        log_error("Operation on or unit type of %s not supported on this system.", strna(d->name));
-                else if (streq(d->result, "collected"))
-                        log_error("Queued job for %s was garbage collected.", strna(d->name));
-                else if (streq(d->result, "once"))
-                        log_error("Unit %s was started already once and can't be started again.", strna(d->name));
-                else if (!STR_IN_SET(d->result, "done", "skipped")) {
-
-                        if (d->name && endswith(d->name, ".service")) {
+                if (streq(job_result, "canceled"))
+                        log_error("Job for %s canceled.", name);
+                else if (streq(job_result, "timeout"))
+                        log_error("Job for %s timed out.", name);
+                else if (streq(job_result, "dependency"))
+                        log_error("A dependency job for %s failed. See 'journalctl -xe' for details.", name);
+                else if (streq(job_result, "invalid"))
+                        log_error("%s is not active, cannot reload.", name);
+                else if (streq(job_result, "assert"))
+                        log_error("Assertion failed on job for %s.", name);
+                else if (streq(job_result, "unsupported"))
+                        log_error("Operation on or unit type of %s not supported on this system.", name);
+                else if (streq(job_result, "collected"))
+                        log_error("Queued job for %s was garbage collected.", name);
+                else if (streq(job_result, "once"))
+                        log_error("Unit %s was started already once and can't be started again.", name);
+                else if (!STR_IN_SET(job_result, "done", "skipped")) {
+
+                        if (endswith(name, ".service")) {
                                 _cleanup_free_ char *result = NULL;
                                 int q;
 
-                                q = bus_job_get_service_result(d, &result);
+                                q = bus_job_get_service_result(d, name, &result);
                                 if (q < 0)
-                                        log_debug_errno(q, "Failed to get Result property of unit %s: %m", d->name);
+                                        log_debug_errno(q, "Failed to get Result property of unit %s: %m", name);
 
-                                log_job_error_with_service_result(d->name, result, extra_args);
+                                log_job_error_with_service_result(name, result, extra_args);
                         } else
                                 log_error("Job failed. See \"journalctl -xe\" for details.");
                 }
         }
 
-        if (STR_IN_SET(d->result, "canceled", "collected"))
+        if (STR_IN_SET(job_result, "canceled", "collected"))
                 return -ECANCELED;
-        else if (streq(d->result, "timeout"))
+        else if (streq(job_result, "timeout"))
                 return -ETIME;
-        else if (streq(d->result, "dependency"))
+        else if (streq(job_result, "dependency"))
                 return -EIO;
-        else if (streq(d->result, "invalid"))
+        else if (streq(job_result, "invalid"))
                 return -ENOEXEC;
-        else if (streq(d->result, "assert"))
+        else if (streq(job_result, "assert"))
                 return -EPROTO;
-        else if (streq(d->result, "unsupported"))
+        else if (streq(job_result, "unsupported"))
                 return -EOPNOTSUPP;
-        else if (streq(d->result, "once"))
+        else if (streq(job_result, "once"))
                 return -ESTALE;
-        else if (STR_IN_SET(d->result, "done", "skipped"))
+        else if (STR_IN_SET(job_result, "done", "skipped"))
                 return 0;
 
         return log_debug_errno(SYNTHETIC_ERRNO(EIO),
-                               "Unexpected job result, assuming server side newer than us: %s", d->result);
+                               "Unexpected job result, assuming server side newer than us: %s", job_result);
 }
 
 int bus_wait_for_jobs(BusWaitForJobs *d, bool quiet, const char* const* extra_args) {
@@ -292,25 +308,28 @@ int bus_wait_for_jobs(BusWaitForJobs *d, bool quiet, const char* const* extra_ar
 
         assert(d);
 
-        while (!set_isempty(d->jobs)) {
+        for (;;) {
+                char **name, **job_result;
                 int q;
 
-                q = bus_process_wait(d->bus);
-                if (q < 0)
-                        return log_error_errno(q, "Failed to wait for response: %m");
-
-                if (d->name && d->result) {
-                        q = check_wait_response(d, quiet, extra_args);
+                STRV_FOREACH_PAIR(name, job_result, d->results) {
+                        q = check_wait_response(d, *name, *job_result, quiet, extra_args);
                         /* Return the first error as it is most likely to be
                          * meaningful. */
                         if (q < 0 && r == 0)
                                 r = q;
 
-                        log_debug_errno(q, "Got result %s/%m for job %s", d->result, d->name);
+                        log_debug_errno(q, "Got result %s/%m for job %s", *job_result, *name);
                 }
 
-                d->name = mfree(d->name);
-                d->result = mfree(d->result);
+                d->results = strv_free(d->results);
+
+                if (set_isempty(d->jobs))
+                        break;
+
+                q = bus_process_wait(d->bus);
+                if (q < 0)
+                        return log_error_errno(q, "Failed to wait for response: %m");
         }
 
         return r;
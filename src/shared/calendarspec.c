@@ -1378,6 +1378,23 @@ static int calendar_spec_next_usec_impl(const CalendarSpec *spec, usec_t usec, u
         return 0;
 }
 
+static bool calendar_spec_timezone_is_local(const CalendarSpec *spec) {
+        _cleanup_free_ char *tz = NULL;
+
+        assert(spec);
+
+        /* Checks whether the timezone of the spec is the one we are running in anyway. Note that if $TZ is
+         * set it takes precedence over /etc/localtime, hence don't bother in that case. */
+
+        if (getenv("TZ"))
+                return false;
+
+        if (get_timezone(&tz) < 0)
+                return false;
+
+        return streq(tz, spec->timezone);
+}
+
 typedef struct SpecNextResult {
         usec_t next;
         int return_value;
@@ -1389,7 +1406,9 @@ int calendar_spec_next_usec(const CalendarSpec *spec, usec_t usec, usec_t *ret_n
 
         assert(spec);
 
-        if (isempty(spec->timezone))
+        /* If the timezone is the local one, we can skip the fork() below. This matters for PID1, which
+         * recalculates all timers on various occasions. */
+        if (isempty(spec->timezone) || calendar_spec_timezone_is_local(spec))
                 return calendar_spec_next_usec_impl(spec, usec, ret_next);
 
         shared = mmap(NULL, sizeof *shared, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_ANONYMOUS, -1, 0);
@@ -269,6 +269,7 @@ int config_parse(
         _cleanup_fclose_ FILE *ours = NULL;
         unsigned line = 0, section_line = 0;
         bool section_ignored = false, bom_seen = false;
+        ReadLineFlags read_flags = 0;
         int r, fd;
         usec_t mtime;
 
@@ -300,6 +301,11 @@ int config_parse(
 
                 (void) stat_warn_permissions(filename, &st);
                 mtime = timespec_load(&st.st_mtim);
+
+                /* Regular files are never TTYs, tell read_line() so that it doesn't have to check for every
+                 * single line again */
+                if (S_ISREG(st.st_mode))
+                        read_flags |= READ_LINE_NOT_A_TTY;
         } else
                 mtime = 0;
 
@@ -308,7 +314,7 @@ int config_parse(
                 bool escaped = false;
                 char *l, *p, *e;
 
-                r = read_line(f, LONG_LINE_MAX, &buf);
+                r = read_line_full(f, LONG_LINE_MAX, read_flags, &buf);
                 if (r == 0)
                         break;
                 if (r == -ENOBUFS) {
@@ -288,7 +288,8 @@ static int image_make(
                                 if (btrfs_quota_scan_ongoing(fd) == 0) {
                                         BtrfsQuotaInfo quota;
 
-                                        r = btrfs_subvol_get_subtree_quota_fd(fd, 0, &quota);
+                                        /* We know the subvolume ID already, no need to look it up again */
+                                        r = btrfs_subvol_get_subtree_quota_fd(fd, info.subvol_id, &quota);
                                         if (r >= 0) {
                                                 (*ret)->usage = quota.referenced;
                                                 (*ret)->usage_exclusive = quota.exclusive;
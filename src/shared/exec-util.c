@@ -4,6 +4,7 @@
 #include <errno.h>
 #include <sys/prctl.h>
 #include <sys/types.h>
+#include <sys/wait.h>
 #include <unistd.h>
 #include <stdio.h>
 
@@ -92,6 +93,7 @@ static int do_execute(
         _cleanup_hashmap_free_free_ Hashmap *pids = NULL;
         _cleanup_strv_free_ char **paths = NULL;
         char **path, **e;
+        usec_t start;
         int r;
         bool parallel_execution;
 
@@ -123,6 +125,8 @@ static int do_execute(
                 if (putenv(*e) != 0)
                         return log_error_errno(errno, "Failed to set environment variable: %m");
 
+        start = now(CLOCK_MONOTONIC);
+
         STRV_FOREACH(path, paths) {
                 _cleanup_free_ char *t = NULL;
                 _cleanup_close_ int fd = -1;
@@ -175,15 +179,36 @@ static int do_execute(
 
         while (!hashmap_isempty(pids)) {
                 _cleanup_free_ char *t = NULL;
+                char ts[FORMAT_TIMESPAN_MAX];
+                siginfo_t si = {};
                 pid_t pid;
 
-                pid = PTR_TO_PID(hashmap_first_key(pids));
+                /* Pick up the children in the order they finish, so that we can tell how long each one took,
+                 * but leave them around for wait_for_terminate_and_check() to reap them. Since they were all
+                 * started at about the same time, the time since we started them is a good enough estimate
+                 * of their runtime. */
+                if (waitid(P_ALL, 0, &si, WEXITED|WNOWAIT) < 0) {
+                        if (errno == EINTR)
+                                continue;
+
+                        return log_error_errno(errno, "Failed to wait for children: %m");
+                }
+
+                pid = si.si_pid;
                 assert(pid > 0);
 
                 t = hashmap_remove(pids, PID_TO_PTR(pid));
-                assert(t);
+                if (!t) {
+                        /* Not one of ours, just reap it */
+                        (void) wait_for_terminate(pid, NULL);
+                        continue;
+                }
 
                 r = wait_for_terminate_and_check(t, pid, WAIT_LOG);
+
+                log_debug("%s finished after %s.", t,
+                          format_timespan(ts, sizeof(ts), usec_sub_unsigned(now(CLOCK_MONOTONIC), start), USEC_PER_MSEC));
+
                 if (!FLAGS_SET(flags, EXEC_DIR_IGNORE_ERRORS) && r > 0)
                         return r;
         }
@@ -19,9 +19,11 @@
 #include "fd-util.h"
 #include "fileio.h"
 #include "fs-util.h"
+#include "glob-util.h"
 #include "hashmap.h"
 #include "install-printf.h"
 #include "install.h"
+#include "list.h"
 #include "locale-util.h"
 #include "log.h"
 #include "macro.h"
@@ -80,6 +82,10 @@ void unit_file_presets_freep(UnitFilePresets *p) {
         if (!p)
                 return;
 
+        p->literal_rules = hashmap_free(p->literal_rules);
+        p->glob_rules = mfree(p->glob_rules);
+        p->n_glob_rules = 0;
+
         for (size_t i = 0; i < p->n_rules; i++) {
                 free(p->rules[i].pattern);
                 strv_free(p->rules[i].instances);
@@ -705,22 +711,118 @@ static int is_symlink_with_known_name(const UnitFileInstallInfo *i, const char *
         return false;
 }
 
-static int find_symlinks_in_directory(
+typedef struct SymlinkEntry SymlinkEntry;
+
+struct SymlinkEntry {
+        char *name;             /* The name of the symlink itself */
+        char *dest;             /* The last component of what the symlink points to */
+        bool in_config_dir;     /* Whether the symlink is located directly in the config path */
+
+        LIST_FIELDS(SymlinkEntry, by_name);
+        LIST_FIELDS(SymlinkEntry, by_dest);
+};
+
+/* All symlinks found in a config path and its .wants/ and .requires/ subdirectories, indexed by their own
+ * name and by the name they point to. Building this once per config path and invocation turns looking up
+ * the state of every unit file from O(units × symlinks) syscalls into a couple of hash table lookups. */
+typedef struct SymlinkIndex {
+        char *config_path;
+        Hashmap *by_name;       /* symlink name → list of SymlinkEntry objects */
+        Hashmap *by_dest;       /* last component of destination → list of SymlinkEntry objects */
+        int error;              /* Failure to read the symlinks in the config path itself */
+} SymlinkIndex;
+
+static SymlinkEntry* symlink_entry_free(SymlinkEntry *e) {
+        if (!e)
+                return NULL;
+
+        free(e->name);
+        free(e->dest);
+        return mfree(e);
+}
+
+DEFINE_TRIVIAL_CLEANUP_FUNC(SymlinkEntry*, symlink_entry_free);
+
+static SymlinkIndex* symlink_index_free(SymlinkIndex *idx) {
+        SymlinkEntry *e;
+
+        if (!idx)
+                return NULL;
+
+        /* Every entry is linked into exactly one of the by_name lists, hence free them through those */
+        while ((e = hashmap_steal_first(idx->by_name)))
+                while (e) {
+                        SymlinkEntry *next = e->by_name_next;
+
+                        symlink_entry_free(e);
+                        e = next;
+                }
+
+        hashmap_free(idx->by_name);
+        hashmap_free(idx->by_dest);
+        free(idx->config_path);
+        return mfree(idx);
+}
+
+DEFINE_TRIVIAL_CLEANUP_FUNC(SymlinkIndex*, symlink_index_free);
+
+DEFINE_PRIVATE_HASH_OPS_WITH_VALUE_DESTRUCTOR(symlink_index_hash_ops, char, path_hash_func, path_compare,
+                                              SymlinkIndex, symlink_index_free);
+
+static int symlink_index_add(SymlinkIndex *idx, const char *name, const char *dest, bool in_config_dir) {
+        _cleanup_(symlink_entry_freep) SymlinkEntry *e = NULL;
+        SymlinkEntry *head;
+        int r;
+
+        assert(idx);
+        assert(name);
+        assert(dest);
+
+        e = new(SymlinkEntry, 1);
+        if (!e)
+                return -ENOMEM;
+
+        *e = (SymlinkEntry) {
+                .name = strdup(name),
+                .dest = strdup(dest),
+                .in_config_dir = in_config_dir,
+        };
+        if (!e->name || !e->dest)
+                return -ENOMEM;
+
+        head = hashmap_get(idx->by_name, e->name);
+        LIST_PREPEND(by_name, head, e);
+
+        r = hashmap_replace(idx->by_name, head->name, head);
+        if (r < 0) {
+                LIST_REMOVE(by_name, head, e);
+                return r;
+        }
+
+        /* From now on the entry is owned by the index. If we fail below, the index is incomplete and
+         * hence discarded by the caller. */
+        head = hashmap_get(idx->by_dest, e->dest);
+        LIST_PREPEND(by_dest, head, e);
+        TAKE_PTR(e);
+
+        return hashmap_replace(idx->by_dest, head->dest, head);
+}
+
+static int symlink_index_add_directory(
+                SymlinkIndex *idx,
                 DIR *dir,
                 const char *dir_path,
-                const char *root_dir,
-                const UnitFileInstallInfo *i,
-                bool match_aliases,
-                bool ignore_same_name,
-                const char *config_path,
-                bool *same_name_link) {
+                bool in_config_dir) {
 
         struct dirent *de;
         int r = 0;
 
+        assert(idx);
+        assert(dir);
+        assert(dir_path);
+
         FOREACH_DIRENT(de, dir, return -errno) {
                 _cleanup_free_ char *dest = NULL;
-                bool found_path = false, found_dest, b = false;
                 int q;
 
                 dirent_ensure_type(dir, de);
@@ -738,82 +840,44 @@ static int find_symlinks_in_directory(
                         continue;
                 }
 
-                /* Make absolute */
-                if (!path_is_absolute(dest)) {
-                        char *x;
-
-                        x = path_join(dir_path, dest);
-                        if (!x)
-                                return -ENOMEM;
-
-                        free_and_replace(dest, x);
-                }
-
-                assert(unit_name_is_valid(i->name, UNIT_NAME_ANY));
-                if (!ignore_same_name)
-                               /* Check if the symlink itself matches what we are looking for.
-                                *
-                                * If ignore_same_name is specified, we are in one of the directories which
-                                * have lower priority than the unit file, and even if a file or symlink with
-                                * this name was found, we should ignore it. */
-                                found_path = streq(de->d_name, i->name);
-
-                /* Check if what the symlink points to matches what we are looking for */
-                found_dest = streq(basename(dest), i->name);
-
-                if (found_path && found_dest) {
-                        _cleanup_free_ char *p = NULL, *t = NULL;
-
-                        /* Filter out same name links in the main
-                         * config path */
-                        p = path_make_absolute(de->d_name, dir_path);
-                        t = path_make_absolute(i->name, config_path);
-
-                        if (!p || !t)
-                                return -ENOMEM;
-
-                        b = path_equal(p, t);
-                }
-
-                if (b)
-                        *same_name_link = true;
-                else if (found_path || found_dest) {
-                        if (!match_aliases)
-                                return 1;
-
-                        /* Check if symlink name is in the set of names used by [Install] */
-                        q = is_symlink_with_known_name(i, de->d_name);
-                        if (q < 0)
-                                return q;
-                        if (q > 0)
-                                return 1;
-                }
+                /* Only the last component of the destination is ever looked at, hence there's no need to
+                 * make it absolute first. */
+                q = symlink_index_add(idx, de->d_name, basename(dest), in_config_dir);
+                if (q < 0)
+                        return q;
         }
 
         return r;
 }
 
-static int find_symlinks(
-                const char *root_dir,
-                const UnitFileInstallInfo *i,
-                bool match_name,
-                bool ignore_same_name,
-                const char *config_path,
-                bool *same_name_link) {
-
+static int symlink_index_new(const char *config_path, SymlinkIndex **ret) {
+        _cleanup_(symlink_index_freep) SymlinkIndex *idx = NULL;
         _cleanup_closedir_ DIR *config_dir = NULL;
         struct dirent *de;
-        int r = 0;
+        int r;
 
-        assert(i);
         assert(config_path);
-        assert(same_name_link);
+        assert(ret);
+
+        idx = new(SymlinkIndex, 1);
+        if (!idx)
+                return -ENOMEM;
+
+        *idx = (SymlinkIndex) {
+                .config_path = strdup(config_path),
+                .by_name = hashmap_new(&string_hash_ops),
+                .by_dest = hashmap_new(&string_hash_ops),
+        };
+        if (!idx->config_path || !idx->by_name || !idx->by_dest)
+                return -ENOMEM;
 
         config_dir = opendir(config_path);
         if (!config_dir) {
-                if (IN_SET(errno, ENOENT, ENOTDIR, EACCES))
-                        return 0;
-                return -errno;
+                if (!IN_SET(errno, ENOENT, ENOTDIR, EACCES))
+                        return -errno;
+
+                *ret = TAKE_PTR(idx);
+                return 0;
         }
 
         FOREACH_DIRENT(de, config_dir, return -errno) {
@@ -840,21 +904,117 @@ static int find_symlinks(
                         continue;
                 }
 
-                r = find_symlinks_in_directory(d, path, root_dir, i, match_name, ignore_same_name, config_path, same_name_link);
-                if (r > 0)
-                        return 1;
-                else if (r < 0)
+                r = symlink_index_add_directory(idx, d, path, false);
+                if (r == -ENOMEM)
+                        return r;
+                if (r < 0)
                         log_debug_errno(r, "Failed to lookup for symlinks in '%s': %m", path);
         }
 
-        /* We didn't find any suitable symlinks in .wants or .requires directories, let's look for linked unit files in this directory. */
+        /* Also remember the linked unit files in this directory itself. */
         rewinddir(config_dir);
-        return find_symlinks_in_directory(config_dir, config_path, root_dir, i, match_name, ignore_same_name, config_path, same_name_link);
+        r = symlink_index_add_directory(idx, config_dir, config_path, true);
+        if (r == -ENOMEM)
+                return r;
+        idx->error = r;
+
+        *ret = TAKE_PTR(idx);
+        return 0;
+}
+
+static int symlink_entry_matches(
+                const SymlinkEntry *e,
+                const UnitFileInstallInfo *i,
+                bool match_aliases,
+                bool ignore_same_name,
+                bool *same_name_link) {
+
+        bool found_path, found_dest;
+
+        assert(e);
+        assert(i);
+        assert(same_name_link);
+
+        /* Check if the symlink itself matches what we are looking for.
+         *
+         * If ignore_same_name is specified, we are in one of the directories which
+         * have lower priority than the unit file, and even if a file or symlink with
+         * this name was found, we should ignore it. */
+        found_path = !ignore_same_name && streq(e->name, i->name);
+
+        /* Check if what the symlink points to matches what we are looking for */
+        found_dest = streq(e->dest, i->name);
+
+        /* Filter out same name links in the main config path */
+        if (found_path && found_dest && e->in_config_dir) {
+                *same_name_link = true;
+                return 0;
+        }
+
+        if (!found_path && !found_dest)
+                return 0;
+
+        if (!match_aliases)
+                return 1;
+
+        /* Check if symlink name is in the set of names used by [Install] */
+        return is_symlink_with_known_name(i, e->name);
+}
+
+static int find_symlinks(
+                Hashmap **symlink_indexes,
+                const UnitFileInstallInfo *i,
+                bool match_name,
+                bool ignore_same_name,
+                const char *config_path,
+                bool *same_name_link) {
+
+        SymlinkIndex *idx;
+        SymlinkEntry *e;
+        int r;
+
+        assert(symlink_indexes);
+        assert(i);
+        assert(config_path);
+        assert(same_name_link);
+
+        assert(unit_name_is_valid(i->name, UNIT_NAME_ANY));
+
+        idx = hashmap_get(*symlink_indexes, config_path);
+        if (!idx) {
+                _cleanup_(symlink_index_freep) SymlinkIndex *n = NULL;
+
+                r = symlink_index_new(config_path, &n);
+                if (r < 0)
+                        return r;
+
+                r = hashmap_ensure_put(symlink_indexes, &symlink_index_hash_ops, n->config_path, n);
+                if (r < 0)
+                        return r;
+
+                idx = TAKE_PTR(n);
+        }
+
+        /* Only symlinks that are named like the unit or point to it are of interest */
+        LIST_FOREACH(by_name, e, hashmap_get(idx->by_name, i->name)) {
+                r = symlink_entry_matches(e, i, match_name, ignore_same_name, same_name_link);
+                if (r != 0)
+                        return r;
+        }
+
+        LIST_FOREACH(by_dest, e, hashmap_get(idx->by_dest, i->name)) {
+                r = symlink_entry_matches(e, i, match_name, ignore_same_name, same_name_link);
+                if (r != 0)
+                        return r;
+        }
+
+        return idx->error;
 }
 
 static int find_symlinks_in_scope(
                 UnitFileScope scope,
                 const LookupPaths *paths,
+                Hashmap **symlink_indexes,
                 const UnitFileInstallInfo *i,
                 bool match_name,
                 UnitFileState *state) {
@@ -875,7 +1035,7 @@ static int find_symlinks_in_scope(
         STRV_FOREACH(p, paths->search_path)  {
                 bool same_name_link = false;
 
-                r = find_symlinks(paths->root_dir, i, match_name, ignore_same_name, *p, &same_name_link);
+                r = find_symlinks(symlink_indexes, i, match_name, ignore_same_name, *p, &same_name_link);
                 if (r < 0)
                         return r;
                 if (r > 0) {
@@ -1398,6 +1558,34 @@ static int unit_file_load_or_readlink(
         return 0;
 }
 
+static int add_dropin_dirs(char ***dirs, char **search_path, const char *dropin_dir_name) {
+        char **p;
+        int r;
+
+        assert(dirs);
+        assert(dropin_dir_name);
+
+        STRV_FOREACH(p, search_path) {
+                _cleanup_free_ char *path = NULL;
+
+                path = path_join(*p, dropin_dir_name);
+                if (!path)
+                        return -ENOMEM;
+
+                /* Most units have no drop-ins at all, and conf_files_list_strv() would resolve each of these
+                 * directories component by component before finding out. Hence, skip the ones that don't
+                 * exist right away. */
+                if (access(path, F_OK) < 0 && IN_SET(errno, ENOENT, ENOTDIR))
+                        continue;
+
+                r = strv_consume(dirs, TAKE_PTR(path));
+                if (r < 0)
+                        return r;
+        }
+
+        return 0;
+}
+
 static int unit_file_search(
                 InstallContext *c,
                 UnitFileInstallInfo *info,
@@ -1481,31 +1669,15 @@ static int unit_file_search(
         /* Search for drop-in directories */
 
         dropin_dir_name = strjoina(info->name, ".d");
-        STRV_FOREACH(p, paths->search_path) {
-                char *path;
-
-                path = path_join(*p, dropin_dir_name);
-                if (!path)
-                        return -ENOMEM;
-
-                r = strv_consume(&dirs, path);
-                if (r < 0)
-                        return r;
-        }
+        r = add_dropin_dirs(&dirs, paths->search_path, dropin_dir_name);
+        if (r < 0)
+                return r;
 
         if (template) {
                 dropin_template_dir_name = strjoina(template, ".d");
-                STRV_FOREACH(p, paths->search_path) {
-                        char *path;
-
-                        path = path_join(*p, dropin_template_dir_name);
-                        if (!path)
-                                return -ENOMEM;
-
-                        r = strv_consume(&dirs, path);
-                        if (r < 0)
-                                return r;
-                }
+                r = add_dropin_dirs(&dirs, paths->search_path, dropin_template_dir_name);
+                if (r < 0)
+                        return r;
         }
 
         /* Load drop-in conf files */
@@ -2746,9 +2918,10 @@ int unit_file_get_default(
         return 0;
 }
 
-int unit_file_lookup_state(
+static int unit_file_lookup_state_full(
                 UnitFileScope scope,
                 const LookupPaths *paths,
+                Hashmap **symlink_indexes,
                 const char *name,
                 UnitFileState *ret) {
 
@@ -2812,7 +2985,7 @@ int unit_file_lookup_state(
                 /* Check if any of the Alias= symlinks have been created.
                  * We ignore other aliases, and only check those that would
                  * be created by systemctl enable for this unit. */
-                r = find_symlinks_in_scope(scope, paths, i, true, &state);
+                r = find_symlinks_in_scope(scope, paths, symlink_indexes, i, true, &state);
                 if (r < 0)
                         return r;
                 if (r > 0)
@@ -2820,7 +2993,7 @@ int unit_file_lookup_state(
 
                 /* Check if the file is known under other names. If it is,
                  * it might be in use. Report that as UNIT_FILE_INDIRECT. */
-                r = find_symlinks_in_scope(scope, paths, i, false, &state);
+                r = find_symlinks_in_scope(scope, paths, symlink_indexes, i, false, &state);
                 if (r < 0)
                         return r;
                 if (r > 0)
@@ -2844,6 +3017,17 @@ int unit_file_lookup_state(
         return 0;
 }
 
+int unit_file_lookup_state(
+                UnitFileScope scope,
+                const LookupPaths *paths,
+                const char *name,
+                UnitFileState *ret) {
+
+        _cleanup_hashmap_free_ Hashmap *symlink_indexes = NULL;
+
+        return unit_file_lookup_state_full(scope, paths, &symlink_indexes, name, ret);
+}
+
 int unit_file_get_state(
                 UnitFileScope scope,
                 const char *root_dir,
@@ -2934,6 +3118,42 @@ static int presets_find_config(UnitFileScope scope, const char *root_dir, char *
         return conf_files_list_strv(files, ".preset", root_dir, 0, dirs);
 }
 
+static int presets_index_rules(UnitFilePresets *ps) {
+        assert(ps);
+
+        /* Rules are matched in order and the first match wins. Most of them name a single unit though, so
+         * look those up in a hash table, and only match the globs (and rules with instances, which match
+         * on the template name too) one by one. */
+
+        if (ps->n_rules == 0)
+                return 0;
+
+        ps->literal_rules = hashmap_new(&string_hash_ops);
+        if (!ps->literal_rules)
+                return -ENOMEM;
+
+        ps->glob_rules = new(size_t, ps->n_rules);
+        if (!ps->glob_rules)
+                return -ENOMEM;
+
+        for (size_t i = 0; i < ps->n_rules; i++) {
+                const UnitFilePresetRule *rule = ps->rules + i;
+                int r;
+
+                if (rule->instances || string_is_glob(rule->pattern)) {
+                        ps->glob_rules[ps->n_glob_rules++] = i;
+                        continue;
+                }
+
+                /* Later rules with the same pattern can never match, skip them */
+                r = hashmap_put(ps->literal_rules, rule->pattern, SIZE_TO_PTR(i + 1));
+                if (r < 0 && r != -EEXIST)
+                        return r;
+        }
+
+        return 0;
+}
+
 static int read_presets(UnitFileScope scope, const char *root_dir, UnitFilePresets *presets) {
         _cleanup_(unit_file_presets_freep) UnitFilePresets ps = {};
         size_t n_allocated = 0;
@@ -3026,6 +3246,10 @@ static int read_presets(UnitFileScope scope, const char *root_dir, UnitFilePrese
                 }
         }
 
+        r = presets_index_rules(&ps);
+        if (r < 0)
+                return r;
+
         ps.initialized = true;
         *presets = ps;
         ps = (UnitFilePresets){};
@@ -3087,16 +3311,28 @@ static int pattern_match_multiple_instances(
 
 static int query_presets(const char *name, const UnitFilePresets *presets, char ***instance_name_list) {
         PresetAction action = PRESET_UNKNOWN;
+        size_t literal;
 
         if (!unit_name_is_valid(name, UNIT_NAME_ANY))
                 return -EINVAL;
 
-        for (size_t i = 0; i < presets->n_rules; i++)
-                if (pattern_match_multiple_instances(presets->rules[i], name, instance_name_list) > 0 ||
-                    fnmatch(presets->rules[i].pattern, name, FNM_NOESCAPE) == 0) {
-                        action = presets->rules[i].action;
+        /* A glob rule only takes precedence over a literal match if it comes first */
+        literal = PTR_TO_SIZE(hashmap_get(presets->literal_rules, name));
+        literal = literal > 0 ? literal - 1 : presets->n_rules;
+
+        for (size_t k = 0; k < presets->n_glob_rules && presets->glob_rules[k] < literal; k++) {
+                const UnitFilePresetRule *rule = presets->rules + presets->glob_rules[k];
+
+                if (pattern_match_multiple_instances(*rule, name, instance_name_list) > 0 ||
+                    fnmatch(rule->pattern, name, FNM_NOESCAPE) == 0) {
+                        action = rule->action;
+                        literal = presets->n_rules;
                         break;
                 }
+        }
+
+        if (literal < presets->n_rules)
+                action = presets->rules[literal].action;
 
         switch (action) {
         case PRESET_UNKNOWN:
@@ -3367,6 +3603,7 @@ int unit_file_get_list(
                 char **patterns) {
 
         _cleanup_(lookup_paths_free) LookupPaths paths = {};
+        _cleanup_hashmap_free_ Hashmap *symlink_indexes = NULL;
         char **dirname;
         int r;
 
@@ -3419,7 +3656,7 @@ int unit_file_get_list(
                         if (!f->path)
                                 return -ENOMEM;
 
-                        r = unit_file_lookup_state(scope, &paths, de->d_name, &f->state);
+                        r = unit_file_lookup_state_full(scope, &paths, &symlink_indexes, de->d_name, &f->state);
                         if (r < 0)
                                 f->state = UNIT_FILE_BAD;
 
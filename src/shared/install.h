@@ -196,6 +196,9 @@ typedef struct UnitFilePresetRule UnitFilePresetRule;
 typedef struct {
         UnitFilePresetRule *rules;
         size_t n_rules;
+        Hashmap *literal_rules;  /* pattern without globs → index + 1 of the first rule using it */
+        size_t *glob_rules;      /* indexes of all other rules, in order */
+        size_t n_glob_rules;
         bool initialized;
 } UnitFilePresets;
 
@@ -445,7 +445,9 @@ void journal_importer_drop_iovw(JournalImporter *imp) {
 
         /* This function drops processed data that along with the iovw that points at it */
 
-        iovw_free_contents(&imp->iovw, false);
+        /* The iovecs only point into our buffer, hence just forget them. We keep the array itself around
+         * though, since the next entry most likely has a similar number of fields. */
+        imp->iovw.count = 0;
 
         /* possibly reset buffer position */
         remain = imp->filled - imp->offset;
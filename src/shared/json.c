@@ -19,6 +19,9 @@
 #include "json.h"
 #include "macro.h"
 #include "memory-util.h"
+#include "mempool.h"
+#include "process-util.h"
+#include "siphash24.h"
 #include "string-table.h"
 #include "string-util.h"
 #include "strv.h"
@@ -90,6 +93,9 @@ struct JsonVariant {
         /* If in addition to this object all objects referenced by it are also ordered strictly by name */
         bool normalized:1;
 
+        /* Whether this stand-alone variant was allocated from json_variant_pool */
+        bool from_pool:1;
+
         union {
                 /* For simple types we store the value in-line. */
                 JsonValue value;
@@ -288,18 +294,28 @@ static JsonVariant *json_variant_conservative_formalize(JsonVariant *v) {
         return json_variant_formalize(v);
 }
 
+/* Most stand-alone variants are numbers or short strings, which fit into a single JsonVariant. The parser
+ * creates one of those for every scalar it encounters, only to copy it into the surrounding array or object
+ * and release it right after, hence allocate them from a pool. */
+DEFINE_MEMPOOL(json_variant_pool, JsonVariant, 64);
+
 static int json_variant_new(JsonVariant **ret, JsonVariantType type, size_t space) {
         JsonVariant *v;
+        size_t size;
+        bool use_pool;
 
         assert_return(ret, -EINVAL);
 
-        v = malloc0(MAX(sizeof(JsonVariant),
-                        offsetof(JsonVariant, value) + space));
+        size = MAX(sizeof(JsonVariant), offsetof(JsonVariant, value) + space);
+        use_pool = size == sizeof(JsonVariant) && mempool_enabled();
+
+        v = use_pool ? mempool_alloc0_tile(&json_variant_pool) : malloc0(size);
         if (!v)
                 return -ENOMEM;
 
         v->n_ref = 1;
         v->type = type;
+        v->from_pool = use_pool;
 
         *ret = v;
         return 0;
@@ -827,8 +843,16 @@ JsonVariant *json_variant_unref(JsonVariant *v) {
                 v->n_ref--;
 
                 if (v->n_ref == 0) {
+                        bool from_pool = v->from_pool;
+
                         json_variant_free_inner(v, false);
-                        free(v);
+
+                        if (from_pool) {
+                                /* Ensure that the object didn't get migrated between threads. */
+                                assert_se(is_main_thread());
+                                mempool_free_tile(&json_variant_pool, v);
+                        } else
+                                free(v);
                 }
         }
 
@@ -2414,8 +2438,22 @@ static int json_parse_string(const char **p, char **ret) {
         c++;
 
         for (;;) {
+                const char *e;
                 int len;
 
+                /* Copy runs of plain printable ASCII in one go, so that we don't have to validate and grow the
+                 * buffer character by character for the common case. */
+                for (e = c; *e >= ' ' && *e < 0x7f && !IN_SET(*e, '"', '\\'); e++)
+                        ;
+                if (e > c) {
+                        if (!GREEDY_REALLOC(s, allocated, n + (e - c) + 1))
+                                return -ENOMEM;
+
+                        memcpy(s + n, c, e - c);
+                        n += e - c;
+                        c = e;
+                }
+
                 /* Check for EOF */
                 if (*c == 0)
                         return -EINVAL;
@@ -3920,9 +3958,60 @@ int json_log_internal(
                                 NULL);
 }
 
+/* Dispatch tables with at least this many named entries are looked up via a hash table rather than linearly */
+#define JSON_DISPATCH_HASH_MIN 16U
+
+static size_t json_dispatch_hash(const char *name, size_t n_buckets) {
+        static const uint8_t hash_key[16] = {};
+
+        return (size_t) siphash24_string(name, hash_key) & (n_buckets - 1);
+}
+
+static void json_dispatch_index_build(const JsonDispatch table[], size_t n, unsigned *buckets, size_t n_buckets) {
+        assert(table);
+        assert(buckets);
+        assert(n_buckets > n);
+
+        /* Builds an open addressing hash table of the first n table entries, which are all named. Each
+         * bucket contains the table index plus one, or zero if unused. If a name is listed twice, the first
+         * entry wins, as with the linear search. */
+
+        for (size_t i = 0; i < n; i++) {
+                size_t h;
+
+                for (h = json_dispatch_hash(table[i].name, n_buckets); buckets[h] != 0; h = (h + 1) & (n_buckets - 1))
+                        if (streq(table[buckets[h] - 1].name, table[i].name))
+                                break;
+
+                if (buckets[h] == 0)
+                        buckets[h] = i + 1;
+        }
+}
+
+static const JsonDispatch *json_dispatch_index_find(
+                const JsonDispatch table[],
+                size_t n,
+                const unsigned *buckets,
+                size_t n_buckets,
+                const char *name) {
+
+        assert(table);
+        assert(buckets);
+
+        if (name)
+                for (size_t h = json_dispatch_hash(name, n_buckets); buckets[h] != 0; h = (h + 1) & (n_buckets - 1))
+                        if (streq(table[buckets[h] - 1].name, name))
+                                return table + buckets[h] - 1;
+
+        /* Not found? Then return what follows the named entries, i.e. either the catch-all entry, or the
+         * terminating one. */
+        return table + n;
+}
+
 int json_dispatch(JsonVariant *v, const JsonDispatch table[], JsonDispatchCallback bad, JsonDispatchFlags flags, void *userdata) {
         const JsonDispatch *p;
-        size_t i, n, m;
+        size_t i, n, m, n_named, n_buckets = 0;
+        unsigned *buckets = NULL;
         int r, done = 0;
         bool *found;
 
@@ -3940,17 +4029,32 @@ int json_dispatch(JsonVariant *v, const JsonDispatch table[], JsonDispatchCallba
 
         found = newa0(bool, m);
 
+        /* Entries after the first catch-all one are never matched by name */
+        for (n_named = 0; n_named < m && table[n_named].name != POINTER_MAX; n_named++)
+                ;
+
         n = json_variant_elements(v);
+
+        /* Large tables are scanned once for each field otherwise, hence index them first */
+        if (n_named >= JSON_DISPATCH_HASH_MIN && n > 2) {
+                n_buckets = 1U << log2u_round_up(n_named * 2);
+                buckets = newa0(unsigned, n_buckets);
+                json_dispatch_index_build(table, n_named, buckets, n_buckets);
+        }
+
         for (i = 0; i < n; i += 2) {
                 JsonVariant *key, *value;
 
                 assert_se(key = json_variant_by_index(v, i));
                 assert_se(value = json_variant_by_index(v, i+1));
 
-                for (p = table; p->name; p++)
-                        if (p->name == POINTER_MAX ||
-                            streq_ptr(json_variant_string(key), p->name))
-                                break;
+                if (buckets)
+                        p = json_dispatch_index_find(table, n_named, buckets, n_buckets, json_variant_string(key));
+                else
+                        for (p = table; p->name; p++)
+                                if (p->name == POINTER_MAX ||
+                                    streq_ptr(json_variant_string(key), p->name))
+                                        break;
 
                 if (p->name) { /* Found a matching entry! :-) */
                         JsonDispatchFlags merged_flags;
@@ -31,6 +31,7 @@
 #include "parse-util.h"
 #include "pretty-print.h"
 #include "process-util.h"
+#include "sort-util.h"
 #include "sparse-endian.h"
 #include "stdio-util.h"
 #include "string-table.h"
@@ -983,6 +984,338 @@ static int update_json_data_split(
         return update_json_data(h, flags, name, eq + 1, size - fieldlen - 1);
 }
 
+/* Formatting each entry into a JsonVariant object first, and then dumping that is slow, and most of that work
+ * is pointless for the compact formats. Hence, for those we format the values right away into a single
+ * buffer, and only remember where each field starts. Fields with multiple values are grouped into an array,
+ * as json_variant_new_object() would need it. */
+typedef struct JsonField {
+        size_t name, name_size;       /* Offsets into JsonEntry.buffer */
+        size_t value, value_size;     /* ditto, value is already formatted as JSON */
+        size_t next;                  /* Next field with the same name, or SIZE_MAX */
+        bool merged;                  /* Printed along with an earlier field of the same name */
+} JsonField;
+
+typedef struct JsonEntry {
+        char *buffer;
+        size_t size, allocated;
+
+        JsonField *fields;
+        size_t n_fields, n_fields_allocated;
+} JsonEntry;
+
+static void json_entry_done(JsonEntry *e) {
+        assert(e);
+
+        e->buffer = mfree(e->buffer);
+        e->fields = mfree(e->fields);
+}
+
+static int json_entry_append(JsonEntry *e, const void *p, size_t l) {
+        assert(e);
+
+        if (!GREEDY_REALLOC(e->buffer, e->allocated, e->size + l))
+                return -ENOMEM;
+
+        memcpy_safe(e->buffer + e->size, p, l);
+        e->size += l;
+        return 0;
+}
+
+static int json_entry_append_string(JsonEntry *e, const char *p, size_t l) {
+        int r;
+
+        assert(e);
+
+        /* Must escape the same way as json_format_string() does */
+
+        r = json_entry_append(e, "\"", 1);
+        if (r < 0)
+                return r;
+
+        while (l > 0) {
+                char buf[STRLEN("\\u0000") + 1];
+                const char *esc;
+                size_t k;
+
+                for (k = 0; k < l && (uint8_t) p[k] >= ' ' && !IN_SET(p[k], '"', '\\'); k++)
+                        ;
+
+                r = json_entry_append(e, p, k);
+                if (r < 0)
+                        return r;
+
+                p += k;
+                l -= k;
+                if (l == 0)
+                        break;
+
+                switch (*p) {
+                case '"':  esc = "\\\""; break;
+                case '\\': esc = "\\\\"; break;
+                case '\b': esc = "\\b";  break;
+                case '\f': esc = "\\f";  break;
+                case '\n': esc = "\\n";  break;
+                case '\r': esc = "\\r";  break;
+                case '\t': esc = "\\t";  break;
+                default:
+                        xsprintf(buf, "\\u%04x", (uint8_t) *p);
+                        esc = buf;
+                }
+
+                r = json_entry_append(e, esc, strlen(esc));
+                if (r < 0)
+                        return r;
+
+                p++;
+                l--;
+        }
+
+        return json_entry_append(e, "\"", 1);
+}
+
+static int json_entry_append_bytes(JsonEntry *e, const uint8_t *p, size_t l) {
+        char buf[1 + DECIMAL_STR_MAX(uint8_t)];
+        int r;
+
+        assert(e);
+
+        r = json_entry_append(e, "[", 1);
+        if (r < 0)
+                return r;
+
+        for (size_t i = 0; i < l; i++) {
+                int k;
+
+                k = snprintf(buf, sizeof(buf), i > 0 ? ",%u" : "%u", p[i]);
+                assert(k > 0 && (size_t) k < sizeof(buf));
+
+                r = json_entry_append(e, buf, k);
+                if (r < 0)
+                        return r;
+        }
+
+        return json_entry_append(e, "]", 1);
+}
+
+static int json_entry_add_field(
+                JsonEntry *e,
+                OutputFlags flags,
+                const char *name,
+                size_t name_size,
+                const void *value,
+                size_t size) {
+
+        JsonField *field;
+        int r;
+
+        assert(e);
+
+        if (!GREEDY_REALLOC(e->fields, e->n_fields_allocated, e->n_fields + 1))
+                return log_oom();
+
+        field = e->fields + e->n_fields;
+        *field = (JsonField) {
+                .name = e->size,
+                .name_size = name_size,
+                .next = SIZE_MAX,
+        };
+
+        /* Field names are validated, hence need no escaping */
+        r = json_entry_append(e, name, name_size);
+        if (r < 0)
+                return log_oom();
+
+        field->value = e->size;
+
+        if (!(flags & OUTPUT_SHOW_ALL) && name_size + 1 + size >= JSON_THRESHOLD)
+                r = json_entry_append(e, "null", 4);
+        else if (utf8_is_printable(value, size))
+                r = json_entry_append_string(e, value, size);
+        else
+                r = json_entry_append_bytes(e, value, size);
+        if (r < 0)
+                return log_oom();
+
+        field->value_size = e->size - field->value;
+        e->n_fields++;
+
+        return 0;
+}
+
+static int json_field_compare(const size_t *a, const size_t *b, JsonEntry *e) {
+        const JsonField *x = e->fields + *a, *y = e->fields + *b;
+        int r;
+
+        r = memcmp(e->buffer + x->name, e->buffer + y->name, MIN(x->name_size, y->name_size));
+        if (r != 0)
+                return r;
+
+        r = CMP(x->name_size, y->name_size);
+        if (r != 0)
+                return r;
+
+        /* Keep the values of a field in the order they appear in */
+        return CMP(*a, *b);
+}
+
+static int json_entry_group_fields(JsonEntry *e) {
+        _cleanup_free_ size_t *sorted = NULL;
+
+        assert(e);
+
+        if (e->n_fields <= 1)
+                return 0;
+
+        sorted = new(size_t, e->n_fields);
+        if (!sorted)
+                return log_oom();
+
+        for (size_t i = 0; i < e->n_fields; i++)
+                sorted[i] = i;
+
+        typesafe_qsort_r(sorted, e->n_fields, json_field_compare, e);
+
+        for (size_t i = 1; i < e->n_fields; i++) {
+                JsonField *a = e->fields + sorted[i-1], *b = e->fields + sorted[i];
+
+                if (a->name_size != b->name_size ||
+                    memcmp(e->buffer + a->name, e->buffer + b->name, a->name_size) != 0)
+                        continue;
+
+                a->next = sorted[i];
+                b->merged = true;
+        }
+
+        return 0;
+}
+
+static void json_entry_dump(JsonEntry *e, JsonFormatFlags format_flags, FILE *f) {
+        bool first = true;
+
+        assert(e);
+        assert(f);
+
+        if (format_flags & JSON_FORMAT_SSE)
+                fputs("data: ", f);
+        if (format_flags & JSON_FORMAT_SEQ)
+                fputc('\x1e', f);
+
+        fputc('{', f);
+
+        for (size_t i = 0; i < e->n_fields; i++) {
+                const JsonField *field = e->fields + i;
+
+                if (field->merged)
+                        continue;
+
+                if (!first)
+                        fputc(',', f);
+                first = false;
+
+                fputc('"', f);
+                fwrite(e->buffer + field->name, 1, field->name_size, f);
+                fputs("\":", f);
+
+                if (field->next == SIZE_MAX) {
+                        fwrite(e->buffer + field->value, 1, field->value_size, f);
+                        continue;
+                }
+
+                fputc('[', f);
+                for (const JsonField *v = field;; v = e->fields + v->next) {
+                        if (v != field)
+                                fputc(',', f);
+
+                        fwrite(e->buffer + v->value, 1, v->value_size, f);
+
+                        if (v->next == SIZE_MAX)
+                                break;
+                }
+                fputc(']', f);
+        }
+
+        fputs("}\n", f);
+        if (format_flags & JSON_FORMAT_SSE)
+                fputc('\n', f);
+}
+
+static int output_json_direct(
+                FILE *f,
+                sd_journal *j,
+                OutputMode mode,
+                OutputFlags flags,
+                const Set *output_fields,
+                const char *cursor,
+                uint64_t realtime,
+                uint64_t monotonic,
+                sd_id128_t boot_id) {
+
+        char sid[SD_ID128_STRING_MAX], usecbuf[DECIMAL_STR_MAX(usec_t)];
+        _cleanup_(json_entry_done) JsonEntry e = {};
+        int r;
+
+        r = json_entry_add_field(&e, flags, "__CURSOR", STRLEN("__CURSOR"), cursor, strlen(cursor));
+        if (r < 0)
+                return r;
+
+        xsprintf(usecbuf, USEC_FMT, realtime);
+        r = json_entry_add_field(&e, flags, "__REALTIME_TIMESTAMP", STRLEN("__REALTIME_TIMESTAMP"), usecbuf, strlen(usecbuf));
+        if (r < 0)
+                return r;
+
+        xsprintf(usecbuf, USEC_FMT, monotonic);
+        r = json_entry_add_field(&e, flags, "__MONOTONIC_TIMESTAMP", STRLEN("__MONOTONIC_TIMESTAMP"), usecbuf, strlen(usecbuf));
+        if (r < 0)
+                return r;
+
+        sd_id128_to_string(boot_id, sid);
+        r = json_entry_add_field(&e, flags, "_BOOT_ID", STRLEN("_BOOT_ID"), sid, strlen(sid));
+        if (r < 0)
+                return r;
+
+        for (;;) {
+                const void *data;
+                size_t size, fieldlen;
+                const char *eq;
+
+                r = sd_journal_enumerate_data(j, &data, &size);
+                if (r == -EBADMSG) {
+                        log_debug_errno(r, "Skipping message we can't read: %m");
+                        return 0;
+                }
+                if (r < 0)
+                        return log_error_errno(r, "Failed to read journal: %m");
+                if (r == 0)
+                        break;
+
+                /* Same filtering as update_json_data_split() */
+                if (memory_startswith(data, size, "_BOOT_ID="))
+                        continue;
+
+                eq = memchr(data, '=', MIN(size, JSON_THRESHOLD));
+                if (!eq)
+                        continue;
+
+                fieldlen = eq - (const char*) data;
+                if (!journal_field_valid(data, fieldlen, true))
+                        return log_error_errno(SYNTHETIC_ERRNO(EINVAL), "Invalid field.");
+
+                if (output_fields && !set_contains(output_fields, strndupa(data, fieldlen)))
+                        continue;
+
+                r = json_entry_add_field(&e, flags, data, fieldlen, eq + 1, size - fieldlen - 1);
+                if (r < 0)
+                        return r;
+        }
+
+        r = json_entry_group_fields(&e);
+        if (r < 0)
+                return r;
+
+        json_entry_dump(&e, output_mode_to_json_format_flags(mode), f);
+        return 0;
+}
+
 static int output_json(
                 FILE *f,
                 sd_journal *j,
@@ -1019,6 +1352,9 @@ static int output_json(
         if (r < 0)
                 return log_error_errno(r, "Failed to get cursor: %m");
 
+        if (mode != OUTPUT_JSON_PRETTY && !FLAGS_SET(flags, OUTPUT_COLOR))
+                return output_json_direct(f, j, mode, flags, output_fields, cursor, realtime, monotonic, boot_id);
+
         h = hashmap_new(&string_hash_ops);
         if (!h)
                 return log_oom();
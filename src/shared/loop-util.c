@@ -171,11 +171,12 @@ static int loop_configure(
                         /* Do fallback only if LOOP_CONFIGURE is not supported, propagate all other
                          * errors. Note that the kernel is weird: non-existing ioctls currently return EINVAL
                          * rather than ENOTTY on loopback block devices. They should fix that in the kernel,
-                         * but in the meantime we accept both here. */
-                        if (!ERRNO_IS_NOT_SUPPORTED(errno) && errno != EINVAL)
+                         * but in the meantime we accept both here. Since EINVAL might as well be caused by
+                         * this specific configuration, only remember ENOTTY/EOPNOTSUPP for later calls. */
+                        if (ERRNO_IS_NOT_SUPPORTED(errno))
+                                *try_loop_configure = false;
+                        else if (errno != EINVAL)
                                 return -errno;
-
-                        *try_loop_configure = false;
                 } else {
                         bool good = true;
 
@@ -308,8 +309,11 @@ int loop_device_make(
                 uint32_t loop_flags,
                 LoopDevice **ret) {
 
+        /* Whether LOOP_CONFIGURE is supported and works doesn't change while we are running, hence remember
+         * it across calls. If it's missing or broken each attempt to use it costs us a loopback device and
+         * a retry. */
+        static bool try_loop_configure = true;
         _cleanup_free_ char *loopdev = NULL;
-        bool try_loop_configure = true;
         struct loop_config config;
         LoopDevice *d = NULL;
         struct stat st;
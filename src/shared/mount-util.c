@@ -237,8 +237,14 @@ int bind_remount_recursive_with_mountinfo(
                         opts = mnt_fs_get_vfs_options(fs);
                         if (opts) {
                                 r = mnt_optstr_get_flags(opts, &flags, mnt_get_builtin_optmap(MNT_LINUX_MAP));
-                                if (r < 0)
+                                if (r < 0) {
                                         log_debug_errno(r, "Could not get flags for '%s', ignoring: %m", path);
+
+                                        /* We don't know the current flags, make sure they are not mistaken
+                                         * as already matching below. This doesn't change what we'll apply,
+                                         * since all bits set here are masked out again. */
+                                        flags = ~new_flags & flags_mask;
+                                }
                         }
 
                         d = strdup(path);
@@ -246,8 +252,14 @@ int bind_remount_recursive_with_mountinfo(
                                 return -ENOMEM;
 
                         r = hashmap_ensure_put(&todo, &path_hash_ops_free, d, ULONG_TO_PTR(flags));
-                        if (r == -EEXIST)
+                        if (r == -EEXIST) {
+                                /* Mounts stacked on the same mount point are listed bottom to top, and
+                                 * only the top-most one is what we can remount, hence use its flags. */
+                                r = hashmap_update(todo, path, ULONG_TO_PTR(flags));
+                                if (r < 0)
+                                        return r;
                                 continue;
+                        }
                         if (r < 0)
                                 return r;
                         if (r > 0)
@@ -288,6 +300,14 @@ int bind_remount_recursive_with_mountinfo(
                         if (r < 0)
                                 return r;
 
+                        /* If the mount already carries the flags we want there's nothing to do. That's
+                         * commonly the case when sandboxing options apply the same flags to nested
+                         * subtrees, e.g. ProtectHome=read-only with ProtectSystem=strict. */
+                        if (((flags ^ new_flags) & flags_mask & ~MS_RELATIME) == 0) { /* ignore MS_RELATIME while comparing */
+                                log_debug("Mount '%s' already has the desired flags, not remounting.", x);
+                                continue;
+                        }
+
                         /* Now, remount this with the new flags set, but exclude MS_RELATIME from it. (It's
                          * the default anyway, thus redundant, and in userns we'll get an error if we try to
                          * explicitly enable it) */
@@ -147,28 +147,22 @@ bool net_match_config(
                 const char *ssid,
                 const struct ether_addr *bssid) {
 
-        _cleanup_free_ char *iftype_str = NULL;
-        const char *path = NULL;
-
         assert(match);
 
-        iftype_str = link_get_type_string(device, iftype);
+        /* This is called for every .network/.link file when a link appears, so check the cheap and most
+         * commonly used conditions first, and only look up device properties that are actually needed. */
 
-        if (device) {
-                const char *mac_str;
+        if (match->mac) {
+                if (!mac && device) {
+                        const char *mac_str;
 
-                (void) sd_device_get_property_value(device, "ID_PATH", &path);
-                if (!driver)
-                        (void) sd_device_get_property_value(device, "ID_NET_DRIVER", &driver);
-                if (!ifname)
-                        (void) sd_device_get_sysname(device, &ifname);
-                if (!mac &&
-                    sd_device_get_sysattr_value(device, "address", &mac_str) >= 0)
-                        mac = ether_aton(mac_str);
-        }
+                        if (sd_device_get_sysattr_value(device, "address", &mac_str) >= 0)
+                                mac = ether_aton(mac_str);
+                }
 
-        if (match->mac && (!mac || !set_contains(match->mac, mac)))
-                return false;
+                if (!mac || !set_contains(match->mac, mac))
+                        return false;
+        }
 
         if (match->permanent_mac &&
             (!permanent_mac ||
@@ -176,17 +170,40 @@ bool net_match_config(
              !set_contains(match->permanent_mac, permanent_mac)))
                 return false;
 
-        if (!net_condition_test_strv(match->path, path))
-                return false;
+        if (!strv_isempty(match->ifname)) {
+                if (!ifname && device)
+                        (void) sd_device_get_sysname(device, &ifname);
 
-        if (!net_condition_test_strv(match->driver, driver))
-                return false;
+                if (!net_condition_test_ifname(match->ifname, ifname, alternative_names))
+                        return false;
+        }
 
-        if (!net_condition_test_strv(match->iftype, iftype_str))
-                return false;
+        if (!strv_isempty(match->path)) {
+                const char *path = NULL;
 
-        if (!net_condition_test_ifname(match->ifname, ifname, alternative_names))
-                return false;
+                if (device)
+                        (void) sd_device_get_property_value(device, "ID_PATH", &path);
+
+                if (!net_condition_test_strv(match->path, path))
+                        return false;
+        }
+
+        if (!strv_isempty(match->driver)) {
+                if (!driver && device)
+                        (void) sd_device_get_property_value(device, "ID_NET_DRIVER", &driver);
+
+                if (!net_condition_test_strv(match->driver, driver))
+                        return false;
+        }
+
+        if (!strv_isempty(match->iftype)) {
+                _cleanup_free_ char *iftype_str = NULL;
+
+                iftype_str = link_get_type_string(device, iftype);
+
+                if (!net_condition_test_strv(match->iftype, iftype_str))
+                        return false;
+        }
 
         if (!net_condition_test_property(match->property, device))
                 return false;
@@ -1097,14 +1097,17 @@ int seccomp_load_syscall_filter_set_raw(uint32_t default_action, Hashmap* filter
                         if (r < 0) {
                                 /* If the system call is not known on this architecture, then that's
                                  * fine, let's ignore it */
-                                _cleanup_free_ char *n = NULL;
-                                bool ignore;
+                                bool ignore = r == -EDOM;
 
-                                n = seccomp_syscall_resolve_num_arch(SCMP_ARCH_NATIVE, id);
-                                ignore = r == -EDOM;
-                                if (!ignore || log_missing)
+                                if (!ignore || log_missing) {
+                                        _cleanup_free_ char *n = NULL;
+
+                                        /* Only resolve the name if we actually log it, this runs for
+                                         * every unknown system call on every architecture. */
+                                        n = seccomp_syscall_resolve_num_arch(SCMP_ARCH_NATIVE, id);
                                         log_debug_errno(r, "Failed to add rule for system call %s() / %d%s: %m",
                                                         strna(n), id, ignore ? ", ignoring" : "");
+                                }
                                 if (!ignore)
                                         return r;
                         }
@@ -131,6 +131,21 @@ int serialize_strv(FILE *f, const char *key, char **l) {
         return ret;
 }
 
+int deserialize_read_line(FILE *f, char **ret) {
+        int r;
+
+        assert(f);
+        assert(ret);
+
+        /* Serialization data always lives in a memfd or a temporary file, never on a TTY, hence spare
+         * read_line() from checking that for every single line. */
+        r = read_line_full(f, LONG_LINE_MAX, READ_LINE_NOT_A_TTY, ret);
+        if (r < 0)
+                return log_error_errno(r, "Failed to read serialization line: %m");
+
+        return r;
+}
+
 int deserialize_usec(const char *value, usec_t *ret) {
         int r;
 
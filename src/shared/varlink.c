@@ -508,25 +508,15 @@ static int varlink_read(Varlink *v) {
 
                 add = MIN(VARLINK_BUFFER_MAX - v->input_buffer_size, VARLINK_READ_SIZE);
 
-                if (v->input_buffer_index == 0) {
-
-                        if (!GREEDY_REALLOC(v->input_buffer, v->input_buffer_allocated, v->input_buffer_size + add))
-                                return -ENOMEM;
-
-                } else {
-                        char *b;
-
-                        b = new(char, v->input_buffer_size + add);
-                        if (!b)
-                                return -ENOMEM;
-
-                        memcpy(b, v->input_buffer + v->input_buffer_index, v->input_buffer_size);
-
-                        free_and_replace(v->input_buffer, b);
-
-                        v->input_buffer_allocated = v->input_buffer_size + add;
+                /* Move what is left of the previous messages to the front first, so that we can reuse
+                 * the buffer instead of reallocating it whenever a message straddles the end of it */
+                if (v->input_buffer_index > 0) {
+                        memmove(v->input_buffer, v->input_buffer + v->input_buffer_index, v->input_buffer_size);
                         v->input_buffer_index = 0;
                 }
+
+                if (!GREEDY_REALLOC(v->input_buffer, v->input_buffer_allocated, v->input_buffer_size + add))
+                        return -ENOMEM;
         }
 
         rs = v->input_buffer_allocated - (v->input_buffer_index + v->input_buffer_size);
@@ -1256,27 +1246,20 @@ static int varlink_enqueue_json(Varlink *v, JsonVariant *m) {
                 v->output_buffer_size = v->output_buffer_allocated = r + 1;
                 v->output_buffer_index = 0;
 
-        } else if (v->output_buffer_index == 0) {
-
-                if (!GREEDY_REALLOC(v->output_buffer, v->output_buffer_allocated, v->output_buffer_size + r + 1))
-                        return -ENOMEM;
-
-                memcpy(v->output_buffer + v->output_buffer_size, text, r + 1);
-                v->output_buffer_size += r + 1;
-
         } else {
-                char *n;
-                const size_t new_size = v->output_buffer_size + r + 1;
+                /* If a previous write only went out partially, move the rest to the front first, so that
+                 * we can keep appending to the same buffer instead of allocating a new one every time */
+                if (v->output_buffer_index > 0 &&
+                    v->output_buffer_index + v->output_buffer_size + r + 1 > v->output_buffer_allocated) {
+                        memmove(v->output_buffer, v->output_buffer + v->output_buffer_index, v->output_buffer_size);
+                        v->output_buffer_index = 0;
+                }
 
-                n = new(char, new_size);
-                if (!n)
+                if (!GREEDY_REALLOC(v->output_buffer, v->output_buffer_allocated, v->output_buffer_index + v->output_buffer_size + r + 1))
                         return -ENOMEM;
 
-                memcpy(mempcpy(n, v->output_buffer + v->output_buffer_index, v->output_buffer_size), text, r + 1);
-
-                free_and_replace(v->output_buffer, n);
-                v->output_buffer_allocated = v->output_buffer_size = new_size;
-                v->output_buffer_index = 0;
+                memcpy(v->output_buffer + v->output_buffer_index + v->output_buffer_size, text, r + 1);
+                v->output_buffer_size += r + 1;
         }
 
         return 0;
@@ -25,6 +25,7 @@
 #include "fd-util.h"
 #include "fs-util.h"
 #include "fstab-util.h"
+#include "hashmap.h"
 #include "libmount-util.h"
 #include "mount-setup.h"
 #include "mount-util.h"
@@ -56,9 +57,49 @@ void mount_points_list_free(MountPoint **head) {
                 mount_point_free(head, *head);
 }
 
+static bool fstype_lookup_cannot_hang(const char *fstype) {
+        /* autofs is listed as API file system, but accessing it might trigger an automount */
+        return fstype && fstype_is_api_vfs(fstype) && !streq(fstype, "autofs");
+}
+
+static bool mount_point_can_umount_directly(Hashmap *mounts_by_id, struct libmnt_fs *fs) {
+        const char *fstype;
+
+        assert(fs);
+
+        /* API file systems have no backing store to flush, hence unmounting them doesn't hang by itself.
+         * However, umount2() still has to look up the path, and that might block in a dead network or FUSE
+         * file system further up. Hence skip the timeout only if all mounts the path is below are API file
+         * systems too, except for the topmost one, which may also be a local file system. */
+
+        if (!fstype_lookup_cannot_hang(mnt_fs_get_fstype(fs)))
+                return false;
+
+        for (unsigned n = 0;; n++) {
+                struct libmnt_fs *parent = NULL;
+
+                fstype = mnt_fs_get_fstype(fs);
+
+                if (mnt_fs_get_parent_id(fs) != mnt_fs_get_id(fs))
+                        parent = hashmap_get(mounts_by_id, INT_TO_PTR(mnt_fs_get_parent_id(fs)));
+                if (!parent)
+                        return fstype_lookup_cannot_hang(fstype) ||
+                                (fstype && fstype_is_blockdev_backed(fstype) && !startswith(fstype, "fuse"));
+
+                if (!fstype_lookup_cannot_hang(fstype))
+                        return false;
+
+                if (n >= hashmap_size(mounts_by_id)) /* Refuse loops in the parent chain */
+                        return false;
+
+                fs = parent;
+        }
+}
+
 int mount_points_list_get(const char *mountinfo, MountPoint **head) {
         _cleanup_(mnt_free_tablep) struct libmnt_table *table = NULL;
         _cleanup_(mnt_free_iterp) struct libmnt_iter *iter = NULL;
+        _cleanup_hashmap_free_ Hashmap *mounts_by_id = NULL;
         int r;
 
         assert(head);
@@ -67,6 +108,24 @@ int mount_points_list_get(const char *mountinfo, MountPoint **head) {
         if (r < 0)
                 return log_error_errno(r, "Failed to parse %s: %m", mountinfo ?: "/proc/self/mountinfo");
 
+        /* Index all mounts by their ID first, so that we can follow the parent chain of each mount point,
+         * see mount_point_can_umount_directly(). */
+        for (;;) {
+                struct libmnt_fs *fs;
+
+                r = mnt_table_next_fs(table, iter, &fs);
+                if (r == 1)
+                        break;
+                if (r < 0)
+                        return log_error_errno(r, "Failed to get next entry from %s: %m", mountinfo ?: "/proc/self/mountinfo");
+
+                r = hashmap_ensure_put(&mounts_by_id, NULL, INT_TO_PTR(mnt_fs_get_id(fs)), fs);
+                if (r == -ENOMEM)
+                        return log_oom();
+        }
+
+        mnt_reset_iter(iter, MNT_ITER_FORWARD);
+
         for (;;) {
                 struct libmnt_fs *fs;
                 const char *path, *fstype;
@@ -164,6 +223,8 @@ int mount_points_list_get(const char *mountinfo, MountPoint **head) {
                 m->remount_flags = remount_flags;
                 m->try_remount_ro = try_remount_ro;
 
+                m->umount_directly = mount_point_can_umount_directly(mounts_by_id, fs);
+
                 LIST_PREPEND(mount_point, *head, TAKE_PTR(m));
         }
 
@@ -546,6 +607,18 @@ static int umount_with_timeout(MountPoint *m, int umount_log_level) {
 
         assert(m);
 
+        /* Forking for every mount adds up to a lot of time on systems with thousands of them, hence skip
+         * that for API file systems that are only below other API file systems, see
+         * mount_point_can_umount_directly(). See below regarding MNT_FORCE. */
+        if (m->umount_directly) {
+                log_info("Unmounting '%s'.", m->path);
+
+                if (umount2(m->path, MNT_FORCE) < 0)
+                        return log_full_errno(umount_log_level, errno, "Failed to unmount %s: %m", m->path);
+
+                return 0;
+        }
+
         /* Due to the possibility of a umount operation hanging, we fork a child process and set a
          * timeout. If the timeout lapses, the assumption is that the particular umount failed. */
         r = safe_fork("(sd-umount)", FORK_RESET_SIGNALS|FORK_CLOSE_ALL_FDS|FORK_LOG|FORK_REOPEN_LOG, &pid);
@@ -29,6 +29,9 @@
 
 #define BUFFER_SIZE (256 * 1024)
 
+/* How many drained pipes to keep around for reuse by later connections */
+#define PIPE_POOL_MAX 16
+
 static unsigned arg_connections_max = 256;
 static const char *arg_remote_host = NULL;
 static usec_t arg_exit_idle_time = USEC_INFINITY;
@@ -40,6 +43,10 @@ typedef struct Context {
 
         Set *listen;
         Set *connections;
+
+        int pipe_pool[PIPE_POOL_MAX][2];
+        size_t pipe_pool_size[PIPE_POOL_MAX];
+        size_t n_pipe_pool;
 } Context;
 
 typedef struct Connection {
@@ -57,6 +64,22 @@ typedef struct Connection {
         sd_resolve_query *resolve_query;
 } Connection;
 
+static void context_release_pipe(Context *context, int buffer[static 2], size_t full, size_t sz) {
+        assert(buffer);
+
+        /* Pipes that have been drained completely may be reused as is, which saves us allocating a new
+         * pipe and resizing it for every connection. */
+        if (context && buffer[0] >= 0 && full == 0 && context->n_pipe_pool < PIPE_POOL_MAX) {
+                context->pipe_pool[context->n_pipe_pool][0] = TAKE_FD(buffer[0]);
+                context->pipe_pool[context->n_pipe_pool][1] = TAKE_FD(buffer[1]);
+                context->pipe_pool_size[context->n_pipe_pool] = sz;
+                context->n_pipe_pool++;
+                return;
+        }
+
+        safe_close_pair(buffer);
+}
+
 static void connection_free(Connection *c) {
         assert(c);
 
@@ -69,8 +92,8 @@ static void connection_free(Connection *c) {
         safe_close(c->server_fd);
         safe_close(c->client_fd);
 
-        safe_close_pair(c->server_to_client_buffer);
-        safe_close_pair(c->client_to_server_buffer);
+        context_release_pipe(c->context, c->server_to_client_buffer, c->server_to_client_buffer_full, c->server_to_client_buffer_size);
+        context_release_pipe(c->context, c->client_to_server_buffer, c->client_to_server_buffer_full, c->client_to_server_buffer_size);
 
         sd_resolve_query_unref(c->resolve_query);
 
@@ -127,6 +150,9 @@ static void context_clear(Context *context) {
         set_free_with_destructor(context->listen, sd_event_source_unref);
         set_free_with_destructor(context->connections, connection_free);
 
+        for (size_t i = 0; i < context->n_pipe_pool; i++)
+                safe_close_pair(context->pipe_pool[i]);
+
         sd_event_unref(context->event);
         sd_resolve_unref(context->resolve);
         sd_event_source_unref(context->idle_time);
@@ -142,6 +168,15 @@ static int connection_create_pipes(Connection *c, int buffer[static 2], size_t *
         if (buffer[0] >= 0)
                 return 0;
 
+        if (c->context->n_pipe_pool > 0) {
+                size_t i = --c->context->n_pipe_pool;
+
+                buffer[0] = c->context->pipe_pool[i][0];
+                buffer[1] = c->context->pipe_pool[i][1];
+                *sz = c->context->pipe_pool_size[i];
+                return 0;
+        }
+
         r = pipe2(buffer, O_CLOEXEC|O_NONBLOCK);
         if (r < 0)
                 return log_error_errno(errno, "Failed to allocate pipe buffer: %m");
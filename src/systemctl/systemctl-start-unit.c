@@ -11,10 +11,12 @@
 #include "macro.h"
 #include "special.h"
 #include "string-util.h"
+#include "strv.h"
 #include "systemctl-start-unit.h"
 #include "systemctl-util.h"
 #include "systemctl.h"
 #include "terminal-util.h"
+#include "unit-def.h"
 
 static const struct {
         const char *verb;      /* systemctl verb */
@@ -51,6 +53,52 @@ static const char *verb_to_job_type(const char *verb) {
        return "start";
 }
 
+static int start_unit_watch(
+                const char *name,
+                const char *path,
+                BusWaitForJobs *w,
+                BusWaitForUnits *wu) {
+
+        int r;
+
+        assert(name);
+        assert(path);
+
+        if (w) {
+                log_debug("Adding %s to the set", path);
+                r = bus_wait_for_jobs_add(w, path);
+                if (r < 0)
+                        return log_error_errno(r, "Failed to watch job for %s: %m", name);
+        }
+
+        if (wu) {
+                r = bus_wait_for_units_add_unit(wu, name, BUS_WAIT_FOR_INACTIVE|BUS_WAIT_NO_JOB, NULL, NULL);
+                if (r < 0)
+                        return log_error_errno(r, "Failed to watch unit %s: %m", name);
+        }
+
+        return 0;
+}
+
+static int log_start_unit_error(const char *job_type, const char *name, const sd_bus_error *error, int r) {
+        assert(job_type);
+        assert(name);
+        assert(error);
+
+        log_error_errno(r, "Failed to %s %s: %s", job_type, name, bus_error_message(error, r));
+
+        if (!sd_bus_error_has_names(error, BUS_ERROR_NO_SUCH_UNIT,
+                                           BUS_ERROR_UNIT_MASKED,
+                                           BUS_ERROR_JOB_TYPE_NOT_APPLICABLE))
+                log_error("See %s logs and 'systemctl%s status%s %s' for details.",
+                          arg_scope == UNIT_FILE_SYSTEM ? "system" : "user",
+                          arg_scope == UNIT_FILE_SYSTEM ? "" : " --user",
+                          name[0] == '-' ? " --" : "",
+                          name);
+
+        return r;
+}
+
 static int start_unit_one(
                 sd_bus *bus,
                 const char *method,    /* When using classic per-job bus methods */
@@ -142,38 +190,215 @@ static int start_unit_one(
         if (need_daemon_reload(bus, name) > 0)
                 warn_unit_file_changed(name);
 
-        if (w) {
-                log_debug("Adding %s to the set", path);
-                r = bus_wait_for_jobs_add(w, path);
-                if (r < 0)
-                        return log_error_errno(r, "Failed to watch job for %s: %m", name);
+        return start_unit_watch(name, path, w, wu);
+
+fail:
+        /* There's always a fallback possible for legacy actions. */
+        if (arg_action != ACTION_SYSTEMCTL)
+                return r;
+
+        return log_start_unit_error(job_type, name, error, r);
+}
+
+typedef struct StartUnitCall {
+        const char *name;
+        const char *job_type;
+        BusWaitForJobs *w;
+        BusWaitForUnits *wu;
+        size_t *n_pending;
+
+        sd_bus_slot *slot;
+        sd_bus_slot *reload_slot;
+        sd_bus_error error;
+        int r;
+} StartUnitCall;
+
+static void start_unit_calls_free(StartUnitCall *calls, size_t n) {
+        for (size_t i = 0; i < n; i++) {
+                sd_bus_slot_unref(calls[i].slot);
+                sd_bus_slot_unref(calls[i].reload_slot);
+                sd_bus_error_free(&calls[i].error);
         }
 
-        if (wu) {
-                r = bus_wait_for_units_add_unit(wu, name, BUS_WAIT_FOR_INACTIVE|BUS_WAIT_NO_JOB, NULL, NULL);
-                if (r < 0)
-                        return log_error_errno(r, "Failed to watch unit %s: %m", name);
+        free(calls);
+}
+
+static int need_daemon_reload_reply(sd_bus_message *m, void *userdata, sd_bus_error *ret_error) {
+        StartUnitCall *c = userdata;
+        int b;
+
+        assert(m);
+        assert(c);
+
+        (*c->n_pending)--;
+
+        /* Like need_daemon_reload(), ignore all errors, this is used to show a warning only */
+        if (sd_bus_message_read(m, "v", "b", &b) > 0 && b)
+                warn_unit_file_changed(c->name);
+
+        return 0;
+}
+
+static int get_unit_reply(sd_bus_message *m, void *userdata, sd_bus_error *ret_error) {
+        StartUnitCall *c = userdata;
+        const char *path;
+        int r;
+
+        assert(m);
+        assert(c);
+
+        (*c->n_pending)--;
+
+        /* The unit might be gone already, e.g. if it was stopped. Like need_daemon_reload(), we don't load
+         * it again just to check whether it is outdated. */
+        if (sd_bus_message_read(m, "o", &path) <= 0)
+                return 0;
+
+        c->reload_slot = sd_bus_slot_unref(c->reload_slot);
+
+        r = sd_bus_call_method_async(
+                        sd_bus_message_get_bus(m),
+                        &c->reload_slot,
+                        "org.freedesktop.systemd1",
+                        path,
+                        "org.freedesktop.DBus.Properties",
+                        "Get",
+                        need_daemon_reload_reply,
+                        c,
+                        "ss",
+                        "org.freedesktop.systemd1.Unit",
+                        "NeedDaemonReload");
+        if (r >= 0)
+                (*c->n_pending)++;
+
+        return 0;
+}
+
+static int start_unit_reply(sd_bus_message *m, void *userdata, sd_bus_error *ret_error) {
+        StartUnitCall *c = userdata;
+        const char *path;
+        int r;
+
+        assert(m);
+        assert(c);
+
+        (*c->n_pending)--;
+
+        if (sd_bus_message_is_method_error(m, NULL)) {
+                c->r = sd_bus_error_copy(&c->error, sd_bus_message_get_error(m));
+                (void) log_start_unit_error(c->job_type, c->name, &c->error, c->r);
+                return 0;
         }
 
+        r = sd_bus_message_read(m, "o", &path);
+        if (r < 0) {
+                c->r = bus_log_parse_error(r);
+                return 0;
+        }
+
+        c->r = start_unit_watch(c->name, path, c->w, c->wu);
+        if (c->r < 0)
+                return 0;
+
+        r = bus_call_method_async(sd_bus_message_get_bus(m), &c->reload_slot, bus_systemd_mgr, "GetUnit", get_unit_reply, c, "s", c->name);
+        if (r >= 0)
+                (*c->n_pending)++;
+
         return 0;
+}
 
-fail:
-        /* There's always a fallback possible for legacy actions. */
-        if (arg_action != ACTION_SYSTEMCTL)
-                return r;
+/* dbus-daemon limits the number of replies a connection may be waiting for (max_replies_per_connection is
+ * 128 on the system bus by default), hence don't have more method calls than this in flight at a time. */
+#define START_UNITS_IN_FLIGHT_MAX 32U
 
-        log_error_errno(r, "Failed to %s %s: %s", job_type, name, bus_error_message(error, r));
+static int start_units_pipelined(
+                sd_bus *bus,
+                const char *method,
+                const char *job_type,
+                char **names,
+                const char *mode,
+                BusWaitForJobs *w,
+                BusWaitForUnits *wu,
+                char ***stopped_units) {
 
-        if (!sd_bus_error_has_names(error, BUS_ERROR_NO_SUCH_UNIT,
-                                           BUS_ERROR_UNIT_MASKED,
-                                           BUS_ERROR_JOB_TYPE_NOT_APPLICABLE))
-                log_error("See %s logs and 'systemctl%s status%s %s' for details.",
-                          arg_scope == UNIT_FILE_SYSTEM ? "system" : "user",
-                          arg_scope == UNIT_FILE_SYSTEM ? "" : " --user",
-                          name[0] == '-' ? " --" : "",
-                          name);
+        StartUnitCall *calls;
+        size_t n, n_sent = 0, n_pending = 0;
+        int r, ret = EXIT_SUCCESS;
 
-        return r;
+        assert(bus);
+        assert(method);
+        assert(job_type);
+        assert(mode);
+        assert(stopped_units);
+
+        /* Enqueues the jobs for all units without waiting for each reply before sending the next method
+         * call, so that starting thousands of units doesn't take thousands of round trips. At most
+         * START_UNITS_IN_FLIGHT_MAX calls are outstanding at any time, more are sent as replies come in.
+         * The replies are processed in order, JobRemoved signals dispatched in the meantime are collected
+         * by the BusWaitForJobs object. */
+
+        n = strv_length(names);
+        calls = new(StartUnitCall, n);
+        if (!calls)
+                return log_oom();
+
+        for (size_t i = 0; i < n; i++)
+                calls[i] = (StartUnitCall) {
+                        .name = names[i],
+                        .job_type = job_type,
+                        .w = w,
+                        .wu = wu,
+                        .n_pending = &n_pending,
+                        .error = SD_BUS_ERROR_NULL,
+                };
+
+        while (n_sent < n || n_pending > 0) {
+                while (n_sent < n && n_pending < START_UNITS_IN_FLIGHT_MAX) {
+                        StartUnitCall *c = calls + n_sent;
+
+                        log_debug("Executing dbus call org.freedesktop.systemd1.Manager %s(%s, %s)", method, c->name, mode);
+
+                        r = bus_call_method_async(bus, &c->slot, bus_systemd_mgr, method, start_unit_reply, c, "ss", c->name, mode);
+                        if (r < 0) {
+                                ret = log_error_errno(r, "Failed to issue %s() call for %s: %m", method, c->name);
+                                goto finish;
+                        }
+
+                        n_sent++;
+                        n_pending++;
+                }
+
+                r = sd_bus_process(bus, NULL);
+                if (r < 0) {
+                        ret = log_error_errno(r, "Failed to process bus: %m");
+                        goto finish;
+                }
+                if (r > 0)
+                        continue;
+
+                r = sd_bus_wait(bus, UINT64_MAX);
+                if (r < 0) {
+                        ret = log_error_errno(r, "Failed to wait for bus: %m");
+                        goto finish;
+                }
+        }
+
+        for (size_t i = 0; i < n; i++) {
+                if (ret == EXIT_SUCCESS && calls[i].r < 0)
+                        ret = translate_bus_error_to_exit_status(calls[i].r, &calls[i].error);
+
+                if (calls[i].r >= 0 && streq(method, "StopUnit")) {
+                        r = strv_push(stopped_units, names[i]);
+                        if (r < 0) {
+                                ret = log_oom();
+                                goto finish;
+                        }
+                }
+        }
+
+finish:
+        start_unit_calls_free(calls, n);
+        return ret;
 }
 
 static int enqueue_marked_jobs(
@@ -362,7 +587,27 @@ int start_unit(int argc, char *argv[], void *userdata) {
         if (arg_marked)
                 ret = enqueue_marked_jobs(bus, w);
 
-        else
+        else if (arg_action == ACTION_SYSTEMCTL && !arg_show_transaction && !arg_dry_run && strv_length(names) > 1) {
+                _cleanup_(sd_bus_error_free) sd_bus_error error = SD_BUS_ERROR_NULL;
+
+                /* Enqueue the first job synchronously, so that an interactive polkit authentication (if one is
+                 * needed) happens once, before the others are sent off in one go. */
+                r = start_unit_one(bus, method, job_type, names[0], mode, &error, w, wu);
+                if (r < 0)
+                        ret = translate_bus_error_to_exit_status(r, &error);
+                else if (streq(method, "StopUnit")) {
+                        r = strv_push(&stopped_units, names[0]);
+                        if (r < 0)
+                                return log_oom();
+                }
+
+                r = start_units_pipelined(bus, method, job_type, names + 1, mode, w, wu, &stopped_units);
+                if (r < 0)
+                        return r;
+                if (ret == EXIT_SUCCESS)
+                        ret = r;
+
+        } else
                 STRV_FOREACH(name, names) {
                         _cleanup_(sd_bus_error_free) sd_bus_error error = SD_BUS_ERROR_NULL;
 
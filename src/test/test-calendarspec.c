@@ -114,6 +114,45 @@ static void test_hourly_bug_4031(void) {
         calendar_spec_free(c);
 }
 
+static void test_local_timezone(void) {
+        _cleanup_free_ char *tz = NULL, *t = NULL;
+        CalendarSpec *a, *b;
+        usec_t n, u, w;
+        char *old_tz;
+
+        /* A spec with the local timezone spelled out must elapse at the same time as one without */
+
+        old_tz = getenv("TZ");
+        if (old_tz)
+                old_tz = strdupa(old_tz);
+
+        assert_se(set_unset_env("TZ", NULL, true) == 0);
+        tzset();
+
+        if (get_timezone(&tz) < 0) {
+                log_info("Couldn't determine local timezone, skipping test.");
+                goto finish;
+        }
+
+        t = strjoin("*-*-* 01:30:00 ", tz);
+        assert_se(t);
+
+        assert_se(calendar_spec_from_string("*-*-* 01:30:00", &a) >= 0);
+        assert_se(calendar_spec_from_string(t, &b) >= 0);
+
+        n = now(CLOCK_REALTIME);
+        assert_se(calendar_spec_next_usec(a, n, &u) >= 0);
+        assert_se(calendar_spec_next_usec(b, n, &w) >= 0);
+        assert_se(u == w);
+
+        calendar_spec_free(a);
+        calendar_spec_free(b);
+
+finish:
+        assert_se(set_unset_env("TZ", old_tz, true) == 0);
+        tzset();
+}
+
 int main(int argc, char* argv[]) {
         CalendarSpec *c;
 
@@ -246,6 +285,7 @@ int main(int argc, char* argv[]) {
 
         test_timestamp();
         test_hourly_bug_4031();
+        test_local_timezone();
 
         return 0;
 }
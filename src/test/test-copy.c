@@ -9,10 +9,12 @@
 #include "fileio.h"
 #include "fs-util.h"
 #include "hexdecoct.h"
+#include "io-util.h"
 #include "log.h"
 #include "macro.h"
 #include "mkdir.h"
 #include "path-util.h"
+#include "process-util.h"
 #include "rm-rf.h"
 #include "string-util.h"
 #include "strv.h"
@@ -320,6 +322,93 @@ static void test_copy_proc(void) {
         assert_se(!isempty(a));
 }
 
+static void test_copy_holes(void) {
+        char fn[] = "/tmp/test-copy-holes-XXXXXX";
+        _cleanup_close_pair_ int pipefd[2] = { -1, -1 };
+        _cleanup_close_ int fd = -1;
+        _cleanup_free_ char *buf = NULL, *check = NULL;
+        size_t sz = 64U * 1024U;
+        struct stat st;
+        pid_t pid;
+        int r;
+
+        log_info("%s", __func__);
+
+        /* Data, then a run of NUL bytes, then data again, then trailing NUL bytes */
+        assert_se(buf = new0(char, sz));
+        memset(buf, 'x', 1000);
+        memset(buf + 40000, 'y', 1000);
+
+        assert_se(pipe2(pipefd, O_CLOEXEC) == 0);
+
+        r = safe_fork("(sd-copy-holes)", FORK_DEATHSIG|FORK_LOG, &pid);
+        assert_se(r >= 0);
+        if (r == 0) {
+                pipefd[0] = safe_close(pipefd[0]);
+                assert_se(loop_write(pipefd[1], buf, sz, false) >= 0);
+                _exit(EXIT_SUCCESS);
+        }
+
+        pipefd[1] = safe_close(pipefd[1]);
+
+        fd = mkostemp_safe(fn);
+        assert_se(fd >= 0);
+
+        assert_se(copy_bytes(pipefd[0], fd, UINT64_MAX, COPY_HOLES) == 0);
+        assert_se(wait_for_terminate_and_check("(sd-copy-holes)", pid, WAIT_LOG) == EXIT_SUCCESS);
+
+        assert_se(fstat(fd, &st) >= 0);
+        assert_se((size_t) st.st_size == sz);
+
+        /* The runs of NUL bytes must have become holes */
+        assert_se(st.st_blocks * 512 < st.st_size);
+
+        assert_se(check = malloc(sz));
+        assert_se(pread(fd, check, sz, 0) == (ssize_t) sz);
+        assert_se(memcmp(buf, check, sz) == 0);
+
+        unlink(fn);
+}
+
+static void test_copy_holes_regular_file(uint64_t max_bytes) {
+        char fn[] = "/tmp/test-copy-holes-XXXXXX";
+        char fn2[] = "/tmp/test-copy-holes-XXXXXX";
+        _cleanup_close_ int fd = -1, fd2 = -1;
+        _cleanup_free_ char *a = NULL, *b = NULL;
+        size_t sz = 4U * 1024U * 1024U, expected;
+        struct stat st;
+        int r;
+
+        log_info("%s max_bytes=%" PRIu64, __func__, max_bytes);
+
+        fd = mkostemp_safe(fn);
+        assert_se(fd >= 0);
+
+        fd2 = mkostemp_safe(fn2);
+        assert_se(fd2 >= 0);
+
+        /* A hole, data, a hole, data and a trailing hole */
+        assert_se(ftruncate(fd, sz) >= 0);
+        assert_se(pwrite(fd, "foo", 3, 1024U * 1024U) == 3);
+        assert_se(pwrite(fd, "bar", 3, 2U * 1024U * 1024U) == 3);
+
+        r = copy_bytes(fd, fd2, max_bytes, COPY_HOLES);
+        assert_se(r == (max_bytes < sz));
+
+        expected = MIN(sz, max_bytes);
+        assert_se(fstat(fd2, &st) >= 0);
+        assert_se((size_t) st.st_size == expected);
+
+        assert_se(a = malloc(expected));
+        assert_se(b = malloc(expected));
+        assert_se(pread(fd, a, expected, 0) == (ssize_t) expected);
+        assert_se(pread(fd2, b, expected, 0) == (ssize_t) expected);
+        assert_se(memcmp(a, b, expected) == 0);
+
+        unlink(fn);
+        unlink(fn2);
+}
+
 int main(int argc, char *argv[]) {
         test_setup_logging(LOG_DEBUG);
 
@@ -333,6 +422,10 @@ int main(int argc, char *argv[]) {
         test_copy_bytes_regular_file(argv[0], true, 1000);
         test_copy_bytes_regular_file(argv[0], false, 32000); /* larger than copy buffer size */
         test_copy_bytes_regular_file(argv[0], true, 32000);
+        test_copy_holes();
+        test_copy_holes_regular_file(UINT64_MAX);
+        test_copy_holes_regular_file(1024U * 1024U + 1U); /* ends within a data segment */
+        test_copy_holes_regular_file(512U * 1024U); /* ends within a hole */
         test_copy_atomic();
         test_copy_proc();
 
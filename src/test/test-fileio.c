@@ -15,6 +15,7 @@
 #include "fs-util.h"
 #include "io-util.h"
 #include "parse-util.h"
+#include "path-util.h"
 #include "process-util.h"
 #include "random-util.h"
 #include "rm-rf.h"
@@ -983,6 +984,42 @@ static void test_read_full_virtual_file(void) {
         }
 }
 
+static void test_write_data_file_atomic_if_changed(void) {
+        _cleanup_(rm_rf_physical_and_freep) char *t = NULL;
+        _cleanup_free_ char *fn = NULL, *buf = NULL;
+        struct stat st1, st2;
+        size_t size;
+
+        log_info("/* %s */", __func__);
+
+        assert_se(mkdtemp_malloc(NULL, &t) >= 0);
+        assert_se(fn = path_join(t, "state"));
+
+        assert_se(write_data_file_atomic_if_changed(fn, "foo\n", 4, 0644) == 1);
+        assert_se(stat(fn, &st1) >= 0);
+        assert_se((st1.st_mode & 07777) == 0644);
+
+        /* Same contents, the file must not be replaced */
+        assert_se(write_data_file_atomic_if_changed(fn, "foo\n", 4, 0644) == 0);
+        assert_se(stat(fn, &st2) >= 0);
+        assert_se(st1.st_ino == st2.st_ino);
+
+        assert_se(write_data_file_atomic_if_changed(fn, "foo\nbar\n", 8, 0644) == 1);
+        assert_se(stat(fn, &st2) >= 0);
+        assert_se(st1.st_ino != st2.st_ino);
+
+        assert_se(read_full_file(fn, &buf, &size) >= 0);
+        assert_se(size == 8);
+        assert_se(memcmp(buf, "foo\nbar\n", 8) == 0);
+        buf = mfree(buf);
+
+        assert_se(write_data_file_atomic_if_changed(fn, NULL, 0, 0644) == 1);
+        assert_se(read_full_file(fn, &buf, &size) >= 0);
+        assert_se(size == 0);
+
+        assert_se(write_data_file_atomic_if_changed(fn, NULL, 0, 0644) == 0);
+}
+
 int main(int argc, char *argv[]) {
         test_setup_logging(LOG_DEBUG);
 
@@ -1011,6 +1048,7 @@ int main(int argc, char *argv[]) {
         test_read_full_file_socket();
         test_read_full_file_offset_size();
         test_read_full_virtual_file();
+        test_write_data_file_atomic_if_changed();
 
         return 0;
 }
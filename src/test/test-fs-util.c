@@ -29,7 +29,7 @@ static void test_chase_symlinks(void) {
         _cleanup_free_ char *result = NULL;
         char *temp;
         const char *top, *p, *pslash, *q, *qslash;
-        struct stat st;
+        struct stat st, st2;
         int r, pfd;
 
         log_info("/* %s */", __func__);
@@ -332,6 +332,28 @@ static void test_chase_symlinks(void) {
         assert_se(S_ISLNK(st.st_mode));
         result = mfree(result);
 
+        /* Test ret_fd with a root directory */
+
+        p = strjoina(temp, "/start");
+        r = chase_symlinks(p, temp, 0, NULL, &pfd);
+        assert_se(r >= 0);
+        assert_se(pfd >= 0);
+        assert_se(fstat(pfd, &st) >= 0);
+        assert_se(stat(strjoina(temp, "/usr"), &st2) >= 0);
+        assert_se(st.st_dev == st2.st_dev && st.st_ino == st2.st_ino);
+        pfd = safe_close(pfd);
+
+        q = strjoina(temp, "/symlink");
+        r = chase_symlinks(q, temp, CHASE_NOFOLLOW, NULL, &pfd);
+        assert_se(r >= 0);
+        assert_se(pfd >= 0);
+        assert_se(fstat(pfd, &st) >= 0);
+        assert_se(S_ISLNK(st.st_mode));
+        pfd = safe_close(pfd);
+
+        q = strjoina(temp, "/s1");
+        assert_se(chase_symlinks(q, temp, 0, NULL, &pfd) == -ENOENT);
+
         /* Test CHASE_ONE */
 
         p = strjoina(temp, "/start");
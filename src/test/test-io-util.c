@@ -31,6 +31,7 @@ static void test_sparse_write(void) {
         const char test_c[] = "\0\0test\0\0\0\0";
         const char test_d[] = "\0\0test\0\0\0test\0\0\0\0test\0\0\0\0\0test\0\0\0test\0\0\0\0test\0\0\0\0\0\0\0\0";
         const char test_e[] = "test\0\0\0\0test";
+        const char test_f[] = "t\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0test\0\0\0tes\0\0\0\0\0\0\0\0\0\0\0t";
         _cleanup_close_ int fd = -1;
         char fn[] = "/tmp/sparseXXXXXX";
 
@@ -43,6 +44,7 @@ static void test_sparse_write(void) {
         test_sparse_write_one(fd, test_c, sizeof(test_c));
         test_sparse_write_one(fd, test_d, sizeof(test_d));
         test_sparse_write_one(fd, test_e, sizeof(test_e));
+        test_sparse_write_one(fd, test_f, sizeof(test_f));
 }
 
 int main(void) {
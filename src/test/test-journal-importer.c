@@ -3,6 +3,7 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <fcntl.h>
+#include <unistd.h>
 
 #include "alloc-util.h"
 #include "log.h"
@@ -68,11 +69,56 @@ static void test_bad_input(void) {
         assert_se(journal_importer_eof(&imp));
 }
 
+static void test_multiple_entries(void) {
+        _cleanup_(journal_importer_cleanup) JournalImporter imp = JOURNAL_IMPORTER_INIT(-1);
+        static const char data[] =
+                "MESSAGE=first\n"
+                "PRIORITY=6\n"
+                "_TRANSPORT=journal\n"
+                "\n"
+                "MESSAGE=second\n"
+                "\n";
+        int r;
+
+        /* Check that the fields of an entry don't linger around after it was dropped */
+
+        imp.fd = STDIN_FILENO;
+        imp.passive_fd = true;
+        assert_se(journal_importer_push_data(&imp, data, strlen(data)) >= 0);
+
+        do
+                r = journal_importer_process_data(&imp);
+        while (r == 0);
+        assert_se(r == 1);
+
+        assert_se(imp.iovw.count == 3);
+        assert_iovec_entry(&imp.iovw.iovec[0], "MESSAGE=first");
+        assert_iovec_entry(&imp.iovw.iovec[1], "PRIORITY=6");
+        assert_iovec_entry(&imp.iovw.iovec[2], "_TRANSPORT=journal");
+
+        journal_importer_drop_iovw(&imp);
+        assert_se(imp.iovw.count == 0);
+
+        do
+                r = journal_importer_process_data(&imp);
+        while (r == 0);
+        assert_se(r == 1);
+
+        assert_se(imp.iovw.count == 1);
+        assert_iovec_entry(&imp.iovw.iovec[0], "MESSAGE=second");
+
+        journal_importer_drop_iovw(&imp);
+
+        /* No more data */
+        assert_se(journal_importer_process_data(&imp) == -EAGAIN);
+}
+
 int main(int argc, char **argv) {
         test_setup_logging(LOG_DEBUG);
 
         test_basic_parsing();
         test_bad_input();
+        test_multiple_entries();
 
         return 0;
 }
@@ -8,6 +8,7 @@
 #include "fileio.h"
 #include "json-internal.h"
 #include "json.h"
+#include "stdio-util.h"
 #include "string-util.h"
 #include "strv.h"
 #include "tests.h"
@@ -521,6 +522,95 @@ static void test_bisect(void) {
         }
 }
 
+static int dispatch_other(const char *name, JsonVariant *variant, JsonDispatchFlags flags, void *userdata) {
+        unsigned *n = userdata;
+
+        assert_se(streq(name, "other"));
+        (*n)++;
+
+        return 0;
+}
+
+static void test_dispatch_large(void) {
+        static const char *const names[] = {
+                "f0", "f1", "f2", "f3", "f4", "f5", "f6", "f7", "f8", "f9",
+                "f10", "f11", "f12", "f13", "f14", "f15", "f16", "f17", "f18", "f19",
+        };
+        _cleanup_(json_variant_unrefp) JsonVariant *v = NULL;
+        JsonDispatch table[ELEMENTSOF(names) + 3] = {};
+        struct {
+                uint64_t f[ELEMENTSOF(names)];
+                unsigned n_other;
+        } data = {};
+
+        log_info("/* %s */", __func__);
+
+        /* Large enough to be looked up via a hash table, with a duplicate name and a catch-all entry */
+        for (size_t i = 0; i < ELEMENTSOF(names); i++)
+                table[i] = (JsonDispatch) { names[i], JSON_VARIANT_UNSIGNED, json_dispatch_uint64, offsetof(typeof(data), f) + i * sizeof(uint64_t), 0 };
+        table[ELEMENTSOF(names)] = (JsonDispatch) { "f3", JSON_VARIANT_UNSIGNED, json_dispatch_uint64, offsetof(typeof(data), f), 0 };
+        table[ELEMENTSOF(names) + 1] = (JsonDispatch) { POINTER_MAX, _JSON_VARIANT_TYPE_INVALID, dispatch_other, offsetof(typeof(data), n_other), 0 };
+
+        assert_se(json_build(&v, JSON_BUILD_OBJECT(
+                                             JSON_BUILD_PAIR("f17", JSON_BUILD_UNSIGNED(17)),
+                                             JSON_BUILD_PAIR("other", JSON_BUILD_UNSIGNED(1)),
+                                             JSON_BUILD_PAIR("f3", JSON_BUILD_UNSIGNED(3)),
+                                             JSON_BUILD_PAIR("f0", JSON_BUILD_UNSIGNED(10)))) >= 0);
+
+        assert_se(json_dispatch(v, table, NULL, 0, &data) == 4);
+        assert_se(data.f[0] == 10);
+        assert_se(data.f[3] == 3);
+        assert_se(data.f[17] == 17);
+        assert_se(data.n_other == 1);
+
+        for (size_t i = 0; i < ELEMENTSOF(names); i++)
+                if (!IN_SET(i, 0, 3, 17))
+                        assert_se(data.f[i] == 0);
+
+        /* Without the catch-all entry unknown fields are refused */
+        table[ELEMENTSOF(names) + 1] = (JsonDispatch) {};
+        assert_se(json_dispatch(v, table, NULL, 0, &data) == -EADDRNOTAVAIL);
+}
+
+static void test_many_scalars(void) {
+        _cleanup_(json_variant_unrefp) JsonVariant *v = NULL, *w = NULL;
+        _cleanup_free_ JsonVariant **a = NULL;
+        _cleanup_free_ char *s = NULL;
+        size_t n = 10000;
+
+        log_info("/* %s */", __func__);
+
+        /* Stand-alone numbers and short strings come from a pool, make sure they survive being copied into
+         * and released from arrays, also when they are sensitive */
+        assert_se(a = new0(JsonVariant*, n));
+        for (size_t i = 0; i < n; i++) {
+                char buf[DECIMAL_STR_MAX(size_t)];
+
+                if (i % 3 == 0)
+                        assert_se(json_variant_new_unsigned(a + i, i) >= 0);
+                else if (i % 3 == 1)
+                        assert_se(json_variant_new_integer(a + i, -(intmax_t) i) >= 0);
+                else {
+                        xsprintf(buf, "%zu", i);
+                        assert_se(json_variant_new_string(a + i, buf) >= 0);
+                }
+
+                if (i % 7 == 0)
+                        json_variant_sensitive(a[i]);
+        }
+
+        assert_se(json_variant_new_array(&v, a, n) >= 0);
+        json_variant_unref_many(a, n);
+
+        assert_se(json_variant_elements(v) == n);
+        assert_se(json_variant_unsigned(json_variant_by_index(v, 9999)) == 9999);
+        assert_se(streq(json_variant_string(json_variant_by_index(v, 5)), "5"));
+
+        assert_se(json_variant_format(v, 0, &s) >= 0);
+        assert_se(json_parse(s, 0, &w, NULL, NULL) >= 0);
+        assert_se(json_variant_equal(v, w));
+}
+
 int main(int argc, char *argv[]) {
         test_setup_logging(LOG_DEBUG);
 
@@ -573,6 +663,8 @@ int main(int argc, char *argv[]) {
 
         test_normalize();
         test_bisect();
+        test_dispatch_large();
+        test_many_scalars();
 
         return 0;
 }
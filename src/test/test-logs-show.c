@@ -0,0 +1,178 @@
+/* SPDX-License-Identifier: LGPL-2.1-or-later */
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "sd-journal.h"
+
+#include "alloc-util.h"
+#include "chattr-util.h"
+#include "fd-util.h"
+#include "fileio.h"
+#include "io-util.h"
+#include "journal-file.h"
+#include "json.h"
+#include "logs-show.h"
+#include "output-mode.h"
+#include "path-util.h"
+#include "rm-rf.h"
+#include "string-util.h"
+#include "strv.h"
+#include "tests.h"
+#include "tmpfile-util.h"
+
+static void append_entry(JournalFile *f, dual_timestamp *ts, ...) {
+        _cleanup_free_ struct iovec *iovec = NULL;
+        size_t n = 0;
+        va_list ap;
+
+        va_start(ap, ts);
+        for (;;) {
+                const char *data;
+                size_t size;
+
+                data = va_arg(ap, const char*);
+                if (!data)
+                        break;
+                size = va_arg(ap, size_t);
+
+                assert_se(iovec = reallocarray(iovec, n + 1, sizeof(struct iovec)));
+                iovec[n++] = IOVEC_MAKE((void*) data, size);
+        }
+        va_end(ap);
+
+        ts->monotonic++;
+        ts->realtime++;
+
+        assert_se(journal_file_append_entry(f, ts, NULL, iovec, n, NULL, NULL, NULL) == 0);
+}
+
+#define FIELD(s) s, STRLEN(s)
+
+static char* format_entry(sd_journal *j, OutputMode mode, OutputFlags flags, char **output_fields) {
+        _cleanup_fclose_ FILE *f = NULL;
+        char *buf = NULL;
+        size_t sz = 0;
+
+        sd_journal_restart_data(j);
+
+        assert_se(f = open_memstream_unlocked(&buf, &sz));
+        assert_se(show_journal_entry(f, j, mode, 0, flags, output_fields, NULL, NULL) >= 0);
+        assert_se(fflush_and_check(f) >= 0);
+        f = safe_fclose(f);
+
+        return buf;
+}
+
+static void test_json_entry(sd_journal *j, OutputMode mode, OutputFlags flags, char **output_fields) {
+        _cleanup_(json_variant_unrefp) JsonVariant *v = NULL, *w = NULL;
+        _cleanup_free_ char *direct = NULL, *pretty = NULL;
+        const char *prefix, *suffix;
+        size_t l;
+        char *e;
+
+        /* The compact JSON modes are formatted directly, json-pretty still takes the JsonVariant path. The
+         * order of the fields differs between the two, since the latter collects them in a Hashmap, hence
+         * check the framing of the direct output, and compare the parsed objects. */
+
+        assert_se(direct = format_entry(j, mode, flags, output_fields));
+        assert_se(pretty = format_entry(j, OUTPUT_JSON_PRETTY, flags, output_fields));
+
+        log_debug("%s: %s", output_mode_to_string(mode), direct);
+
+        prefix = mode == OUTPUT_JSON_SSE ? "data: " :
+                 mode == OUTPUT_JSON_SEQ ? "\x1e" : "";
+        suffix = mode == OUTPUT_JSON_SSE ? "\n\n" : "\n";
+
+        e = startswith(direct, prefix);
+        assert_se(e);
+        assert_se(endswith(e, suffix));
+        l = strlen(e) - strlen(suffix);
+        e[l] = 0;
+
+        /* A single line of compact JSON */
+        assert_se(!strchr(e, '\n'));
+        assert_se(memchr(e, 0, l) == NULL);
+
+        assert_se(json_parse(e, 0, &v, NULL, NULL) >= 0);
+        assert_se(json_parse(pretty, 0, &w, NULL, NULL) >= 0);
+
+        assert_se(json_variant_equal(v, w));
+}
+
+static void test_json_direct(void) {
+        _cleanup_(rm_rf_physical_and_freep) char *t = NULL;
+        _cleanup_(sd_journal_closep) sd_journal *j = NULL;
+        _cleanup_free_ char *huge = NULL, *fn = NULL;
+        char **output_fields = STRV_MAKE("MESSAGE", "MULTI", "HUGE");
+        static const char binary[] = "BINARY=\x01\xff\x00z";
+        dual_timestamp ts;
+        JournalFile *f;
+        unsigned n = 0;
+
+        log_info("/* %s */", __func__);
+
+        assert_se(mkdtemp_malloc("/var/tmp/test-logs-show-XXXXXX", &t) >= 0);
+        (void) chattr_path(t, FS_NOCOW_FL, FS_NOCOW_FL, NULL);
+        assert_se(fn = path_join(t, "test.journal"));
+
+        assert_se(journal_file_open(-1, fn, O_RDWR|O_CREAT, 0644, true, UINT64_MAX, false, NULL, NULL, NULL, NULL, &f) == 0);
+
+        assert_se(huge = malloc(STRLEN("HUGE=") + 5000 + 1));
+        memset(stpcpy(huge, "HUGE="), 'x', 5000);
+        huge[STRLEN("HUGE=") + 5000] = 0;
+
+        dual_timestamp_get(&ts);
+
+        append_entry(f, &ts,
+                     FIELD("MESSAGE=plain"),
+                     NULL);
+        append_entry(f, &ts,
+                     FIELD("MESSAGE=\"quoted\" back\\slash\ttab\nnewline"),
+                     FIELD("CONTROL=\x01\x1f\x7f"),
+                     FIELD("UNICODE=grüße ☺"),
+                     FIELD("EMPTY="),
+                     NULL);
+        append_entry(f, &ts,
+                     FIELD("MESSAGE=binary"),
+                     binary, sizeof(binary) - 1,
+                     FIELD("INVALID_UTF8=\xc3\x28"),
+                     NULL);
+        append_entry(f, &ts,
+                     FIELD("MESSAGE=multi"),
+                     FIELD("MULTI=one"),
+                     FIELD("OTHER=x"),
+                     FIELD("MULTI=two"),
+                     FIELD("MULTI=three"),
+                     NULL);
+        append_entry(f, &ts,
+                     FIELD("MESSAGE=huge"),
+                     huge, strlen(huge),
+                     NULL);
+
+        (void) journal_file_close(f);
+
+        assert_se(sd_journal_open_files(&j, (const char**) STRV_MAKE(fn), 0) >= 0);
+
+        SD_JOURNAL_FOREACH(j) {
+                static const OutputMode modes[] = { OUTPUT_JSON, OUTPUT_JSON_SSE, OUTPUT_JSON_SEQ };
+
+                for (size_t i = 0; i < ELEMENTSOF(modes); i++) {
+                        test_json_entry(j, modes[i], 0, NULL);
+                        test_json_entry(j, modes[i], OUTPUT_SHOW_ALL, NULL);
+                        test_json_entry(j, modes[i], 0, output_fields);
+                }
+
+                n++;
+        }
+
+        assert_se(n == 5);
+}
+
+int main(int argc, char *argv[]) {
+        test_setup_logging(LOG_DEBUG);
+
+        test_json_direct();
+
+        return 0;
+}
@@ -0,0 +1,90 @@
+/* SPDX-License-Identifier: LGPL-2.1-or-later */
+
+#include <stdint.h>
+
+#include "macro.h"
+#include "mempool.h"
+#include "tests.h"
+
+#define N_TILES 1000
+
+typedef struct Tile {
+        uint64_t data[8];
+} Tile;
+
+static void tile_fill(Tile *t, uint64_t v) {
+        for (size_t i = 0; i < ELEMENTSOF(t->data); i++)
+                t->data[i] = v;
+}
+
+static bool tile_check(const Tile *t, uint64_t v) {
+        for (size_t i = 0; i < ELEMENTSOF(t->data); i++)
+                if (t->data[i] != v)
+                        return false;
+
+        return true;
+}
+
+static void test_mempool_trim(void) {
+        DEFINE_MEMPOOL(mp, Tile, 16);
+        Tile *tiles[N_TILES];
+        size_t first_pool_size, trimmed;
+
+        log_info("/* %s */", __func__);
+
+        /* Determine how much the first pool holds, by allocating a single tile */
+        assert_se(tiles[0] = mempool_alloc_tile(&mp));
+        mempool_free_tile(&mp, tiles[0]);
+        first_pool_size = mempool_trim(&mp);
+        assert_se(first_pool_size >= 16 * sizeof(Tile));
+        assert_se(first_pool_size % sizeof(Tile) == 0);
+        assert_se(!mp.first_pool);
+        assert_se(!mp.freelist);
+
+        for (size_t i = 0; i < N_TILES; i++) {
+                assert_se(tiles[i] = mempool_alloc_tile(&mp));
+                tile_fill(tiles[i], i);
+        }
+
+        /* Nothing returned yet */
+        assert_se(mempool_trim(&mp) == 0);
+
+        /* Every pool still has tiles in use */
+        for (size_t i = 1; i < N_TILES; i += 2)
+                mempool_free_tile(&mp, tiles[i]);
+        assert_se(mempool_trim(&mp) == 0);
+
+        /* Only the very first tile is still in use, which lives in the oldest pool. All others go away. */
+        for (size_t i = 2; i < N_TILES; i += 2)
+                mempool_free_tile(&mp, tiles[i]);
+        trimmed = mempool_trim(&mp);
+        assert_se(trimmed >= N_TILES * sizeof(Tile) - first_pool_size);
+        assert_se(trimmed % sizeof(Tile) == 0);
+        assert_se(mp.first_pool);
+        assert_se(mempool_trim(&mp) == 0);
+
+        assert_se(tile_check(tiles[0], 0));
+
+        /* Reallocate, and make sure all tiles are backed by memory of their own */
+        for (size_t i = 1; i < N_TILES; i++) {
+                assert_se(tiles[i] = mempool_alloc_tile(&mp));
+                tile_fill(tiles[i], i);
+        }
+        for (size_t i = 0; i < N_TILES; i++)
+                assert_se(tile_check(tiles[i], i));
+
+        /* Return everything, which releases all pools, including the first one */
+        for (size_t i = 0; i < N_TILES; i++)
+                mempool_free_tile(&mp, tiles[i]);
+        assert_se(mempool_trim(&mp) >= N_TILES * sizeof(Tile));
+        assert_se(!mp.first_pool);
+        assert_se(!mp.freelist);
+}
+
+int main(int argc, char *argv[]) {
+        test_setup_logging(LOG_DEBUG);
+
+        test_mempool_trim();
+
+        return 0;
+}
@@ -7,6 +7,8 @@
 #include "set.h"
 #include "siphash24.h"
 #include "sort-util.h"
+#include "tests.h"
+#include "time-util.h"
 
 #define SET_SIZE 1024*4
 
@@ -119,10 +121,65 @@ static void test_struct(void) {
         assert_se(set_isempty(s));
 }
 
+static void test_reshuffle(void) {
+        _cleanup_(prioq_freep) Prioq *q = NULL;
+        _cleanup_free_ struct test *items = NULL;
+        bool slow = slow_tests_enabled();
+        unsigned n_items = slow ? 1U << 16 : 1024, n_iterations = slow ? 1U << 22 : 1U << 14, previous = 0;
+        char b[FORMAT_TIMESPAN_MAX];
+        struct test *t;
+        usec_t ts;
+
+        log_info("/* %s (%s) */", __func__, slow ? "slow" : "fast");
+
+        srand(0);
+
+        /* Mimic what sd-event does with its timer queues: the earliest item is dispatched and then
+         * rescheduled into the future, and random other items are moved around in between. */
+
+        assert_se(q = prioq_new((compare_func_t) test_compare));
+        assert_se(items = new(struct test, n_items));
+
+        ts = now(CLOCK_MONOTONIC);
+
+        for (unsigned i = 0; i < n_items; i++) {
+                items[i] = (struct test) {
+                        .value = (unsigned) rand() % n_items,
+                        .idx = PRIOQ_IDX_NULL,
+                };
+
+                assert_se(prioq_put(q, items + i, &items[i].idx) >= 0);
+        }
+
+        for (unsigned i = 0; i < n_iterations; i++) {
+                if (i % 2 == 0) {
+                        assert_se(t = prioq_peek(q));
+                        t->value += (unsigned) rand() % n_items;
+                } else {
+                        t = items + (unsigned) rand() % n_items;
+                        t->value = t->value/2 + (unsigned) rand() % n_items;
+                }
+
+                assert_se(prioq_reshuffle(q, t, &t->idx) == 1);
+        }
+
+        for (unsigned i = 0; i < n_items; i++) {
+                assert_se(t = prioq_pop(q));
+                assert_se(previous <= t->value);
+                previous = t->value;
+        }
+
+        assert_se(prioq_isempty(q));
+
+        log_info("%u items, %u reshuffles took %s",
+                 n_items, n_iterations, format_timespan(b, sizeof b, now(CLOCK_MONOTONIC) - ts, 0));
+}
+
 int main(int argc, char* argv[]) {
 
         test_unsigned();
         test_struct();
+        test_reshuffle();
 
         return 0;
 }
@@ -16,6 +16,13 @@ static void test_utf8_is_printable(void) {
         assert_se(!utf8_is_printable("\r", 1));
         assert_se(utf8_is_printable("\n", 1));
         assert_se(utf8_is_printable("\t", 1));
+        assert_se(!utf8_is_printable("\177", 1));
+        assert_se(!utf8_is_printable("\302\205", 2));
+        assert_se(!utf8_is_printable("ascii\0nul", 9));
+        assert_se(utf8_is_printable("mixed ąę \342\204\242 ascii", 20));
+        assert_se(!utf8_is_printable("mixed ąę\033", 11));
+        assert_se(!utf8_is_printable_newline("two\nlines", 9, false));
+        assert_se(utf8_is_printable_newline("two\nlines", 9, true));
 }
 
 static void test_utf8_n_is_valid(void) {
@@ -140,6 +140,46 @@ static void flood_test(const char *address) {
                 connections[k] = varlink_unref(connections[k]);
 }
 
+#define PIPELINE_CALLS 16
+
+static int pipeline_reply(Varlink *link, JsonVariant *parameters, const char *error_id, VarlinkReplyFlags flags, void *userdata) {
+        int *n = userdata;
+
+        /* Replies to pipelined calls arrive in the order the calls were enqueued in */
+        assert_se(!error_id);
+        assert_se(json_variant_integer(json_variant_by_key(parameters, "sum")) == *n + 1);
+
+        if (++(*n) == PIPELINE_CALLS)
+                sd_event_exit(varlink_get_event(link), 0);
+
+        return 0;
+}
+
+static void pipeline_test(const char *address) {
+        _cleanup_(varlink_flush_close_unrefp) Varlink *c = NULL;
+        _cleanup_(sd_event_unrefp) sd_event *e = NULL;
+        int n = 0;
+
+        log_debug("Pipelining calls...");
+
+        assert_se(sd_event_new(&e) >= 0);
+
+        assert_se(varlink_connect_address(&c, address) >= 0);
+        assert_se(varlink_set_description(c, "pipeline-client") >= 0);
+        assert_se(varlink_set_userdata(c, &n) == NULL);
+        assert_se(varlink_bind_reply(c, pipeline_reply) >= 0);
+
+        /* Enqueue all calls at once, without waiting for the replies in between */
+        for (int i = 0; i < PIPELINE_CALLS; i++)
+                assert_se(varlink_invokeb(c, "io.test.DoSomething",
+                                          JSON_BUILD_OBJECT(JSON_BUILD_PAIR("a", JSON_BUILD_INTEGER(i)),
+                                                            JSON_BUILD_PAIR("b", JSON_BUILD_INTEGER(1)))) >= 0);
+
+        assert_se(varlink_attach_event(c, e, 0) >= 0);
+        assert_se(sd_event_loop(e) >= 0);
+        assert_se(n == PIPELINE_CALLS);
+}
+
 static void *thread(void *arg) {
         _cleanup_(varlink_flush_close_unrefp) Varlink *c = NULL;
         _cleanup_(json_variant_unrefp) JsonVariant *i = NULL;
@@ -160,6 +200,7 @@ static void *thread(void *arg) {
         assert_se(streq_ptr(json_variant_string(json_variant_by_key(o, "method")), "io.test.IDontExist"));
         assert_se(streq(e, VARLINK_ERROR_METHOD_NOT_FOUND));
 
+        pipeline_test(arg);
         flood_test(arg);
 
         assert_se(varlink_send(c, "io.test.Done", NULL) >= 0);
@@ -374,19 +374,69 @@ static bool takes_ownership(ItemType t) {
                       RECURSIVE_REMOVE_PATH);
 }
 
-static struct Item* find_glob(OrderedHashmap *h, const char *match) {
+static bool glob_may_match_child(const char *pattern, const char *dir) {
+        const char *e;
+        char *parent;
+
+        /* Returns false if the specified glob cannot match any direct child of 'dir'. With FNM_PATHNAME
+         * a '/' in the pattern only matches a literal '/', hence everything up to the last slash of the
+         * pattern must match the directory. Escaped slashes and bracket expressions make splitting the
+         * pattern ambiguous, hence don't try to be smart about those. */
+
+        if (strpbrk(pattern, "\\["))
+                return true;
+
+        e = strrchr(pattern, '/');
+        if (!e)
+                return true;
+
+        if (e == pattern)
+                return isempty(dir);
+
+        parent = strndupa(pattern, e - pattern);
+        return fnmatch(parent, dir, FNM_PATHNAME|FNM_PERIOD) == 0;
+}
+
+static int find_glob_candidates(OrderedHashmap *h, const char *dir, Item ***ret, size_t *ret_n) {
+        _cleanup_free_ Item **candidates = NULL;
+        size_t n = 0, allocated = 0, dir_len;
+        const char *stripped;
         ItemArray *j;
 
-        ORDERED_HASHMAP_FOREACH(j, h) {
-                size_t n;
+        assert(dir);
+        assert(ret);
+        assert(ret_n);
+
+        /* Collect the globs that might match entries of 'dir', so that dir_cleanup() doesn't have to
+         * try every single glob on every single file it looks at. */
+
+        dir_len = strlen(dir);
+        while (dir_len > 0 && dir[dir_len - 1] == '/')
+                dir_len--;
+        stripped = strndupa(dir, dir_len);
+
+        ORDERED_HASHMAP_FOREACH(j, h)
+                for (size_t k = 0; k < j->n_items; k++) {
+                        Item *item = j->items + k;
 
-                for (n = 0; n < j->n_items; n++) {
-                        Item *item = j->items + n;
+                        if (!glob_may_match_child(item->path, stripped))
+                                continue;
+
+                        if (!GREEDY_REALLOC(candidates, allocated, n + 1))
+                                return -ENOMEM;
 
-                        if (fnmatch(item->path, match, FNM_PATHNAME|FNM_PERIOD) == 0)
-                                return item;
+                        candidates[n++] = item;
                 }
-        }
+
+        *ret = TAKE_PTR(candidates);
+        *ret_n = n;
+        return 0;
+}
+
+static Item* find_glob(Item **candidates, size_t n_candidates, const char *match) {
+        for (size_t k = 0; k < n_candidates; k++)
+                if (fnmatch(candidates[k]->path, match, FNM_PATHNAME|FNM_PERIOD) == 0)
+                        return candidates[k];
 
         return NULL;
 }
@@ -517,10 +567,15 @@ static int dir_cleanup(
                 int maxdepth,
                 bool keep_this_level) {
 
+        _cleanup_free_ Item **glob_candidates = NULL;
+        size_t n_glob_candidates = 0;
         bool deleted = false;
         struct dirent *dent;
         int r = 0;
 
+        if (find_glob_candidates(globs, p, &glob_candidates, &n_glob_candidates) < 0)
+                return log_oom();
+
         FOREACH_DIRENT_ALL(dent, d, break) {
                 _cleanup_free_ char *sub_path = NULL;
                 nsec_t atime_nsec, mtime_nsec, ctime_nsec, btime_nsec;
@@ -528,6 +583,24 @@ static int dir_cleanup(
                 if (dot_or_dot_dot(dent->d_name))
                         continue;
 
+                sub_path = path_join(p, dent->d_name);
+                if (!sub_path) {
+                        r = log_oom();
+                        goto finish;
+                }
+
+                /* Is there an item configured for this path? Check this first, it only needs the name and
+                 * saves us the statx() call for everything that is excluded anyway. */
+                if (ordered_hashmap_get(items, sub_path)) {
+                        log_debug("Ignoring \"%s\": a separate entry exists.", sub_path);
+                        continue;
+                }
+
+                if (find_glob(glob_candidates, n_glob_candidates, sub_path)) {
+                        log_debug("Ignoring \"%s\": a separate glob exists.", sub_path);
+                        continue;
+                }
+
                 /* If statx() is supported, use it. It's preferable over fstatat() since it tells us
                  * explicitly where we are looking at a mount point, for free as side information. Determining
                  * the same information without statx() is hard, see the complexity of path_is_mount_point(),
@@ -591,23 +664,6 @@ static int dir_cleanup(
                 ctime_nsec = FLAGS_SET(sx.stx_mask, STATX_CTIME) ? load_statx_timestamp_nsec(&sx.stx_ctime) : 0;
                 btime_nsec = FLAGS_SET(sx.stx_mask, STATX_BTIME) ? load_statx_timestamp_nsec(&sx.stx_btime) : 0;
 
-                sub_path = path_join(p, dent->d_name);
-                if (!sub_path) {
-                        r = log_oom();
-                        goto finish;
-                }
-
-                /* Is there an item configured for this path? */
-                if (ordered_hashmap_get(items, sub_path)) {
-                        log_debug("Ignoring \"%s\": a separate entry exists.", sub_path);
-                        continue;
-                }
-
-                if (find_glob(globs, sub_path)) {
-                        log_debug("Ignoring \"%s\": a separate glob exists.", sub_path);
-                        continue;
-                }
-
                 if (S_ISDIR(sx.stx_mode)) {
                         _cleanup_closedir_ DIR *sub_dir = NULL;
 
@@ -16,6 +16,7 @@
 #include "format-util.h"
 #include "fs-util.h"
 #include "mkdir.h"
+#include "parse-util.h"
 #include "path-util.h"
 #include "selinux-util.h"
 #include "smack-util.h"
@@ -147,6 +148,7 @@ static int link_find_prioritized(sd_device *dev, bool add, const char *stackdir,
 
         FOREACH_DIRENT_ALL(dent, dir, break) {
                 _cleanup_(sd_device_unrefp) sd_device *dev_db = NULL;
+                _cleanup_free_ char *data = NULL;
                 const char *devnode, *id_filename;
                 int db_prio = 0;
 
@@ -164,19 +166,42 @@ static int link_find_prioritized(sd_device *dev, bool add, const char *stackdir,
                 if (streq(dent->d_name, id_filename))
                         continue;
 
-                if (sd_device_new_from_device_id(&dev_db, dent->d_name) < 0)
-                        continue;
+                /* Entries are normally symlinks to "<priority>:<devnode>", see link_update(), which saves us
+                 * from loading the device and its database entry. Entries written by older versions are
+                 * regular files, for those look up the data from the device. */
+                r = readlinkat_malloc(dirfd(dir), dent->d_name, &data);
+                if (r >= 0) {
+                        char *colon;
 
-                if (sd_device_get_devname(dev_db, &devnode) < 0)
-                        continue;
+                        colon = strchr(data, ':');
+                        if (!colon)
+                                continue;
+                        *colon = '\0';
 
-                if (device_get_devlink_priority(dev_db, &db_prio) < 0)
-                        continue;
+                        if (safe_atoi(data, &db_prio) < 0)
+                                continue;
+
+                        devnode = colon + 1;
+                        if (!path_startswith(devnode, "/dev"))
+                                continue;
+                } else {
+                        if (r != -EINVAL)
+                                continue;
+
+                        if (sd_device_new_from_device_id(&dev_db, dent->d_name) < 0)
+                                continue;
+
+                        if (sd_device_get_devname(dev_db, &devnode) < 0)
+                                continue;
+
+                        if (device_get_devlink_priority(dev_db, &db_prio) < 0)
+                                continue;
+                }
 
                 if (target && db_prio <= priority)
                         continue;
 
-                log_device_debug(dev_db, "Device claims priority %i for '%s'", db_prio, stackdir);
+                log_device_debug(dev, "Device '%s' claims priority %i for '%s'", dent->d_name, db_prio, stackdir);
 
                 r = free_and_strdup(&target, devnode);
                 if (r < 0)
@@ -250,20 +275,36 @@ static int link_update(sd_device *dev, const char *slink, bool add) {
         if (!add) {
                 if (unlink(filename) == 0)
                         (void) rmdir(dirname);
-        } else
-                for (;;) {
-                        _cleanup_close_ int fd = -1;
+        } else {
+                _cleanup_free_ char *data = NULL;
+                const char *devnode;
+                int priority;
+
+                /* Store our priority and device node in the entry itself, so that link_find_prioritized()
+                 * doesn't need to load each claiming device to find the one with the highest priority. */
+                r = device_get_devlink_priority(dev, &priority);
+                if (r < 0)
+                        return log_device_debug_errno(dev, r, "Failed to get devlink priority: %m");
+
+                r = sd_device_get_devname(dev, &devnode);
+                if (r < 0)
+                        return log_device_debug_errno(dev, r, "Failed to get device node: %m");
+
+                if (asprintf(&data, "%i:%s", priority, devnode) < 0)
+                        return log_oom();
 
+                for (;;) {
                         r = mkdir_parents(filename, 0755);
                         if (!IN_SET(r, 0, -ENOENT))
                                 return r;
 
-                        fd = open(filename, O_WRONLY|O_CREAT|O_CLOEXEC|O_TRUNC|O_NOFOLLOW, 0444);
-                        if (fd >= 0)
+                        r = symlink_atomic(data, filename);
+                        if (r >= 0)
                                 break;
-                        if (errno != ENOENT)
-                                return -errno;
+                        if (r != -ENOENT)
+                                return r;
                 }
+        }
 
         /* If the database entry is not written yet we will just do one iteration and possibly wrong symlink
          * will be fixed in the second invocation. */
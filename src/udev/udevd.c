@@ -121,6 +121,14 @@ struct event {
         uint64_t seqnum;
         uint64_t delaying_seqnum;
 
+        /* Cached properties of dev, used when checking dependencies between events */
+        const char *devpath;
+        size_t devpath_len;
+        const char *devpath_old;
+        dev_t devnum;
+        int ifindex;
+        bool is_block;
+
         sd_event_source *timeout_warning_event;
         sd_event_source *timeout_event;
 
@@ -629,7 +637,7 @@ static int worker_spawn(Manager *manager, struct event *event) {
         return 0;
 }
 
-static void event_run(Manager *manager, struct event *event) {
+static int event_run(Manager *manager, struct event *event) {
         static bool log_children_max_reached = true;
         struct worker *worker;
         int r;
@@ -652,7 +660,7 @@ static void event_run(Manager *manager, struct event *event) {
                         continue;
                 }
                 worker_attach_event(worker, event);
-                return;
+                return 1; /* event is now processing. */
         }
 
         if (hashmap_size(manager->workers) >= arg_children_max) {
@@ -663,7 +671,7 @@ static void event_run(Manager *manager, struct event *event) {
                         log_debug("Maximum number (%u) of children reached.", hashmap_size(manager->workers));
                         log_children_max_reached = false;
                 }
-                return;
+                return 0; /* no free worker */
         }
 
         /* Re-enable the debug message for the next batch of events */
@@ -674,14 +682,20 @@ static void event_run(Manager *manager, struct event *event) {
         mac_selinux_maybe_reload();
 
         /* start new worker and pass initial device */
-        worker_spawn(manager, event);
+        r = worker_spawn(manager, event);
+        if (r < 0)
+                return r;
+
+        return 1; /* event is now processing. */
 }
 
 static int event_queue_insert(Manager *manager, sd_device *dev) {
         _cleanup_(sd_device_unrefp) sd_device *clone = NULL;
+        const char *subsystem, *devpath, *devpath_old = NULL;
+        dev_t devnum = makedev(0, 0);
         struct event *event;
         uint64_t seqnum;
-        int r;
+        int r, ifindex = 0;
 
         assert(manager);
         assert(dev);
@@ -694,6 +708,28 @@ static int event_queue_insert(Manager *manager, sd_device *dev) {
         if (r < 0)
                 return r;
 
+        /* Look up everything is_device_busy() needs now, rather than once for each queued event every time
+         * the queue is processed. */
+        r = sd_device_get_subsystem(dev, &subsystem);
+        if (r < 0)
+                return r;
+
+        r = sd_device_get_devpath(dev, &devpath);
+        if (r < 0)
+                return r;
+
+        r = sd_device_get_property_value(dev, "DEVPATH_OLD", &devpath_old);
+        if (r < 0 && r != -ENOENT)
+                return r;
+
+        r = sd_device_get_devnum(dev, &devnum);
+        if (r < 0 && r != -ENOENT)
+                return r;
+
+        r = sd_device_get_ifindex(dev, &ifindex);
+        if (r < 0 && r != -ENOENT)
+                return r;
+
         /* Save original device to restore the state on failures. */
         r = device_shallow_clone(dev, &clone);
         if (r < 0)
@@ -712,6 +748,12 @@ static int event_queue_insert(Manager *manager, sd_device *dev) {
                 .dev = sd_device_ref(dev),
                 .dev_kernel = TAKE_PTR(clone),
                 .seqnum = seqnum,
+                .devpath = devpath,
+                .devpath_len = strlen(devpath),
+                .devpath_old = devpath_old,
+                .devnum = devnum,
+                .ifindex = ifindex,
+                .is_block = streq(subsystem, "block"),
                 .state = EVENT_QUEUED,
         };
 
@@ -743,42 +785,12 @@ static void manager_kill_workers(Manager *manager) {
 }
 
 /* lookup event for identical, parent, child device */
-static int is_device_busy(Manager *manager, struct event *event) {
-        const char *subsystem, *devpath, *devpath_old = NULL;
-        dev_t devnum = makedev(0, 0);
+static bool is_device_busy(Manager *manager, struct event *event) {
         struct event *loop_event;
-        size_t devpath_len;
-        int r, ifindex = 0;
-        bool is_block;
-
-        r = sd_device_get_subsystem(event->dev, &subsystem);
-        if (r < 0)
-                return r;
-
-        is_block = streq(subsystem, "block");
-
-        r = sd_device_get_devpath(event->dev, &devpath);
-        if (r < 0)
-                return r;
-
-        devpath_len = strlen(devpath);
-
-        r = sd_device_get_property_value(event->dev, "DEVPATH_OLD", &devpath_old);
-        if (r < 0 && r != -ENOENT)
-                return r;
-
-        r = sd_device_get_devnum(event->dev, &devnum);
-        if (r < 0 && r != -ENOENT)
-                return r;
-
-        r = sd_device_get_ifindex(event->dev, &ifindex);
-        if (r < 0 && r != -ENOENT)
-                return r;
 
         /* check if queue contains events we depend on */
         LIST_FOREACH(event, loop_event, manager->events) {
-                size_t loop_devpath_len, common;
-                const char *loop_devpath;
+                size_t common;
 
                 /* we already found a later event, earlier cannot block us, no need to check again */
                 if (loop_event->seqnum < event->delaying_seqnum)
@@ -793,53 +805,36 @@ static int is_device_busy(Manager *manager, struct event *event) {
                         break;
 
                 /* check major/minor */
-                if (major(devnum) != 0) {
-                        const char *s;
-                        dev_t d;
-
-                        if (sd_device_get_subsystem(loop_event->dev, &s) < 0)
-                                continue;
-
-                        if (sd_device_get_devnum(loop_event->dev, &d) >= 0 &&
-                            devnum == d && is_block == streq(s, "block"))
-                                goto set_delaying_seqnum;
-                }
+                if (major(event->devnum) != 0 &&
+                    event->devnum == loop_event->devnum &&
+                    event->is_block == loop_event->is_block)
+                        goto set_delaying_seqnum;
 
                 /* check network device ifindex */
-                if (ifindex > 0) {
-                        int i;
-
-                        if (sd_device_get_ifindex(loop_event->dev, &i) >= 0 &&
-                            ifindex == i)
-                                goto set_delaying_seqnum;
-                }
-
-                if (sd_device_get_devpath(loop_event->dev, &loop_devpath) < 0)
-                        continue;
+                if (event->ifindex > 0 && event->ifindex == loop_event->ifindex)
+                        goto set_delaying_seqnum;
 
                 /* check our old name */
-                if (devpath_old && streq(devpath_old, loop_devpath))
+                if (event->devpath_old && streq(event->devpath_old, loop_event->devpath))
                         goto set_delaying_seqnum;
 
-                loop_devpath_len = strlen(loop_devpath);
-
                 /* compare devpath */
-                common = MIN(devpath_len, loop_devpath_len);
+                common = MIN(event->devpath_len, loop_event->devpath_len);
 
                 /* one devpath is contained in the other? */
-                if (!strneq(devpath, loop_devpath, common))
+                if (!strneq(event->devpath, loop_event->devpath, common))
                         continue;
 
                 /* identical device event found */
-                if (devpath_len == loop_devpath_len)
+                if (event->devpath_len == loop_event->devpath_len)
                         goto set_delaying_seqnum;
 
                 /* parent device event found */
-                if (devpath[common] == '/')
+                if (event->devpath[common] == '/')
                         goto set_delaying_seqnum;
 
                 /* child device event found */
-                if (loop_devpath[common] == '/')
+                if (loop_event->devpath[common] == '/')
                         goto set_delaying_seqnum;
         }
 
@@ -945,10 +940,15 @@ static void event_queue_start(Manager *manager) {
                         continue;
 
                 /* do not start event if parent or child event is still running */
-                if (is_device_busy(manager, event) != 0)
+                if (is_device_busy(manager, event))
                         continue;
 
-                event_run(manager, event);
+                r = event_run(manager, event);
+                if (r <= 0)
+                        /* All workers are busy and we may not fork more, or forking failed. Don't bother
+                         * checking the rest of the queue, which may be long during coldplug, as nothing can be
+                         * started anyway. We'll get here again when a worker becomes idle. */
+                        break;
         }
 }
 